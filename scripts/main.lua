@@ -16,6 +16,20 @@ cheats = {
     }
 }
 
+graphics = {
+    -- request a debug context with debug output, debug groups and object labels; costs driver time every frame
+    debugContext = false,
+    -- ambient occlusion: "off", "low", "medium" and "high" (half resolution with 8, 16 or 32 samples), or "full";
+    -- F9 cycles through them while playing
+    ssao = "full",
+}
+
+profiler = {
+    enabled = false,
+    -- written on exit when the profiler is enabled; open with chrome://tracing
+    trace = "profile.json",
+}
+
 function getLevelInfo()
     return level_infos[10]
 end
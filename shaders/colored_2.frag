@@ -5,10 +5,10 @@ in vec3 v_normal;
 in vec3 v_ssaoNormal;
 
 layout(location=0) out vec4 out_color;
-layout(location=1) out vec3 out_normal;
-layout(location=2) out vec3 out_position;
+layout(location=1) out vec2 out_normal;
 
 #include "lighting.glsl"
+#include "gbuffer.glsl"
 
 float srgbEncode(in float cl)
 {
@@ -53,6 +53,5 @@ void main()
     out_color *= calc_positional_lighting(v_normal, v_vertexPos);
     out_color.a = 1;
 
-    out_normal = v_ssaoNormal;
-    out_position = v_vertexPos;
+    out_normal = encode_normal(normalize(v_ssaoNormal));
 }
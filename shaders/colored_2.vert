@@ -1,6 +1,9 @@
 attribute vec3 a_position;
 attribute vec3 a_normal;
 attribute vec3 a_color;
+#ifdef INSTANCED
+#include "instancing.glsl"
+#endif
 
 uniform mat4 u_modelMatrix;
 uniform mat4 u_modelViewMatrix;
@@ -14,12 +17,17 @@ out vec3 v_ssaoNormal;
 
 void main()
 {
-    vec4 tmp = u_modelViewMatrix * vec4(a_position, 1);
+    mat4 modelMatrix = u_modelMatrix;
+    mat4 modelViewMatrix = u_modelViewMatrix;
+#ifdef INSTANCED
+    apply_instance(modelMatrix, modelViewMatrix);
+#endif
+    vec4 tmp = modelViewMatrix * vec4(a_position, 1);
     gl_Position = u_camProjection * tmp;
     v_color = a_color;
 
-    v_vertexPos = (u_modelMatrix * vec4(a_position, 1)).xyz;
-    v_normal = normalize(mat3(u_modelMatrix) * a_normal);
-    v_ssaoNormal = normalize(mat3(u_modelViewMatrix) * a_normal);
+    v_vertexPos = (modelMatrix * vec4(a_position, 1)).xyz;
+    v_normal = normalize(mat3(modelMatrix) * a_normal);
+    v_ssaoNormal = normalize(mat3(modelViewMatrix) * a_normal);
     v_vertexPos = tmp.xyz;
 }
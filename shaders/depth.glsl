@@ -1,13 +1,29 @@
 uniform sampler2D u_depth;
 
-float depth_at(in sampler2D tex, in vec2 uv)
+// reconstruct the view space position from a depth buffer; the depth of the texel containing uv is fetched
+// unfiltered, as the passes rendering at a lower resolution would otherwise blend depths across edges
+vec3 view_position_at(in sampler2D tex, in vec2 uv, in mat4 inverseProjection)
 {
+    ivec2 size = textureSize(tex, 0);
+    ivec2 texel = clamp(ivec2(uv * vec2(size)), ivec2(0), size - ivec2(1));
     vec4 clipSpaceLocation;
-    clipSpaceLocation.xy = uv * 2 - vec2(1); // normalized device coordinates
-    clipSpaceLocation.z = texture2D(tex, uv).r * 2.0 - 1.0;
+    clipSpaceLocation.xy = (vec2(texel) + vec2(0.5)) / vec2(size) * 2 - vec2(1); // normalized device coordinates
+    clipSpaceLocation.z = texelFetch(tex, texel, 0).r * 2.0 - 1.0;
     clipSpaceLocation.w = 1;
-    vec4 camSpaceLocation = inverse(u_camProjection) * clipSpaceLocation;
-    float d = length(camSpaceLocation.xyz / camSpaceLocation.w);
+    vec4 camSpaceLocation = inverseProjection * clipSpaceLocation;
+    return camSpaceLocation.xyz / camSpaceLocation.w;
+}
+
+vec3 view_position_at(in vec2 uv, in mat4 inverseProjection)
+{
+    return view_position_at(u_depth, uv, inverseProjection);
+}
+
+#ifndef VIEW_POSITION_ONLY
+// distance to the camera, scaled to 0..1 by Z_max; needs u_camProjection and Z_max
+float depth_at(in sampler2D tex, in vec2 uv)
+{
+    float d = length(view_position_at(tex, uv, inverse(u_camProjection)));
     d /= Z_max;
     return clamp(d, 0.0, 1.0);
 }
@@ -16,3 +32,4 @@ float depth_at(in vec2 uv)
 {
     return depth_at(u_depth, uv);
 }
+#endif
@@ -0,0 +1,29 @@
+attribute vec4 a_instanceTransform;
+attribute float a_instanceBrightness;
+
+flat out float v_lightAmbient;
+
+/*
+ * Applies the translation and the rotation around the Y axis of the current instance.
+ * Billboards keep facing the camera, only rotating around their Y axis.
+ */
+void apply_instance(inout mat4 modelMatrix, inout mat4 modelViewMatrix)
+{
+    float c = cos(a_instanceTransform.w);
+    float s = sin(a_instanceTransform.w);
+    mat4 instanceMatrix = mat4(
+        c, 0, -s, 0,
+        0, 1, 0, 0,
+        s, 0, c, 0,
+        a_instanceTransform.xyz, 1
+    );
+
+    modelMatrix = modelMatrix * instanceMatrix;
+    modelViewMatrix = modelViewMatrix * instanceMatrix;
+#ifdef BILLBOARD
+    modelViewMatrix[0].xyz = vec3(1, 0, 0);
+    modelViewMatrix[2].xyz = vec3(0, 0, 1);
+#endif
+
+    v_lightAmbient = a_instanceBrightness;
+}
@@ -1,4 +1,10 @@
+#ifdef INSTANCED
+flat in float v_lightAmbient;
+#define LIGHT_AMBIENT v_lightAmbient
+#else
 uniform float u_lightAmbient;
+#define LIGHT_AMBIENT u_lightAmbient
+#endif
 
 struct Light {
     vec3 position;
@@ -18,11 +24,11 @@ float calc_positional_lighting(in vec3 normal, in vec3 pos, in float n)
 {
     if (lights.length() <= 0 || normal == vec3(0))
     {
-        return u_lightAmbient;
+        return LIGHT_AMBIENT;
     }
 
     normal = normalize(normal);
-    float sum = u_lightAmbient;
+    float sum = LIGHT_AMBIENT;
     for (int i=0; i<lights.length(); ++i)
     {
         vec3 d = pos - lights[i].position;
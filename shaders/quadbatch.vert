@@ -0,0 +1,24 @@
+in vec4 a_rect;
+in vec4 a_uvRect;
+in vec4 a_color;
+
+uniform mat4 u_projection;
+
+out vec2 v_texCoord;
+out vec4 v_color;
+
+const vec2 corners[4] = vec2[4](vec2(0, 0), vec2(1, 0), vec2(0, 1), vec2(1, 1));
+
+// colors are given in sRGB space, like the texels of the atlas, which are decoded when sampled
+vec3 srgbDecode(in vec3 color)
+{
+    return mix(color / 12.92, pow((color + 0.055) / 1.055, vec3(2.4)), step(0.04045, color));
+}
+
+void main()
+{
+    vec2 corner = corners[gl_VertexID];
+    gl_Position = u_projection * vec4(a_rect.xy + corner * a_rect.zw, 0, 1);
+    v_texCoord = mix(a_uvRect.xy, a_uvRect.zw, corner);
+    v_color = vec4(srgbDecode(a_color.rgb), a_color.a);
+}
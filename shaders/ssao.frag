@@ -1,11 +1,16 @@
-uniform sampler2D u_position;
 uniform sampler2D u_normals;
 uniform sampler2D u_texNoise;
 
 uniform vec3 u_samples[64];
+uniform int u_sampleCount;
 uniform mat4 u_camProjection;
+uniform mat4 u_inverseCamProjection;
 
-vec2 screenSize = textureSize(u_position, 0);
+#define VIEW_POSITION_ONLY
+#include "depth.glsl"
+#include "gbuffer.glsl"
+
+vec2 screenSize = textureSize(u_depth, 0);
 
 layout(location=0) out float out_ao;
 
@@ -17,8 +22,8 @@ void main()
     const float bias = 0.025;
 
     // get input for SSAO algorithm
-    vec3 fragPos = texture(u_position, v_texCoord).xyz;
-    vec3 normal = normalize(texture(u_normals, v_texCoord).xyz);
+    vec3 fragPos = view_position_at(v_texCoord, u_inverseCamProjection);
+    vec3 normal = decode_normal(texture(u_normals, v_texCoord).xy);
     // tile noise texture over screen based on screen dimensions divided by noise size
     vec3 randomVec = normalize(texture(u_texNoise, v_texCoord * screenSize/4).xyz);
     // create TBN change-of-basis matrix: from tangent-space to view-space
@@ -27,7 +32,7 @@ void main()
     mat3 TBN = mat3(tangent, bitangent, normal);
     // iterate over the sample kernel and calculate occlusion factor
     float occlusion = 0.0;
-    for (int i = 0; i < u_samples.length(); ++i)
+    for (int i = 0; i < u_sampleCount; ++i)
     {
         // get sample position
         vec3 smp = fragPos + TBN * u_samples[i] * radius;// from tangent to view-space
@@ -38,11 +43,11 @@ void main()
         offset.xyz = offset.xyz * 0.5 + 0.5;// transform to range 0.0 - 1.0
 
         // get sample depth
-        float sampleDepth = texture(u_position, offset.xy).z;// get depth value of kernel sample
+        float sampleDepth = view_position_at(offset.xy, u_inverseCamProjection).z;// get depth value of kernel sample
 
         // range check & accumulate
         float rangeCheck = smoothstep(0.0, 1.0, radius / abs(fragPos.z - sampleDepth));
         occlusion += (sampleDepth >= smp.z + bias ? 1.0 : 0.0) * rangeCheck;
     }
-    out_ao = 1.0 - (occlusion / u_samples.length());
+    out_ao = 1.0 - (occlusion / u_sampleCount);
 }
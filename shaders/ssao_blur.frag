@@ -1,20 +1,32 @@
 uniform sampler2D u_ao;
+uniform mat4 u_inverseCamProjection;
 
 in vec2 v_texCoord;
 
 layout(location=0) out float out_ao;
 
+#define VIEW_POSITION_ONLY
+#include "depth.glsl"
+
 void main()
 {
+    // depth-aware blur, which also upsamples the AO if it was rendered at a lower resolution
+    const float DepthFalloff = 128.0;
+
     vec2 texelSize = 1.0 / vec2(textureSize(u_ao, 0));
+    float centerDepth = view_position_at(v_texCoord, u_inverseCamProjection).z;
     float result = 0.0;
+    float weights = 0.0;
     for (int x = -2; x < 2; ++x)
     {
         for (int y = -2; y < 2; ++y)
         {
-            vec2 offset = vec2(float(x), float(y)) * texelSize;
-            result += texture(u_ao, v_texCoord + offset).r;
+            vec2 uv = v_texCoord + vec2(float(x), float(y)) * texelSize;
+            float sampleDepth = view_position_at(uv, u_inverseCamProjection).z;
+            float weight = exp(-abs(centerDepth - sampleDepth) / DepthFalloff) + 1e-4;
+            result += texture(u_ao, uv).r * weight;
+            weights += weight;
         }
     }
-    out_ao = result / (4.0 * 4.0);
+    out_ao = result / weights;
 }
@@ -2,6 +2,12 @@ attribute vec3 a_position;
 attribute vec3 a_normal;
 attribute vec2 a_texCoord;
 attribute vec3 a_color;
+#ifdef ROOM_BATCH
+attribute vec3 a_roomOffset;
+#endif
+#ifdef INSTANCED
+#include "instancing.glsl"
+#endif
 
 uniform mat4 u_modelMatrix;
 uniform mat4 u_modelViewMatrix;
@@ -18,15 +24,25 @@ out vec3 v_ssaoNormal;
 
 void main()
 {
-    vec4 tmp = u_modelViewMatrix * vec4(a_position, 1);
+#ifdef ROOM_BATCH
+    vec4 position = vec4(a_position + a_roomOffset, 1);
+#else
+    vec4 position = vec4(a_position, 1);
+#endif
+    mat4 modelMatrix = u_modelMatrix;
+    mat4 modelViewMatrix = u_modelViewMatrix;
+#ifdef INSTANCED
+    apply_instance(modelMatrix, modelViewMatrix);
+#endif
+    vec4 tmp = modelViewMatrix * position;
 #ifdef WATER
-    v_vertexPosWorld = vec3(u_modelMatrix * vec4(a_position, 1));
+    v_vertexPosWorld = vec3(modelMatrix * position);
 #endif
     gl_Position = u_camProjection * tmp;
     v_texCoord = a_texCoord;
     v_color = a_color;
 
-    v_normal = normalize(mat3(u_modelMatrix) * a_normal);
-    v_ssaoNormal = normalize(mat3(u_modelViewMatrix) * a_normal);
+    v_normal = normalize(mat3(modelMatrix) * a_normal);
+    v_ssaoNormal = normalize(mat3(modelViewMatrix) * a_normal);
     v_vertexPos = tmp.xyz;
 }
@@ -6,8 +6,10 @@
 #include "stream.h"
 
 #include <AL/alc.h>
+#include <algorithm>
 #include <set>
 #include <thread>
+#include <vector>
 
 namespace audio
 {
@@ -43,13 +45,10 @@ public:
 
     void removeStoppedSources()
     {
-        std::set<std::shared_ptr<SourceHandle>> cleaned;
-        std::copy_if(m_sources.begin(),
-                     m_sources.end(),
-                     std::inserter(cleaned, cleaned.end()),
-                     [](const std::shared_ptr<SourceHandle>& src) { return !src->isStopped(); });
-
-        m_sources = std::move(cleaned);
+        m_sources.erase(std::remove_if(m_sources.begin(),
+                                       m_sources.end(),
+                                       [](const std::shared_ptr<SourceHandle>& src) { return src->isStopped(); }),
+                        m_sources.end());
     }
 
     // ReSharper disable once CppMemberFunctionMayBeConst
@@ -79,7 +78,7 @@ public:
     gsl::not_null<std::shared_ptr<SourceHandle>> createSource()
     {
         const auto r = std::make_shared<SourceHandle>();
-        m_sources.emplace(r);
+        m_sources.emplace_back(r);
         return r;
     }
 
@@ -87,7 +86,7 @@ private:
     ALCdevice* m_device = nullptr;
     ALCcontext* m_context = nullptr;
     std::shared_ptr<FilterHandle> m_underwaterFilter = nullptr;
-    std::set<std::shared_ptr<SourceHandle>> m_sources;
+    std::vector<std::shared_ptr<SourceHandle>> m_sources;
     std::set<std::shared_ptr<Stream>> m_streams;
     std::thread m_streamUpdater;
     bool m_shutdown = false;
@@ -1,9 +1,73 @@
 #include "soundengine.h"
 
+#include "util/helpers.h"
+
 #include <glm/gtx/string_cast.hpp>
 
 namespace audio
 {
+SoundEngine::SoundEngine() = default;
+
+void SoundEngine::updateListenerPosition()
+{
+    if(m_listener != nullptr)
+        m_budget.setListenerPosition(m_listener->getPosition());
+    else
+        m_budget.setListenerPosition(boost::none);
+}
+
+bool SoundEngine::startVoice(Voice& voice)
+{
+    updateListenerPosition();
+
+    boost::optional<Voice> stolen;
+    if(!m_budget.acquire(voice, stolen))
+        return false;
+
+    if(stolen.is_initialized())
+        stolen->source->stop();
+
+    auto src = m_device.createSource();
+    src->setBuffer(m_buffers.at(voice.buffer));
+    src->setPitch(voice.pitch);
+    src->setGain(voice.gain);
+    src->setLooping(voice.looping);
+    if(voice.emitter != nullptr)
+    {
+        src->setPosition(voice.emitter->getPosition());
+    }
+    else if(voice.position.is_initialized())
+    {
+        src->setPosition(*voice.position);
+    }
+    else
+    {
+        src->set(AL_SOURCE_RELATIVE, AL_TRUE);
+        src->set(AL_POSITION, 0, 0, 0);
+        src->set(AL_VELOCITY, 0, 0, 0);
+    }
+
+    src->play();
+
+    voice.source = src.get();
+    m_budget.addVoice(voice);
+    return true;
+}
+
+void SoundEngine::resumeVirtualVoice()
+{
+    const auto loudest = m_budget.findLoudestVirtualVoice();
+    if(!loudest.is_initialized())
+        return;
+
+    // only resume a single voice per update to avoid voices stealing each other back and forth
+    auto voice = m_budget.getVirtualVoices()[*loudest];
+    if(!startVoice(voice))
+        return;
+
+    m_budget.removeVirtualVoice(*loudest);
+}
+
 void SoundEngine::update()
 {
     m_device.update();
@@ -17,114 +81,105 @@ void SoundEngine::update()
         BOOST_LOG_TRIVIAL(warning) << "No listener set";
     }
 
-    for(auto& emitterMap : m_sources)
+    auto& voices = m_budget.getVoices();
+    for(size_t i = 0; i < voices.size();)
     {
-        glm::vec3 pos;
-        if(emitterMap.first != nullptr)
-            pos = emitterMap.first->getPosition();
-
-        for(auto& handleMap : emitterMap.second)
+        auto& voice = voices[i];
+        if(voice.source->isStopped())
         {
-            auto old = std::move(handleMap.second);
-            std::copy_if(old.begin(), old.end(), std::back_inserter(handleMap.second), [](const auto& h) {
-                return !h.expired();
-            });
-
-            if(emitterMap.first == nullptr)
-                continue;
-
-            for(const auto& handle : handleMap.second)
-            {
-                if(const auto locked = handle.lock())
-                {
-                    locked->setPosition(pos);
-                }
-            }
+            if(i != voices.size() - 1)
+                voice = std::move(voices.back());
+            voices.pop_back();
+            continue;
         }
+
+        if(voice.emitter != nullptr)
+            voice.source->setPosition(voice.emitter->getPosition());
+
+        ++i;
     }
+
+    updateListenerPosition();
+    m_budget.updateAudibility();
+    resumeVirtualVoice();
 }
 
 std::vector<gsl::not_null<std::shared_ptr<SourceHandle>>> SoundEngine::getSourcesForBuffer(Emitter* emitter,
                                                                                            size_t buffer) const
 {
-    const auto it1 = m_sources.find(emitter);
-    if(it1 == m_sources.end())
-        return {};
-
-    const auto it2 = it1->second.find(buffer);
-    if(it2 == it1->second.end())
-        return {};
-
     std::vector<gsl::not_null<std::shared_ptr<SourceHandle>>> result;
-    for(const auto& h : it2->second)
-        if(auto locked = h.lock())
-            result.emplace_back(std::move(locked));
+    for(const auto& voice : m_budget.getVoices())
+    {
+        if(voice.emitter == emitter && voice.buffer == buffer)
+            result.emplace_back(voice.source);
+    }
 
     return result;
 }
 
 bool SoundEngine::stopBuffer(size_t bufferId, Emitter* emitter)
 {
-    auto it1 = m_sources.find(emitter);
-    if(it1 == m_sources.end())
-        return false;
+    const auto matches = [bufferId, emitter](const Voice& voice) {
+        return voice.emitter == emitter && voice.buffer == bufferId;
+    };
 
-    const auto it2 = it1->second.find(bufferId);
-    if(it2 == it1->second.end())
-        return false;
+    auto& voices = m_budget.getVoices();
+    auto& virtualVoices = m_budget.getVirtualVoices();
 
     bool any = false;
-    for(const auto& src : it2->second)
+    for(const auto& voice : voices)
     {
-        if(const auto locked = src.lock())
-        {
-            locked->stop();
-            any = true;
-        }
+        if(!matches(voice))
+            continue;
+
+        voice.source->stop();
+        any = true;
     }
 
-    it1->second.erase(it2);
+    voices.erase(std::remove_if(voices.begin(), voices.end(), matches), voices.end());
+    virtualVoices.erase(std::remove_if(virtualVoices.begin(), virtualVoices.end(), matches), virtualVoices.end());
 
     return any;
 }
 
-gsl::not_null<std::shared_ptr<SourceHandle>>
-    SoundEngine::playBuffer(size_t bufferId, ALfloat pitch, ALfloat volume, Emitter* emitter)
+std::shared_ptr<SourceHandle>
+    SoundEngine::playBuffer(size_t bufferId, ALfloat pitch, ALfloat volume, Emitter* emitter, const bool looping)
 {
-    auto src = m_device.createSource();
-    src->setBuffer(m_buffers.at(bufferId));
-    src->setPitch(pitch);
-    src->setGain(volume);
-    if(emitter != nullptr)
+    Voice voice{nullptr, emitter, bufferId, pitch, volume, looping, boost::none, 0};
+    if(looping)
     {
-        src->setPosition(emitter->getPosition());
+        // a new looping voice replaces a virtual one of the same sound
+        auto& virtualVoices = m_budget.getVirtualVoices();
+        virtualVoices.erase(std::remove_if(virtualVoices.begin(),
+                                           virtualVoices.end(),
+                                           [bufferId, emitter](const Voice& v) {
+                                               return v.emitter == emitter && v.buffer == bufferId;
+                                           }),
+                            virtualVoices.end());
     }
-    else
+
+    if(!startVoice(voice))
     {
-        src->set(AL_SOURCE_RELATIVE, AL_TRUE);
-        src->set(AL_POSITION, 0, 0, 0);
-        src->set(AL_VELOCITY, 0, 0, 0);
+        if(looping)
+            m_budget.addVirtualVoice(std::move(voice));
+        return nullptr;
     }
 
-    src->play();
-
-    m_sources[emitter][bufferId].emplace_back(src.get());
-
-    return src;
+    return voice.source;
 }
 
 void SoundEngine::dropEmitter(Emitter* emitter)
 {
-    const auto it = m_sources.find(emitter);
-    if(it == m_sources.end())
-        return;
+    const auto matches = [emitter](const Voice& voice) { return voice.emitter == emitter; };
 
-    for(const auto& bufferMap : it->second)
-        for(const auto& src : bufferMap.second)
-            if(const auto locked = src.lock())
-                locked->stop();
+    auto& voices = m_budget.getVoices();
+    auto& virtualVoices = m_budget.getVirtualVoices();
+    for(const auto& voice : voices)
+        if(matches(voice))
+            voice.source->stop();
 
-    m_sources.erase(it);
+    voices.erase(std::remove_if(voices.begin(), voices.end(), matches), voices.end());
+    virtualVoices.erase(std::remove_if(virtualVoices.begin(), virtualVoices.end(), matches), virtualVoices.end());
 }
 
 SoundEngine::~SoundEngine()
@@ -146,12 +201,18 @@ void SoundEngine::addWav(const gsl::not_null<const uint8_t*>& buffer)
     m_buffers.emplace_back(std::move(buf));
 }
 
-gsl::not_null<std::shared_ptr<SourceHandle>>
-    SoundEngine::playBuffer(size_t bufferId, ALfloat pitch, ALfloat volume, const glm::vec3& pos)
+std::shared_ptr<SourceHandle> SoundEngine::playBuffer(
+    size_t bufferId, ALfloat pitch, ALfloat volume, const glm::vec3& pos, const bool looping)
 {
-    const auto handle = playBuffer(bufferId, pitch, volume, nullptr);
-    handle->setPosition(pos);
-    return handle;
+    Voice voice{nullptr, nullptr, bufferId, pitch, volume, looping, pos, 0};
+    if(!startVoice(voice))
+    {
+        if(looping)
+            m_budget.addVirtualVoice(std::move(voice));
+        return nullptr;
+    }
+
+    return voice.source;
 }
 
 Listener::~Listener()
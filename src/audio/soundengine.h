@@ -4,8 +4,9 @@
 #include "device.h"
 #include "gsl-lite.hpp"
 #include "sourcehandle.h"
+#include "voicebudget.h"
 
-#include <unordered_map>
+#include <boost/optional.hpp>
 #include <unordered_set>
 
 namespace audio
@@ -72,6 +73,14 @@ private:
     mutable SoundEngine* m_engine = nullptr;
 };
 
+/**
+ * @brief Plays buffers on a fixed budget of voices.
+ *
+ * @details
+ * At most #MaxVoices sources play at the same time; the VoiceBudget decides which.  Stolen or rejected looping
+ * sounds are kept as virtual voices without an OpenAL source, and are resumed once they become audible enough
+ * again.
+ */
 class SoundEngine final
 {
     friend class Emitter;
@@ -79,15 +88,25 @@ class SoundEngine final
     friend class Listener;
 
 public:
+    static constexpr size_t MaxVoices = 32;
+
+    SoundEngine();
+
     ~SoundEngine();
 
     void addWav(const gsl::not_null<const uint8_t*>& buffer);
 
-    gsl::not_null<std::shared_ptr<SourceHandle>>
-        playBuffer(size_t bufferId, ALfloat pitch, ALfloat volume, const glm::vec3& pos);
+    /**
+     * @return The playing source, or @c nullptr if the voice budget didn't allow the sound to be played.
+     */
+    std::shared_ptr<SourceHandle>
+        playBuffer(size_t bufferId, ALfloat pitch, ALfloat volume, const glm::vec3& pos, bool looping = false);
 
-    gsl::not_null<std::shared_ptr<SourceHandle>>
-        playBuffer(size_t bufferId, ALfloat pitch, ALfloat volume, Emitter* emitter = nullptr);
+    /**
+     * @return The playing source, or @c nullptr if the voice budget didn't allow the sound to be played.
+     */
+    std::shared_ptr<SourceHandle>
+        playBuffer(size_t bufferId, ALfloat pitch, ALfloat volume, Emitter* emitter = nullptr, bool looping = false);
 
     bool stopBuffer(size_t bufferId, Emitter* emitter);
 
@@ -113,10 +132,26 @@ public:
 
     void dropEmitter(Emitter* emitter);
 
+    size_t getActiveVoiceCount() const noexcept
+    {
+        return m_budget.getVoices().size();
+    }
+
+    size_t getVirtualVoiceCount() const noexcept
+    {
+        return m_budget.getVirtualVoices().size();
+    }
+
 private:
+    void updateListenerPosition();
+
+    bool startVoice(Voice& voice);
+
+    void resumeVirtualVoice();
+
     Device m_device;
     std::vector<std::shared_ptr<BufferHandle>> m_buffers;
-    std::unordered_map<Emitter*, std::unordered_map<size_t, std::vector<std::weak_ptr<SourceHandle>>>> m_sources;
+    VoiceBudget m_budget{MaxVoices};
     const Listener* m_listener = nullptr;
 
     std::unordered_set<Emitter*> m_emitters;
@@ -22,10 +22,12 @@ class SourceHandle final
     }
 
 public:
+    static constexpr ALfloat MaxDistance = 8 * 1024;
+
     explicit SourceHandle()
         : m_handle{createHandle()}
     {
-        set(AL_MAX_DISTANCE, 8 * 1024);
+        set(AL_MAX_DISTANCE, MaxDistance);
     }
 
     explicit SourceHandle(const SourceHandle&) = delete;
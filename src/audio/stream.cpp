@@ -19,9 +19,15 @@ Stream::Stream(Device& device,
     Expects(bufferCount >= 2);
 
     m_buffers.reserve(bufferCount);
+    m_bufferIndices.reserve(bufferCount);
     for(size_t i = 0; i < bufferCount; ++i)
+    {
         m_buffers.emplace_back(std::make_shared<BufferHandle>());
+        m_bufferIndices.emplace(m_buffers.back()->get(), i);
+    }
 
+    // the initial fill happens on the creating thread, so that the source's scratch buffers are allocated here
+    // instead of in the stream updater thread
     init();
 }
 
@@ -45,20 +51,16 @@ void Stream::update()
     {
         const auto bufId = src->unqueueBuffer();
 
-        bool foundBuffer = false;
-        for(const auto& buffer : m_buffers)
+        const auto it = m_bufferIndices.find(bufId);
+        if(it == m_bufferIndices.end())
         {
-            if(bufId == buffer->get())
-            {
-                fillBuffer(*buffer);
-                src->queueBuffer(*buffer);
-                foundBuffer = true;
-                break;
-            }
+            BOOST_LOG_TRIVIAL(warning) << "Got unexpected buffer ID #" << bufId;
+            continue;
         }
 
-        if(!foundBuffer)
-            BOOST_LOG_TRIVIAL(warning) << "Got unexpected buffer ID #" << bufId;
+        auto& buffer = *m_buffers[it->second];
+        fillBuffer(buffer);
+        src->queueBuffer(buffer);
     }
 }
 
@@ -3,6 +3,8 @@
 #include "sourcehandle.h"
 #include "streamsource.h"
 
+#include <unordered_map>
+
 namespace audio
 {
 class Device;
@@ -13,6 +15,8 @@ private:
     std::unique_ptr<AbstractStreamSource> m_stream;
     std::weak_ptr<SourceHandle> m_source;
     std::vector<gsl::not_null<std::shared_ptr<BufferHandle>>> m_buffers{};
+    //! Maps AL buffer names to indices into #m_buffers.
+    std::unordered_map<ALuint, size_t> m_bufferIndices{};
     std::vector<int16_t> m_sampleBuffer;
     bool m_looping = false;
 
@@ -7,6 +7,12 @@
 #include <boost/throw_exception.hpp>
 #include <fstream>
 #include <sndfile.h>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define AUDIO_USE_SSE2
+#    include <emmintrin.h>
+#endif
 
 namespace audio
 {
@@ -43,30 +49,89 @@ inline short clampSample(float v) noexcept
         return static_cast<short>(std::numeric_limits<short>::max() * v);
 }
 
-inline size_t readStereo(
-    short* sampleBuffer, const size_t frameCount, SNDFILE* sndFile, const bool sourceIsMono, const bool looping)
+/**
+ * @brief Converts interleaved float samples to interleaved 16 bit stereo samples.
+ * @param[in] src Mono or stereo input samples.
+ * @param[in] frameCount Number of frames in @a src.
+ * @param[in] sourceIsMono If set, each sample of @a src is duplicated to both output channels.
+ * @param[out] dst Receives @c 2*frameCount samples.
+ */
+inline void toStereo16(const float* src, const size_t frameCount, const bool sourceIsMono, short* dst) noexcept
+{
+    size_t i = 0;
+#ifdef AUDIO_USE_SSE2
+    const auto lo = _mm_set1_ps(-1.0f);
+    const auto hi = _mm_set1_ps(1.0f);
+    const auto scale = _mm_set1_ps(std::numeric_limits<short>::max());
+    const auto convert8 = [&lo, &hi, &scale](const float* in) {
+        const auto a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in), lo), hi), scale);
+        const auto b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + 4), lo), hi), scale);
+        return _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b));
+    };
+
+    if(sourceIsMono)
+    {
+        for(; i + 8 <= frameCount; i += 8)
+        {
+            const auto samples = convert8(src + i);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_unpacklo_epi16(samples, samples));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 8), _mm_unpackhi_epi16(samples, samples));
+        }
+    }
+    else
+    {
+        for(; i + 4 <= frameCount; i += 4)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), convert8(src + 2 * i));
+    }
+#endif
+
+    if(sourceIsMono)
+    {
+        for(; i < frameCount; ++i)
+            dst[2 * i] = dst[2 * i + 1] = clampSample(src[i]);
+    }
+    else
+    {
+        for(; i < frameCount; ++i)
+        {
+            dst[2 * i] = clampSample(src[2 * i]);
+            dst[2 * i + 1] = clampSample(src[2 * i + 1]);
+        }
+    }
+}
+
+/**
+ * @brief Reads @a frameCount stereo frames, restarting at the beginning if @a looping is set.
+ * @param[in,out] readBuffer Scratch buffer for the decoded samples; only grows if it's too small, so a
+ *                           caller reusing it for reads of the same size doesn't allocate after the first read.
+ * @return The number of frames read; if it's less than @a frameCount, the rest of @a sampleBuffer is silence.
+ */
+inline size_t readStereo(short* sampleBuffer,
+                         const size_t frameCount,
+                         SNDFILE* sndFile,
+                         const bool sourceIsMono,
+                         const bool looping,
+                         std::vector<float>& readBuffer)
 {
+    const size_t samplesPerFrame = sourceIsMono ? 1 : 2;
+    if(readBuffer.size() < frameCount * samplesPerFrame)
+        readBuffer.resize(frameCount * samplesPerFrame);
+
     size_t processedFrames = 0;
-    std::vector<float> tmp;
-    const auto samplesPerFrame = sourceIsMono ? 1 : 2;
     while(processedFrames < frameCount)
     {
         const auto requestedFrames = frameCount - processedFrames;
-        const auto requestedSamples = requestedFrames * samplesPerFrame;
-        tmp.resize(requestedSamples);
-        const auto readFrames = sf_readf_float(sndFile, tmp.data(), requestedFrames);
+        const auto readFrames = sf_readf_float(sndFile, readBuffer.data(), requestedFrames);
         if(readFrames > 0)
         {
-            for(size_t i = 0; i < static_cast<size_t>(readFrames * samplesPerFrame); ++i)
-                sampleBuffer[processedFrames * samplesPerFrame + i] = clampSample(tmp[i]);
-
+            toStereo16(readBuffer.data(), readFrames, sourceIsMono, sampleBuffer + processedFrames * 2);
             processedFrames += readFrames;
         }
         else
         {
             if(!looping)
             {
-                std::fill_n(sampleBuffer + processedFrames * samplesPerFrame, requestedSamples, 0);
+                std::fill_n(sampleBuffer + processedFrames * 2, requestedFrames * 2, 0);
                 break;
             }
 
@@ -75,17 +140,6 @@ inline size_t readStereo(
         }
     }
 
-    if(sourceIsMono)
-    {
-        // Need to duplicate the samples from mono to stereo
-        for(size_t i = 0; i < frameCount; ++i)
-        {
-            const size_t src = frameCount - i - 1;
-            const size_t dest = 2 * frameCount - i - 2;
-            sampleBuffer[dest] = sampleBuffer[dest + 1] = sampleBuffer[src];
-        }
-    }
-
     return processedFrames;
 }
 } // namespace sndfile
@@ -97,6 +151,7 @@ private:
     SF_INFO m_sfInfo{};
     SNDFILE* m_sndFile = nullptr;
     std::unique_ptr<sndfile::InputStreamViewWrapper> m_wrapper;
+    std::vector<float> m_readBuffer;
 
     // CDAUDIO.WAD step size defines CDAUDIO's header stride, on which each track
     // info is placed. Also CDAUDIO count specifies static amount of tracks existing
@@ -142,7 +197,7 @@ public:
 
     size_t readStereo(int16_t* frameBuffer, const size_t frameCount, const bool looping) override
     {
-        return sndfile::readStereo(frameBuffer, frameCount, m_sndFile, m_sfInfo.channels == 1, looping);
+        return sndfile::readStereo(frameBuffer, frameCount, m_sndFile, m_sfInfo.channels == 1, looping, m_readBuffer);
     }
 
     int getSampleRate() const override
@@ -156,6 +211,7 @@ class SndfileStreamSource final : public AbstractStreamSource
 private:
     SF_INFO m_sfInfo{};
     SNDFILE* m_sndFile = nullptr;
+    std::vector<float> m_readBuffer;
 
 public:
     explicit SndfileStreamSource(const std::string& filename)
@@ -174,7 +230,7 @@ public:
 
     size_t readStereo(int16_t* frameBuffer, const size_t frameCount, const bool looping) override
     {
-        return sndfile::readStereo(frameBuffer, frameCount, m_sndFile, m_sfInfo.channels == 1, looping);
+        return sndfile::readStereo(frameBuffer, frameCount, m_sndFile, m_sfInfo.channels == 1, looping, m_readBuffer);
     }
 
     int getSampleRate() const override
@@ -0,0 +1,141 @@
+#define BOOST_TEST_MODULE audio_test
+
+#include "voicebudget.h"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+gsl_api void gsl::fail_fast_assert_handler(char const* const /*expression*/,
+                                           char const* const message,
+                                           char const* const /*file*/,
+                                           int /*line*/)
+{
+    throw gsl::fail_fast(message);
+}
+
+using namespace audio;
+
+namespace
+{
+constexpr size_t MaxVoices = 4;
+
+//! A voice without a source, @a distance units away from the origin; listener-relative without a distance.
+Voice makeVoice(const size_t buffer, const boost::optional<float>& distance, const bool looping = false)
+{
+    Voice voice{nullptr, nullptr, buffer, 1.0f, 1.0f, looping, boost::none, 0};
+    if(distance.is_initialized())
+        voice.position = glm::vec3{*distance, 0, 0};
+    return voice;
+}
+
+//! Fills the budget with voices of the given distances, using the index as the buffer id.
+void fill(VoiceBudget& budget, const std::vector<float>& distances, const size_t loopingBuffer)
+{
+    for(size_t i = 0; i < distances.size(); ++i)
+    {
+        auto voice = makeVoice(i, distances[i], i == loopingBuffer);
+        boost::optional<Voice> stolen;
+        BOOST_REQUIRE(budget.acquire(voice, stolen));
+        BOOST_REQUIRE(!stolen.is_initialized());
+        budget.addVoice(voice);
+    }
+}
+
+bool hasBuffer(const std::vector<Voice>& voices, const size_t buffer)
+{
+    return std::any_of(voices.begin(), voices.end(), [buffer](const Voice& voice) { return voice.buffer == buffer; });
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(voice_budget_tests)
+
+BOOST_AUTO_TEST_CASE(test_positioned_voices_are_attenuated)
+{
+    VoiceBudget budget{MaxVoices};
+    budget.setListenerPosition(glm::vec3{0, 0, 0});
+
+    BOOST_CHECK_CLOSE(budget.getAudibility(makeVoice(0, 0.0f)), 1.0f, 0.001f);
+    BOOST_CHECK_CLOSE(budget.getAudibility(makeVoice(0, SourceHandle::MaxDistance / 2)), 0.5f, 0.001f);
+    BOOST_CHECK_EQUAL(budget.getAudibility(makeVoice(0, SourceHandle::MaxDistance * 2)), 0.0f);
+    BOOST_CHECK_EQUAL(budget.getAudibility(makeVoice(0, boost::none)), 1.0f);
+
+    // without a listener, the distance doesn't matter
+    budget.setListenerPosition(boost::none);
+    BOOST_CHECK_EQUAL(budget.getAudibility(makeVoice(0, SourceHandle::MaxDistance / 2)), 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(test_farthest_voice_is_stolen)
+{
+    VoiceBudget budget{MaxVoices};
+    budget.setListenerPosition(glm::vec3{0, 0, 0});
+    fill(budget, {1000, 3000, 2000, 500}, 99);
+
+    auto voice = makeVoice(10, 100);
+    boost::optional<Voice> stolen;
+    BOOST_REQUIRE(budget.acquire(voice, stolen));
+    BOOST_REQUIRE(stolen.is_initialized());
+    BOOST_CHECK_EQUAL(stolen->buffer, 1u);
+    budget.addVoice(voice);
+
+    BOOST_CHECK_EQUAL(budget.getVoices().size(), MaxVoices);
+    BOOST_CHECK(!hasBuffer(budget.getVoices(), 1));
+    BOOST_CHECK(hasBuffer(budget.getVoices(), 10));
+    // a one-shot sound that loses its voice is gone
+    BOOST_CHECK(budget.getVirtualVoices().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_least_audible_new_voice_is_rejected)
+{
+    VoiceBudget budget{MaxVoices};
+    budget.setListenerPosition(glm::vec3{0, 0, 0});
+    fill(budget, {1000, 3000, 2000, 500}, 99);
+
+    for(const float distance : {3000.0f, 5000.0f})
+    {
+        auto voice = makeVoice(10, distance);
+        boost::optional<Voice> stolen;
+        BOOST_CHECK(!budget.acquire(voice, stolen));
+        BOOST_CHECK(!stolen.is_initialized());
+        BOOST_CHECK_EQUAL(budget.getVoices().size(), MaxVoices);
+        BOOST_CHECK(hasBuffer(budget.getVoices(), 1));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_stolen_looping_voice_becomes_virtual_and_resumes)
+{
+    VoiceBudget budget{MaxVoices};
+    budget.setListenerPosition(glm::vec3{0, 0, 0});
+    fill(budget, {1000, 3000, 2000, 500}, 1);
+
+    // listener-relative sounds are fully audible, so they steal from positioned ones
+    auto voice = makeVoice(10, boost::none);
+    boost::optional<Voice> stolen;
+    BOOST_REQUIRE(budget.acquire(voice, stolen));
+    BOOST_REQUIRE(stolen.is_initialized());
+    BOOST_CHECK_EQUAL(stolen->buffer, 1u);
+    budget.addVoice(voice);
+
+    BOOST_REQUIRE_EQUAL(budget.getVirtualVoices().size(), 1u);
+    BOOST_CHECK_EQUAL(budget.getVirtualVoices()[0].buffer, 1u);
+    BOOST_CHECK(budget.getVirtualVoices()[0].source == nullptr);
+
+    // once the listener moves next to it, the virtual voice is the loudest and steals the now farthest voice
+    budget.setListenerPosition(glm::vec3{3000, 0, 0});
+    budget.updateAudibility();
+    const auto loudest = budget.findLoudestVirtualVoice();
+    BOOST_REQUIRE(loudest.is_initialized());
+    auto resumed = budget.getVirtualVoices()[*loudest];
+    BOOST_REQUIRE(budget.acquire(resumed, stolen));
+    BOOST_REQUIRE(stolen.is_initialized());
+    BOOST_CHECK_EQUAL(stolen->buffer, 3u);
+    budget.removeVirtualVoice(*loudest);
+    budget.addVoice(resumed);
+
+    BOOST_CHECK(hasBuffer(budget.getVoices(), 1));
+    BOOST_CHECK(!hasBuffer(budget.getVoices(), 3));
+    BOOST_CHECK(budget.getVirtualVoices().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+#include "voicebudget.h"
+
+#include "soundengine.h"
+
+namespace audio
+{
+VoiceBudget::VoiceBudget(const size_t maxVoices)
+    : m_maxVoices{maxVoices}
+{
+    Expects(m_maxVoices > 0);
+    m_voices.reserve(m_maxVoices);
+}
+
+float VoiceBudget::getAudibility(const Voice& voice) const
+{
+    if(!m_listenerPosition.is_initialized())
+        return voice.gain;
+
+    glm::vec3 pos;
+    if(voice.emitter != nullptr)
+        pos = voice.emitter->getPosition();
+    else if(voice.position.is_initialized())
+        pos = *voice.position;
+    else
+        return voice.gain; // listener-relative
+
+    const auto attenuation = 1 - glm::distance(pos, *m_listenerPosition) / SourceHandle::MaxDistance;
+    return voice.gain * util::clamp(attenuation, 0.0f, 1.0f);
+}
+
+size_t VoiceBudget::findWeakestVoice() const
+{
+    Expects(!m_voices.empty());
+
+    size_t weakest = 0;
+    for(size_t i = 1; i < m_voices.size(); ++i)
+    {
+        if(m_voices[i].audibility < m_voices[weakest].audibility)
+            weakest = i;
+    }
+    return weakest;
+}
+
+bool VoiceBudget::acquire(Voice& voice, boost::optional<Voice>& stolen)
+{
+    voice.audibility = getAudibility(voice);
+    stolen.reset();
+
+    if(m_voices.size() < m_maxVoices)
+        return true;
+
+    const auto weakest = findWeakestVoice();
+    if(m_voices[weakest].audibility >= voice.audibility)
+        return false;
+
+    stolen = m_voices[weakest];
+    if(stolen->looping)
+        addVirtualVoice(*stolen);
+
+    if(weakest != m_voices.size() - 1)
+        m_voices[weakest] = std::move(m_voices.back());
+    m_voices.pop_back();
+    return true;
+}
+
+void VoiceBudget::updateAudibility()
+{
+    for(auto& voice : m_voices)
+        voice.audibility = getAudibility(voice);
+}
+
+boost::optional<size_t> VoiceBudget::findLoudestVirtualVoice()
+{
+    if(m_virtualVoices.empty())
+        return boost::none;
+
+    size_t loudest = 0;
+    for(size_t i = 0; i < m_virtualVoices.size(); ++i)
+    {
+        m_virtualVoices[i].audibility = getAudibility(m_virtualVoices[i]);
+        if(m_virtualVoices[i].audibility > m_virtualVoices[loudest].audibility)
+            loudest = i;
+    }
+    return loudest;
+}
+
+void VoiceBudget::removeVirtualVoice(const size_t idx)
+{
+    Expects(idx < m_virtualVoices.size());
+
+    if(idx != m_virtualVoices.size() - 1)
+        m_virtualVoices[idx] = std::move(m_virtualVoices.back());
+    m_virtualVoices.pop_back();
+}
+}
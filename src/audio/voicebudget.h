@@ -0,0 +1,107 @@
+#pragma once
+
+#include "gsl-lite.hpp"
+#include "sourcehandle.h"
+
+#include <boost/optional.hpp>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace audio
+{
+class Emitter;
+
+//! A sound playing on a source, or waiting for one as a virtual voice.
+struct Voice
+{
+    std::shared_ptr<SourceHandle> source;
+    Emitter* emitter;
+    size_t buffer;
+    ALfloat pitch;
+    ALfloat gain;
+    bool looping;
+    //! Fixed position of sounds without an emitter; listener-relative if not set.
+    boost::optional<glm::vec3> position;
+    float audibility;
+};
+
+/**
+ * @brief Decides which sounds get one of a fixed number of voices.
+ *
+ * @details
+ * The audibility of a voice is its gain, attenuated by the distance to the listener.  When all voices are taken, a
+ * new sound steals the least audible voice, or is rejected if it would be the least audible one itself.  Looping
+ * sounds that lose their voice are kept as virtual voices.  The sources themselves are started and stopped by the
+ * SoundEngine.
+ */
+class VoiceBudget final
+{
+public:
+    explicit VoiceBudget(size_t maxVoices);
+
+    //! Sets the position positioned voices are attenuated from; all voices are fully audible without a listener.
+    void setListenerPosition(const boost::optional<glm::vec3>& position)
+    {
+        m_listenerPosition = position;
+    }
+
+    float getAudibility(const Voice& voice) const;
+
+    /**
+     * @brief Makes room for @a voice, after updating its audibility.
+     * @param[out] stolen The voice that had to make room, if any.  It is kept as a virtual voice if it's looping.
+     * @return @c false if @a voice is not more audible than any active voice while the budget is exhausted; nothing
+     *         is changed then.
+     */
+    bool acquire(Voice& voice, boost::optional<Voice>& stolen);
+
+    //! Adds a voice which got room through #acquire.
+    void addVoice(Voice voice)
+    {
+        Expects(m_voices.size() < m_maxVoices);
+        m_voices.emplace_back(std::move(voice));
+    }
+
+    void addVirtualVoice(Voice voice)
+    {
+        voice.source.reset();
+        m_virtualVoices.emplace_back(std::move(voice));
+    }
+
+    void updateAudibility();
+
+    //! Returns the index of the most audible virtual voice, after updating their audibility.
+    boost::optional<size_t> findLoudestVirtualVoice();
+
+    void removeVirtualVoice(size_t idx);
+
+    std::vector<Voice>& getVoices() noexcept
+    {
+        return m_voices;
+    }
+
+    const std::vector<Voice>& getVoices() const noexcept
+    {
+        return m_voices;
+    }
+
+    std::vector<Voice>& getVirtualVoices() noexcept
+    {
+        return m_virtualVoices;
+    }
+
+    const std::vector<Voice>& getVirtualVoices() const noexcept
+    {
+        return m_virtualVoices;
+    }
+
+private:
+    //! Returns the index of the least audible active voice.
+    size_t findWeakestVoice() const;
+
+    const size_t m_maxVoices;
+    boost::optional<glm::vec3> m_listenerPosition;
+    std::vector<Voice> m_voices;
+    std::vector<Voice> m_virtualVoices;
+};
+}
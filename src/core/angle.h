@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/trigtables.h"
 #include "core/units.h"
 #include "gsl-lite.hpp"
 
@@ -39,7 +40,11 @@ inline Angle angleFromDegrees(const float value)
 
 inline Angle angleFromAtan(const core::Length& dx, const core::Length& dz)
 {
+#ifdef FIXED_POINT_TRIG
+    return Angle{trig::atan(dx.get(), dz.get()) * AngleStorageScale};
+#else
     return angleFromRad(std::atan2(dx.get_as<float>(), dz.get_as<float>()));
+#endif
 }
 
 constexpr float toDegrees(const Angle& a) noexcept
@@ -52,6 +57,23 @@ inline float toRad(const Angle& a) noexcept
     return a.get_as<float>() / AngleStorageScale * glm::pi<float>() * 2 / FullRotation;
 }
 
+#ifdef FIXED_POINT_TRIG
+//! Reduces @a a to the 16 bit angle units used by the lookup tables.
+constexpr uint16_t toTrigAngle(const Angle& a) noexcept
+{
+    return static_cast<uint16_t>(static_cast<uint32_t>(a.get()) / AngleStorageScale);
+}
+
+inline float sin(const Angle& a) noexcept
+{
+    return static_cast<float>(trig::sin(toTrigAngle(a))) / trig::Scale;
+}
+
+inline float cos(const Angle& a) noexcept
+{
+    return static_cast<float>(trig::cos(toTrigAngle(a))) / trig::Scale;
+}
+#else
 inline float sin(const Angle& a) noexcept
 {
     return glm::sin(toRad(a));
@@ -61,6 +83,7 @@ inline float cos(const Angle& a) noexcept
 {
     return glm::cos(toRad(a));
 }
+#endif
 
 inline Angle abs(const Angle& a)
 {
@@ -0,0 +1,138 @@
+#define BOOST_TEST_MODULE core_test
+
+#include "trigtables.h"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+using namespace core;
+
+namespace
+{
+constexpr double Pi = 3.14159265358979323846;
+
+double toRad(const int32_t angle)
+{
+    return angle * 2 * Pi / 65536;
+}
+
+//! Difference of two angles in angle units, taking wrap-around into account.
+int32_t angleDistance(const int32_t a, const int32_t b)
+{
+    const auto d = std::abs(a - b) % 65536;
+    return d > 32768 ? 65536 - d : d;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(trig_tests)
+
+BOOST_AUTO_TEST_CASE(test_sin_cos_cardinal_angles)
+{
+    BOOST_CHECK_EQUAL(trig::sin(0), 0);
+    BOOST_CHECK_EQUAL(trig::sin(0x4000), trig::Scale);
+    BOOST_CHECK_EQUAL(trig::sin(0x8000), 0);
+    BOOST_CHECK_EQUAL(trig::sin(0xc000), -trig::Scale);
+    BOOST_CHECK_EQUAL(trig::cos(0), trig::Scale);
+    BOOST_CHECK_EQUAL(trig::cos(0x4000), 0);
+    BOOST_CHECK_EQUAL(trig::cos(0x8000), -trig::Scale);
+    BOOST_CHECK_EQUAL(trig::cos(0xc000), 0);
+
+    static_assert(trig::sin(0x2000) == 11585, "sin(45 deg) must be evaluable at compile time");
+}
+
+BOOST_AUTO_TEST_CASE(test_sin_cos_accuracy)
+{
+    // one table step is 2*pi/4096, plus rounding of the table values
+    static constexpr double Tolerance = 2 * Pi / 4096 + 1.0 / trig::Scale;
+
+    for(int32_t angle = 0; angle < 65536; ++angle)
+    {
+        const auto a = static_cast<uint16_t>(angle);
+        BOOST_REQUIRE_LE(std::abs(trig::sin(a) / double(trig::Scale) - std::sin(toRad(angle))), Tolerance);
+        BOOST_REQUIRE_LE(std::abs(trig::cos(a) / double(trig::Scale) - std::cos(toRad(angle))), Tolerance);
+    }
+
+    // angles on the table grid only suffer from rounding of the table values
+    for(int32_t angle = 0; angle < 65536; angle += 16)
+    {
+        const auto a = static_cast<uint16_t>(angle);
+        BOOST_REQUIRE_LE(std::abs(trig::sin(a) / double(trig::Scale) - std::sin(toRad(angle))), 0.5 / trig::Scale);
+        BOOST_REQUIRE_EQUAL(trig::sin(a), -trig::sin(static_cast<uint16_t>(-angle)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_atan_cardinal_angles)
+{
+    BOOST_CHECK_EQUAL(trig::atan(0, 0), 0);
+    BOOST_CHECK_EQUAL(trig::atan(0, 100), 0);
+    BOOST_CHECK_EQUAL(trig::atan(100, 100), 0x2000);
+    BOOST_CHECK_EQUAL(trig::atan(100, 0), 0x4000);
+    BOOST_CHECK_EQUAL(trig::atan(0, -100), -0x8000);
+    BOOST_CHECK_EQUAL(trig::atan(-100, 0), -0x4000);
+    BOOST_CHECK_EQUAL(trig::atan(-100, -100), -0x6000);
+}
+
+BOOST_AUTO_TEST_CASE(test_atan_accuracy)
+{
+    // one table step changes the angle by at most 1/2048 rad, i.e. about 5 angle units
+    for(int32_t x = -3000; x <= 3000; x += 37)
+    {
+        for(int32_t z = -3000; z <= 3000; z += 41)
+        {
+            const auto expected = static_cast<int32_t>(std::lround(std::atan2(x, z) / 2 / Pi * 65536));
+            BOOST_REQUIRE_LE(angleDistance(trig::atan(x, z), expected), 6);
+        }
+    }
+
+    // large distances must not overflow
+    BOOST_CHECK_EQUAL(trig::atan(2000000000, 2000000000), 0x2000);
+}
+
+BOOST_AUTO_TEST_CASE(test_tables_are_reproducible)
+{
+    // any change of these sums means that the tables, and thus the game's behaviour, changed
+    int64_t sinSum = 0;
+    for(int32_t i = 0; i <= trig::SinSteps; ++i)
+        sinSum += trig::detail::Tables<>::sin[i] * int64_t{i + 1};
+    int64_t atanSum = 0;
+    for(int32_t i = 0; i <= trig::AtanSteps; ++i)
+        atanSum += trig::detail::Tables<>::atan[i] * int64_t{i + 1};
+
+    BOOST_CHECK_EQUAL(sinSum, 6981835383);
+    BOOST_CHECK_EQUAL(atanSum, 12503403449);
+}
+
+BOOST_AUTO_TEST_CASE(test_throughput)
+{
+    // no timing is asserted as it depends on the machine; the numbers are only reported
+    static constexpr int32_t Rounds = 100;
+
+    int64_t fixedSum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for(int32_t round = 0; round < Rounds; ++round)
+    {
+        for(int32_t angle = 0; angle < 65536; ++angle)
+            fixedSum += trig::sin(static_cast<uint16_t>(angle + round));
+    }
+    const auto fixedDuration = std::chrono::high_resolution_clock::now() - start;
+
+    float floatSum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for(int32_t round = 0; round < Rounds; ++round)
+    {
+        for(int32_t angle = 0; angle < 65536; ++angle)
+            floatSum += std::sin(static_cast<float>(toRad(angle + round)));
+    }
+    const auto floatDuration = std::chrono::high_resolution_clock::now() - start;
+
+    BOOST_TEST_MESSAGE("sine lookups: "
+                       << std::chrono::duration_cast<std::chrono::microseconds>(fixedDuration).count()
+                       << "us (sum " << fixedSum << "), std::sin: "
+                       << std::chrono::duration_cast<std::chrono::microseconds>(floatDuration).count() << "us (sum "
+                       << floatSum << ")");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+
+namespace core
+{
+/**
+ * @brief Fixed-point trigonometry using lookup tables, with the layout and precision of the original engine's tables.
+ *
+ * @details
+ * Angles are given in 16 bit angle units, where 65536 is a full rotation.  The tables are computed by the compiler
+ * using plain double arithmetic, so they are identical across compilers and platforms, and so are all results.
+ */
+namespace trig
+{
+//! The fixed-point value representing 1.
+constexpr int32_t Scale = 1 << 14;
+//! Number of sine table steps per quarter rotation; angles are reduced to 12 bits.
+constexpr int32_t SinSteps = 1024;
+//! Number of atan table steps for tangents in <tt>[0, 1]</tt>.
+constexpr int32_t AtanSteps = 2048;
+
+namespace detail
+{
+constexpr double Pi = 3.14159265358979323846;
+constexpr double Epsilon = 1e-17;
+
+template<typename T, int32_t N>
+struct Table
+{
+    T values[N];
+
+    constexpr const T& operator[](const int32_t i) const
+    {
+        return values[i];
+    }
+};
+
+//! Taylor series of the sine, for @a x in <tt>[0, pi/2]</tt>.
+constexpr double sinSeries(const double x)
+{
+    double term = x;
+    double sum = x;
+    for(int n = 1; term > Epsilon || term < -Epsilon; ++n)
+    {
+        term = -term * x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+//! Newton iteration of the square root, for @a x in <tt>[1, 2]</tt>.
+constexpr double sqrtNewton(const double x)
+{
+    double r = 1;
+    for(int i = 0; i < 8; ++i)
+        r = (r + x / r) / 2;
+    return r;
+}
+
+//! Taylor series of the arc tangent, for @a x in <tt>[0, 1]</tt>.
+constexpr double atanSeries(const double x)
+{
+    // atan(x) = 2*atan(h) with h <= tan(pi/8), to let the series converge quickly
+    const double h = x / (1 + sqrtNewton(1 + x * x));
+    double power = h;
+    double sum = h;
+    for(int n = 1; power > Epsilon || power < -Epsilon; ++n)
+    {
+        power = -power * h * h;
+        sum += power / (2 * n + 1);
+    }
+    return 2 * sum;
+}
+
+constexpr Table<int16_t, SinSteps + 1> makeSinTable()
+{
+    Table<int16_t, SinSteps + 1> table{};
+    for(int32_t i = 0; i <= SinSteps; ++i)
+        table.values[i] = static_cast<int16_t>(sinSeries(i * Pi / 2 / SinSteps) * Scale + 0.5);
+    return table;
+}
+
+constexpr Table<uint16_t, AtanSteps + 1> makeAtanTable()
+{
+    Table<uint16_t, AtanSteps + 1> table{};
+    for(int32_t i = 0; i <= AtanSteps; ++i)
+        table.values[i] = static_cast<uint16_t>(atanSeries(static_cast<double>(i) / AtanSteps) / 2 / Pi * 65536 + 0.5);
+    return table;
+}
+
+// a class template, so that all translation units share a single instance of the tables
+template<typename = void>
+struct Tables
+{
+    //! Quarter wave of the sine, scaled by #Scale.
+    static constexpr Table<int16_t, SinSteps + 1> sin = makeSinTable();
+    //! Arc tangent of <tt>i / AtanSteps</tt> in angle units.
+    static constexpr Table<uint16_t, AtanSteps + 1> atan = makeAtanTable();
+};
+
+template<typename T>
+constexpr Table<int16_t, SinSteps + 1> Tables<T>::sin;
+
+template<typename T>
+constexpr Table<uint16_t, AtanSteps + 1> Tables<T>::atan;
+} // namespace detail
+
+//! Returns the sine of @a angle, scaled by #Scale.
+constexpr int32_t sin(const uint16_t angle)
+{
+    const int32_t index = angle >> 4;
+    const int32_t step = index & (SinSteps - 1);
+    switch(index / SinSteps)
+    {
+    case 0: return detail::Tables<>::sin[step];
+    case 1: return detail::Tables<>::sin[SinSteps - step];
+    case 2: return -detail::Tables<>::sin[step];
+    default: return -detail::Tables<>::sin[SinSteps - step];
+    }
+}
+
+//! Returns the cosine of @a angle, scaled by #Scale.
+constexpr int32_t cos(const uint16_t angle)
+{
+    return sin(static_cast<uint16_t>(angle + (1 << 14)));
+}
+
+/**
+ * @brief Returns the angle of the vector (@a x, @a z), measured from the positive Z axis towards the positive X axis.
+ *
+ * @details
+ * The result is in <tt>[-32768, 32767]</tt>, matching <tt>atan2(x, z)</tt>.
+ */
+constexpr int32_t atan(const int64_t x, const int64_t z)
+{
+    if(x == 0 && z == 0)
+        return 0;
+
+    const auto absX = x < 0 ? -x : x;
+    const auto absZ = z < 0 ? -z : z;
+
+    // the octant's angle is looked up using the smaller component, so that the tangent is within [0, 1]
+    int32_t angle = absX <= absZ ? detail::Tables<>::atan[static_cast<int32_t>(absX * AtanSteps / absZ)]
+                                 : (1 << 14) - detail::Tables<>::atan[static_cast<int32_t>(absZ * AtanSteps / absX)];
+
+    if(z < 0)
+        angle = (1 << 15) - angle;
+    if(x < 0)
+        angle = -angle;
+
+    // +180 degrees is the same as -180 degrees
+    return angle == (1 << 15) ? -(1 << 15) : angle;
+}
+} // namespace trig
+} // namespace core
@@ -2,6 +2,7 @@
 
 #include "engine/laranode.h"
 #include "engine/script/reflection.h"
+#include "util/profiler.h"
 
 namespace engine
 {
@@ -35,11 +36,11 @@ Mood parseMood(const std::string& s)
 }
 } // namespace
 
-gsl::span<const uint16_t> LotInfo::getOverlaps(const Engine& engine, const uint16_t idx)
+gsl::span<const uint16_t> BoxGraph::getOverlaps(const uint16_t idx) const
 {
-    const auto first = &engine.getOverlaps().at(idx);
+    const auto first = &overlaps.at(idx);
     auto last = first;
-    const auto endOfUniverse = &engine.getOverlaps().back() + 1;
+    const auto endOfUniverse = &overlaps.back() + 1;
 
     while(last < endOfUniverse && (*last & 0x8000u) == 0)
     {
@@ -51,8 +52,6 @@ gsl::span<const uint16_t> LotInfo::getOverlaps(const Engine& engine, const uint1
 
 bool LotInfo::calculateTarget(const Engine& engine, core::TRVec& moveTarget, const items::ItemState& item)
 {
-    updatePath(engine, 5);
-
     moveTarget = item.position.position;
 
     auto here = item.box;
@@ -221,7 +220,7 @@ bool LotInfo::calculateTarget(const Engine& engine, core::TRVec& moveTarget, con
             return true;
         }
 
-        const auto nextBox = nodes[here].exit_box;
+        const auto nextBox = getNode(here).exit_box;
         if(nextBox == nullptr || !canVisit(*nextBox))
             break;
 
@@ -260,8 +259,8 @@ bool LotInfo::calculateTarget(const Engine& engine, core::TRVec& moveTarget, con
 YAML::Node LotInfo::save(const Engine& engine) const
 {
     YAML::Node node;
-    for(const auto& entry : nodes)
-        node["nodes"][std::distance(&engine.getBoxes()[0], entry.first)] = entry.second.save(engine);
+    for(size_t i = 0; i < nodes.size(); ++i)
+        node["nodes"][i] = nodes[i].save(engine);
     for(const auto& box : boxes)
         node["boxes"].push_back(std::distance(&engine.getBoxes()[0], box.get()));
     if(head != nullptr)
@@ -285,9 +284,9 @@ YAML::Node LotInfo::save(const Engine& engine) const
 
 void LotInfo::load(const YAML::Node& n, const Engine& engine)
 {
-    nodes.clear();
+    nodes.assign(engine.getBoxes().size(), SearchNode{});
     for(const auto& entry : n["nodes"])
-        nodes[&engine.getBoxes().at(entry.first.as<size_t>())].load(entry.second, engine);
+        nodes.at(entry.first.as<size_t>()).load(entry.second, engine);
     boxes.clear();
     for(const auto& entry : n["boxes"])
         boxes.emplace_back(&engine.getBoxes().at(entry.as<size_t>()));
@@ -316,14 +315,16 @@ void LotInfo::load(const YAML::Node& n, const Engine& engine)
     target.load(n["target"]);
 }
 
-void updateMood(const Engine& engine, const items::ItemState& item, const AiInfo& aiInfo, const bool violent)
+void updateMood(Engine& engine, const items::ItemState& item, const AiInfo& aiInfo, const bool violent)
 {
+    util::ProfileZone zone{"ai-mood"};
+
     if(item.creatureInfo == nullptr)
         return;
 
     CreatureInfo& creatureInfo = *item.creatureInfo;
-    if(creatureInfo.lot.nodes[item.box].blocked
-       && creatureInfo.lot.nodes[item.box].search_revision == creatureInfo.lot.m_searchVersion)
+    if(creatureInfo.lot.getNode(item.box).blocked
+       && creatureInfo.lot.getNode(item.box).search_revision == creatureInfo.lot.m_searchVersion)
     {
         creatureInfo.lot.required_box = nullptr;
     }
@@ -505,11 +506,17 @@ void updateMood(const Engine& engine, const items::ItemState& item, const AiInfo
         Expects(item.box != nullptr);
         creatureInfo.lot.setRandomSearchTarget(item.box);
     }
+
+    // the original searched right after choosing the target box, so the search for a new one starts on this tick
+    engine.getThinkPhase().searchNewTarget(creatureInfo.lot, BoxGraph{engine});
+
     creatureInfo.lot.calculateTarget(engine, creatureInfo.target, item);
 }
 
 AiInfo::AiInfo(Engine& engine, items::ItemState& item)
 {
+    util::ProfileZone zone{"ai-info"};
+
     if(item.creatureInfo == nullptr)
         return;
 
@@ -522,8 +529,8 @@ AiInfo::AiInfo(Engine& engine, items::ItemState& item)
     enemy_zone = engine.getLara().m_state.box->*zoneRef;
     enemy_unreachable
         = (!item.creatureInfo->lot.canVisit(*engine.getLara().m_state.box)
-           || (item.creatureInfo->lot.nodes[item.box].blocked
-               && item.creatureInfo->lot.nodes[item.box].search_revision == item.creatureInfo->lot.m_searchVersion));
+           || (item.creatureInfo->lot.getNode(item.box).blocked
+               && item.creatureInfo->lot.getNode(item.box).search_revision == item.creatureInfo->lot.m_searchVersion));
 
     auto objectInfo = engine.getScriptEngine()["getObjectInfo"].call<script::ObjectInfo>(item.type.get());
     const core::Length pivotLength{objectInfo.pivot_length};
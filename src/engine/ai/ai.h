@@ -54,9 +54,34 @@ struct SearchNode
     void load(const YAML::Node& n, const Engine& engine);
 };
 
+//! The box graph of a level, as read by the path searches.
+struct BoxGraph
+{
+    const std::vector<loader::file::Box>& boxes;
+    const std::vector<uint16_t>& overlaps;
+    const bool roomsAreSwapped;
+
+    explicit BoxGraph(const engine::Engine& engine)
+        : BoxGraph{engine.getBoxes(), engine.getOverlaps(), engine.roomsAreSwapped()}
+    {
+    }
+
+    explicit BoxGraph(const std::vector<loader::file::Box>& boxes,
+                      const std::vector<uint16_t>& overlaps,
+                      const bool roomsAreSwapped)
+        : boxes{boxes}
+        , overlaps{overlaps}
+        , roomsAreSwapped{roomsAreSwapped}
+    {
+    }
+
+    gsl::span<const uint16_t> getOverlaps(uint16_t idx) const;
+};
+
 struct LotInfo
 {
-    std::unordered_map<const loader::file::Box*, SearchNode> nodes;
+    //! @brief The search state of each box, indexed like the boxes of the level.
+    std::vector<SearchNode> nodes;
 
     std::vector<gsl::not_null<const loader::file::Box*>> boxes;
 
@@ -94,13 +119,29 @@ struct LotInfo
 
     core::TRVec target;
 
+    //! The nodes the search may still expand during the current tick, handed out by ThinkPhase::add.
+    uint8_t searchShare = 0;
+
     explicit LotInfo(const engine::Engine& engine)
+        : LotInfo{engine.getBoxes()}
+    {
+    }
+
+    explicit LotInfo(const std::vector<loader::file::Box>& boxes)
+        : nodes(boxes.size())
+        , m_boxes{boxes.data()}
+    {
+    }
+
+    SearchNode& getNode(const gsl::not_null<const loader::file::Box*>& box)
     {
-        for(const auto& box : engine.getBoxes())
-            nodes.insert(std::make_pair(&box, SearchNode{}));
+        return nodes.at(gsl::narrow<size_t>(box.get() - m_boxes));
     }
 
-    static gsl::span<const uint16_t> getOverlaps(const engine::Engine& engine, uint16_t idx);
+    const SearchNode& getNode(const gsl::not_null<const loader::file::Box*>& box) const
+    {
+        return nodes.at(gsl::narrow<size_t>(box.get() - m_boxes));
+    }
 
     void setRandomSearchTarget(const gsl::not_null<const loader::file::Box*>& box)
     {
@@ -125,6 +166,7 @@ struct LotInfo
      * @brief Incrementally calculate all paths to a specific box.
      * @param lvl The level for acquiring additional needed data.
      * @param maxDepth Maximum number of nodes of the search tree to expand at a time.
+     * @returns The number of nodes expanded.
      *
      * @details
      * The algorithm performs a greedy breadth-first search, searching for all paths that lead to
@@ -132,13 +174,18 @@ struct LotInfo
      * calls to actually calculate the full path.  Until a full path is found, the nodes partially retain the old
      * paths from a previous search.
      */
-    void updatePath(const engine::Engine& engine, const uint8_t maxDepth)
+    uint8_t updatePath(const engine::Engine& engine, const uint8_t maxDepth)
+    {
+        return updatePath(BoxGraph{engine}, maxDepth);
+    }
+
+    uint8_t updatePath(const BoxGraph& graph, const uint8_t maxDepth)
     {
         if(required_box != nullptr && required_box != target_box)
         {
             target_box = required_box;
 
-            const auto targetNode = &nodes[target_box];
+            const auto targetNode = &getNode(target_box);
             if(targetNode->next_expansion == nullptr && tail != target_box)
             {
                 targetNode->next_expansion = head;
@@ -149,19 +196,21 @@ struct LotInfo
 
             targetNode->search_revision = ++m_searchVersion;
             targetNode->exit_box = nullptr;
+            // the original kept this flag within the revision, so a new search always started unblocked
+            targetNode->blocked = false;
 
             if(m_searchVersion == std::numeric_limits<SearchNode::RevisionType>::max())
             {
                 // shift revisions while keeping strict ordering
                 SearchNode::RevisionType minRev = std::numeric_limits<SearchNode::RevisionType>::max();
-                for(const auto& node : nodes | boost::adaptors::map_values)
+                for(const auto& node : nodes)
                 {
                     minRev = std::min(node.search_revision, minRev);
                 }
 
                 Expects(minRev != 0);
                 m_searchVersion -= minRev;
-                for(auto& node : nodes | boost::adaptors::map_values)
+                for(auto& node : nodes)
                 {
                     node.search_revision -= minRev;
                 }
@@ -169,31 +218,31 @@ struct LotInfo
         }
 
         Expects(target_box != nullptr);
-        searchPath(engine, maxDepth);
+        return searchPath(graph, maxDepth);
     }
 
-    void searchPath(const engine::Engine& engine, const uint8_t maxDepth)
+    uint8_t searchPath(const BoxGraph& graph, const uint8_t maxDepth)
     {
         if(head == nullptr)
         {
-            return;
+            return 0;
         }
 
-        const auto zoneRef = loader::file::Box::getZoneRef(engine.roomsAreSwapped(), fly, step);
+        const auto zoneRef = loader::file::Box::getZoneRef(graph.roomsAreSwapped, fly, step);
         const auto searchZone = head->*zoneRef;
 
         for(uint8_t i = 0; i < maxDepth; ++i)
         {
             if(head == nullptr)
             {
-                return;
+                return i;
             }
 
-            const auto headNode = &nodes[head];
+            const auto headNode = &getNode(head);
 
-            for(const auto overlapBoxIdx : getOverlaps(engine, head->overlap_index))
+            for(const auto overlapBoxIdx : graph.getOverlaps(head->overlap_index))
             {
-                const auto* overlapBox = &engine.getBoxes().at(overlapBoxIdx & 0x7FFFu);
+                const auto* overlapBox = &graph.boxes.at(overlapBoxIdx & 0x7FFFu);
 
                 if(searchZone != overlapBox->*zoneRef)
                     continue; // cannot switch zones
@@ -202,7 +251,7 @@ struct LotInfo
                 if(boxHeightDiff > step || boxHeightDiff < drop)
                     continue; // can't reach from this box, but still maybe from another one
 
-                auto overlapNode = &nodes[overlapBox];
+                auto overlapNode = &getNode(overlapBox);
 
                 if(headNode->search_revision < overlapNode->search_revision)
                     continue; // not yet checked if we can reach this box
@@ -231,16 +280,21 @@ struct LotInfo
                 }
 
                 if(overlapNode->next_expansion == nullptr && overlapBox != tail)
-                    tail = nodes[tail].next_expansion = overlapBox; // enqueue for expansion
+                    tail = getNode(tail).next_expansion = overlapBox; // enqueue for expansion
             }
 
             head = std::exchange(headNode->next_expansion, nullptr);
         }
+
+        return maxDepth;
     }
 
     YAML::Node save(const Engine& engine) const;
 
     void load(const YAML::Node& n, const Engine& engine);
+
+private:
+    const loader::file::Box* m_boxes;
 };
 
 struct AiInfo
@@ -316,6 +370,13 @@ struct CreatureInfo
     void load(const YAML::Node& n, const Engine& engine);
 };
 
-void updateMood(const engine::Engine& engine, const items::ItemState& item, const AiInfo& aiInfo, bool violent);
+/**
+ * @brief Updates the mood and the movement target of a creature.
+ *
+ * @details
+ * The creature's path towards its target box is advanced by Engine::update before the items are updated.  If a new
+ * target box is chosen, its search starts right away with what is left of the creature's share of the tick.
+ */
+void updateMood(engine::Engine& engine, const items::ItemState& item, const AiInfo& aiInfo, bool violent);
 } // namespace ai
 } // namespace engine
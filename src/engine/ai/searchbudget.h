@@ -0,0 +1,102 @@
+#pragma once
+
+#include "gsl-lite.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace engine
+{
+namespace ai
+{
+/**
+ * @brief Limits the number of box graph nodes expanded by all creature path searches within a single tick.
+ *
+ * @details
+ * Path searches continue where they left off, so a creature which doesn't get to expand all nodes it wants to in
+ * one tick simply takes a few more ticks to find its path.  The budget is split evenly among the creatures that
+ * searched during the previous tick, so with only a few creatures, each one gets the full search depth it asks for.
+ * If the budget doesn't divide evenly, the remainder rotates through the searches from tick to tick, so that even
+ * with more searches than nodes in the budget, none of them starves.
+ */
+class SearchBudget final
+{
+public:
+    explicit SearchBudget(const size_t expansionsPerTick)
+        : m_expansionsPerTick{expansionsPerTick}
+        , m_remaining{expansionsPerTick}
+        , m_histogram(expansionsPerTick + 2, 0)
+    {
+        Expects(expansionsPerTick > 0);
+    }
+
+    //! Refills the budget, and sets the share of each search to be used during the new tick.
+    void nextTick() noexcept
+    {
+        if(std::exchange(m_tickStarted, true))
+            ++m_histogram[std::min(std::exchange(m_expanded, 0), m_histogram.size() - 1)];
+
+        m_previousSearches = std::exchange(m_searches, 0);
+        m_remaining = m_expansionsPerTick;
+        ++m_tick;
+    }
+
+    /**
+     * @brief Reserves the nodes a search may expand during the current tick, which are at most @a maxDepth.
+     *
+     * @details
+     * All searches of a tick acquire their share before any of them runs, so nodes a search doesn't expand are not
+     * handed to other searches.
+     */
+    uint8_t acquire(const uint8_t maxDepth) noexcept
+    {
+        const auto searches = std::max<size_t>(1, m_previousSearches);
+        const auto slot = (m_searches++ + m_tick) % searches;
+        const auto share = m_expansionsPerTick * (slot + 1) / searches - m_expansionsPerTick * slot / searches;
+        const auto granted = std::min({size_t{maxDepth}, share, m_remaining});
+        m_remaining -= granted;
+        return gsl::narrow_cast<uint8_t>(granted);
+    }
+
+    //! Counts the nodes the searches actually expanded during the current tick.
+    void recordExpanded(const size_t count) noexcept
+    {
+        m_expanded += count;
+    }
+
+    //! The nodes expanded during the current tick so far.
+    size_t getExpanded() const noexcept
+    {
+        return m_expanded;
+    }
+
+    /**
+     * @brief The number of finished ticks by the number of nodes expanded during them.
+     *
+     * @details
+     * The last entry collects the ticks that expanded more nodes than the budget allows, which would be a bug.
+     */
+    const std::vector<size_t>& getHistogram() const noexcept
+    {
+        return m_histogram;
+    }
+
+    void resetHistogram()
+    {
+        std::fill(m_histogram.begin(), m_histogram.end(), 0);
+    }
+
+private:
+    const size_t m_expansionsPerTick;
+    size_t m_remaining;
+    size_t m_searches = 0;
+    size_t m_previousSearches = 0;
+    size_t m_tick = 0;
+    size_t m_expanded = 0;
+    bool m_tickStarted = false;
+    std::vector<size_t> m_histogram;
+};
+} // namespace ai
+} // namespace engine
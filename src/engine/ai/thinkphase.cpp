@@ -0,0 +1,51 @@
+#include "thinkphase.h"
+
+#include "ai.h"
+#include "util/jobsystem.h"
+#include "util/profiler.h"
+
+namespace engine
+{
+namespace ai
+{
+void ThinkPhase::begin()
+{
+    m_budget.nextTick();
+    m_searches.clear();
+}
+
+void ThinkPhase::add(LotInfo& lot)
+{
+    lot.searchShare = m_budget.acquire(5);
+    if(lot.required_box == nullptr && lot.target_box == nullptr)
+        return;
+
+    m_searches.emplace_back(PathSearch{&lot, lot.searchShare, 0});
+}
+
+void ThinkPhase::run(const BoxGraph& graph, util::JobSystem& jobs)
+{
+    jobs.parallelFor(m_searches.size(), [this, &graph](const size_t i) {
+        util::ProfileZone searchZone{"ai-path"};
+        auto& search = m_searches[i];
+        search.expanded = search.lot->updatePath(graph, search.maxDepth);
+    });
+
+    for(const auto& search : m_searches)
+    {
+        search.lot->searchShare -= search.expanded;
+        m_budget.recordExpanded(search.expanded);
+    }
+}
+
+void ThinkPhase::searchNewTarget(LotInfo& lot, const BoxGraph& graph)
+{
+    if(lot.required_box == nullptr || lot.required_box == lot.target_box)
+        return;
+
+    const auto expanded = lot.updatePath(graph, lot.searchShare);
+    lot.searchShare -= expanded;
+    m_budget.recordExpanded(expanded);
+}
+} // namespace ai
+} // namespace engine
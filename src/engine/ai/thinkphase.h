@@ -0,0 +1,71 @@
+#pragma once
+
+#include "searchbudget.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace util
+{
+class JobSystem;
+}
+
+namespace engine
+{
+namespace ai
+{
+struct BoxGraph;
+struct LotInfo;
+
+/**
+ * @brief Advances the path searches of all creatures at the start of a tick, before any of them moves.
+ *
+ * @details
+ * The budget is handed out serially in the order the creatures are added, before any search runs, so the results
+ * don't depend on the number of threads.  The searches only read the box graph and write their own LotInfo, so they
+ * run in parallel.  Creatures without a target keep their share for when they choose one while updating their mood,
+ * see #searchNewTarget.
+ */
+class ThinkPhase final
+{
+public:
+    explicit ThinkPhase(const size_t expansionsPerTick)
+        : m_budget{expansionsPerTick}
+    {
+    }
+
+    //! Refills the budget for a new tick.
+    void begin();
+
+    //! Hands @a lot its share of the current tick's budget, and queues its search if it has a target.
+    void add(LotInfo& lot);
+
+    //! Runs the queued searches on @a jobs, and takes the nodes they expanded from their shares.
+    void run(const BoxGraph& graph, util::JobSystem& jobs);
+
+    //! Continues the search of a creature that chose a new target during this tick, with the rest of its share.
+    void searchNewTarget(LotInfo& lot, const BoxGraph& graph);
+
+    SearchBudget& getBudget() noexcept
+    {
+        return m_budget;
+    }
+
+    const SearchBudget& getBudget() const noexcept
+    {
+        return m_budget;
+    }
+
+private:
+    struct PathSearch
+    {
+        LotInfo* lot;
+        uint8_t maxDepth;
+        uint8_t expanded;
+    };
+
+    SearchBudget m_budget;
+    std::vector<PathSearch> m_searches;
+};
+} // namespace ai
+} // namespace engine
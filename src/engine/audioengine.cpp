@@ -223,7 +223,10 @@ gsl::not_null<std::shared_ptr<audio::Stream>> AudioEngine::playStream(size_t tra
     return result;
 }
 
-std::shared_ptr<audio::SourceHandle> AudioEngine::playSound(const core::SoundId id, audio::Emitter* emitter)
+std::shared_ptr<audio::SourceHandle> AudioEngine::playSoundAt(const core::SoundId id,
+                                                              audio::Emitter* emitter,
+                                                              const boost::optional<glm::vec3>& position,
+                                                              const bool forceLooping)
 {
     const auto snd = m_soundmap.at(id.get());
     if(snd < 0)
@@ -251,16 +254,21 @@ std::shared_ptr<audio::SourceHandle> AudioEngine::playSound(const core::SoundId
     if(volume <= 0)
         return nullptr;
 
+    const auto play = [this, sample, pitch, volume, emitter, &position](const bool looping) {
+        if(position.is_initialized())
+            return m_soundEngine.playBuffer(sample, pitch, volume, *position, looping);
+        return m_soundEngine.playBuffer(sample, pitch, volume, emitter, looping);
+    };
+
     std::shared_ptr<audio::SourceHandle> handle;
-    if(details.getPlaybackType(loader::file::level::Engine::TR1) == loader::file::PlaybackType::Looping)
+    if(forceLooping
+       || details.getPlaybackType(loader::file::level::Engine::TR1) == loader::file::PlaybackType::Looping)
     {
         auto handles = m_soundEngine.getSourcesForBuffer(emitter, sample);
         if(handles.empty())
         {
             BOOST_LOG_TRIVIAL(trace) << "Play looping sound " << toString(id.get_as<TR1SoundId>());
-            handle = m_soundEngine.playBuffer(sample, pitch, volume, emitter);
-            handle->setLooping(true);
-            handle->play();
+            handle = play(true);
         }
         else
         {
@@ -280,12 +288,14 @@ std::shared_ptr<audio::SourceHandle> AudioEngine::playSound(const core::SoundId
             handle->setGain(volume);
             if(emitter != nullptr)
                 handle->setPosition(emitter->getPosition());
+            else if(position.is_initialized())
+                handle->setPosition(*position);
             handle->play();
         }
         else
         {
             BOOST_LOG_TRIVIAL(trace) << "Play restarting sound " << toString(id.get_as<TR1SoundId>());
-            handle = m_soundEngine.playBuffer(sample, pitch, volume, emitter);
+            handle = play(false);
         }
     }
     else if(details.getPlaybackType(loader::file::level::Engine::TR1) == loader::file::PlaybackType::Wait)
@@ -294,7 +304,7 @@ std::shared_ptr<audio::SourceHandle> AudioEngine::playSound(const core::SoundId
         if(handles.empty())
         {
             BOOST_LOG_TRIVIAL(trace) << "Play non-playing sound " << toString(id.get_as<TR1SoundId>());
-            handle = m_soundEngine.playBuffer(sample, pitch, volume, emitter);
+            handle = play(false);
         }
         else
         {
@@ -305,7 +315,7 @@ std::shared_ptr<audio::SourceHandle> AudioEngine::playSound(const core::SoundId
     else
     {
         BOOST_LOG_TRIVIAL(trace) << "Default play mode - playing sound " << toString(id.get_as<TR1SoundId>());
-        handle = m_soundEngine.playBuffer(sample, pitch, volume, emitter);
+        handle = play(false);
     }
 
     return handle;
@@ -344,8 +354,7 @@ void AudioEngine::setUnderwater(bool underwater)
 
         if(m_underwaterAmbience.expired())
         {
-            m_underwaterAmbience = playSound(TR1SoundId::UnderwaterAmbience, nullptr);
-            m_underwaterAmbience.lock()->setLooping(true);
+            m_underwaterAmbience = playSound(TR1SoundId::UnderwaterAmbience, nullptr, true);
         }
     }
     else if(!m_underwaterAmbience.expired())
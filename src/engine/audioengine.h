@@ -48,16 +48,20 @@ struct AudioEngine
     boost::optional<TR1TrackId> m_currentTrack;
     boost::optional<TR1SoundId> m_currentLaraTalk;
 
-    std::shared_ptr<audio::SourceHandle> playSound(core::SoundId id, audio::Emitter* emitter);
+    /**
+     * @param[in] forceLooping Loop the sound even if its playback type isn't looping.
+     * @return The playing source, or @c nullptr if the sound isn't audible.
+     */
+    std::shared_ptr<audio::SourceHandle>
+        playSound(const core::SoundId id, audio::Emitter* emitter, const bool forceLooping = false)
+    {
+        return playSoundAt(id, emitter, boost::none, forceLooping);
+    }
 
+    //! Plays a sound at a fixed position, so that it's attenuated and ranked by its distance to the listener.
     std::shared_ptr<audio::SourceHandle> playSound(const core::SoundId id, const glm::vec3& pos)
     {
-        const auto handle = playSound(id, nullptr);
-        if(handle == nullptr)
-            return nullptr;
-
-        handle->setPosition(pos);
-        return handle;
+        return playSoundAt(id, nullptr, pos, false);
     }
 
     gsl::not_null<std::shared_ptr<audio::Stream>> playStream(size_t trackId);
@@ -75,5 +79,12 @@ struct AudioEngine
     void stopSound(core::SoundId soundId, audio::Emitter* emitter);
 
     void setUnderwater(bool underwater);
+
+private:
+    //! Plays a sound at @a emitter, or at @a position if it's set.
+    std::shared_ptr<audio::SourceHandle> playSoundAt(core::SoundId id,
+                                                     audio::Emitter* emitter,
+                                                     const boost::optional<glm::vec3>& position,
+                                                     bool forceLooping);
 };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "engine.h"
 #include "laranode.h"
 #include "render/portaltracer.h"
+#include "util/profiler.h"
 
 #include <queue>
 #include <utility>
@@ -133,7 +134,7 @@ void CameraController::setCamOverride(const floordata::CameraParameters& camPara
         m_mode = CameraMode::Fixed;
 }
 
-void CameraController::handleCommandSequence(const engine::floordata::FloorDataValue* cmdSequence)
+void CameraController::handleCommandSequence(const floordata::Trigger& trigger)
 {
     if(m_mode == CameraMode::Heavy)
         return;
@@ -146,19 +147,15 @@ void CameraController::handleCommandSequence(const engine::floordata::FloorDataV
     };
 
     Type type = Type::NoChange;
-    while(true)
+    for(const floordata::TriggerCommand& command : trigger.commands)
     {
-        const floordata::Command command{*cmdSequence++};
-
         if(command.opcode == floordata::CommandOpcode::LookAt && m_mode != CameraMode::FreeLook
            && m_mode != CameraMode::Combat)
         {
-            m_targetItem = m_engine->getItem(command.parameter);
+            m_targetItem = command.item;
         }
         else if(command.opcode == floordata::CommandOpcode::SwitchCamera)
         {
-            ++cmdSequence; // skip camera parameters
-
             if(command.parameter != m_currentFixedCameraId)
             {
                 type = Type::Invalid; // new override
@@ -178,9 +175,6 @@ void CameraController::handleCommandSequence(const engine::floordata::FloorDataV
                 }
             }
         }
-
-        if(command.isLast)
-            break;
     }
 
     if(m_targetItem == nullptr)
@@ -194,7 +188,10 @@ void CameraController::handleCommandSequence(const engine::floordata::FloorDataV
 std::unordered_set<const loader::file::Portal*> CameraController::tracePortals()
 {
     for(const auto& room : m_engine->getRooms())
+    {
         room.node->setVisible(false);
+        room.node->setCullBox(boost::none);
+    }
 
     return render::PortalTracer::trace(*m_eye->room, *m_engine);
 }
@@ -202,10 +199,10 @@ std::unordered_set<const loader::file::Portal*> CameraController::tracePortals()
 bool CameraController::clampY(const core::TRVec& start,
                               core::TRVec& end,
                               const gsl::not_null<const loader::file::Sector*>& sector,
-                              const Engine& engine)
+                              const SlantPolicy slantPolicy)
 {
-    const HeightInfo floor = HeightInfo::fromFloor(sector, end, engine.getItemNodes());
-    const HeightInfo ceiling = HeightInfo::fromCeiling(sector, end, engine.getItemNodes());
+    const HeightInfo floor = HeightInfo::fromFloor(sector, end, slantPolicy);
+    const HeightInfo ceiling = HeightInfo::fromCeiling(sector, end, slantPolicy);
 
     const auto d = end - start;
     if(floor.y < end.Y && floor.y > start.Y)
@@ -229,7 +226,7 @@ bool CameraController::clampY(const core::TRVec& start,
 
 CameraController::ClampType CameraController::clampAlongX(const core::RoomBoundPosition& start,
                                                           core::RoomBoundPosition& end,
-                                                          const Engine& engine)
+                                                          const SlantPolicy slantPolicy)
 {
     if(end.position.X == start.position.X)
     {
@@ -267,8 +264,8 @@ CameraController::ClampType CameraController::clampAlongX(const core::RoomBoundP
         }
 
         auto sector = findRealFloorSector(testPos, &end.room);
-        if(testPos.Y > HeightInfo::fromFloor(sector, testPos, engine.getItemNodes()).y
-           || testPos.Y < HeightInfo::fromCeiling(sector, testPos, engine.getItemNodes()).y)
+        if(testPos.Y > HeightInfo::fromFloor(sector, testPos, slantPolicy).y
+           || testPos.Y < HeightInfo::fromCeiling(sector, testPos, slantPolicy).y)
         {
             end.position = testPos;
             return ClampType::Ceiling;
@@ -278,8 +275,8 @@ CameraController::ClampType CameraController::clampAlongX(const core::RoomBoundP
         heightPos.X += sign * 1_len;
         auto tmp = end.room;
         sector = findRealFloorSector(heightPos, &tmp);
-        if(testPos.Y > HeightInfo::fromFloor(sector, heightPos, engine.getItemNodes()).y
-           || testPos.Y < HeightInfo::fromCeiling(sector, heightPos, engine.getItemNodes()).y)
+        if(testPos.Y > HeightInfo::fromFloor(sector, heightPos, slantPolicy).y
+           || testPos.Y < HeightInfo::fromCeiling(sector, heightPos, slantPolicy).y)
         {
             end.position = testPos;
             end.room = tmp;
@@ -292,7 +289,7 @@ CameraController::ClampType CameraController::clampAlongX(const core::RoomBoundP
 
 CameraController::ClampType CameraController::clampAlongZ(const core::RoomBoundPosition& start,
                                                           core::RoomBoundPosition& end,
-                                                          const Engine& engine)
+                                                          const SlantPolicy slantPolicy)
 {
     if(end.position.Z == start.position.Z)
     {
@@ -330,8 +327,8 @@ CameraController::ClampType CameraController::clampAlongZ(const core::RoomBoundP
         }
 
         auto sector = findRealFloorSector(testPos, &end.room);
-        if(testPos.Y > HeightInfo::fromFloor(sector, testPos, engine.getItemNodes()).y
-           || testPos.Y < HeightInfo::fromCeiling(sector, testPos, engine.getItemNodes()).y)
+        if(testPos.Y > HeightInfo::fromFloor(sector, testPos, slantPolicy).y
+           || testPos.Y < HeightInfo::fromCeiling(sector, testPos, slantPolicy).y)
         {
             end.position = testPos;
             return ClampType::Ceiling;
@@ -341,8 +338,8 @@ CameraController::ClampType CameraController::clampAlongZ(const core::RoomBoundP
         heightPos.Z += sign * 1_len;
         auto tmp = end.room;
         sector = findRealFloorSector(heightPos, &tmp);
-        if(testPos.Y > HeightInfo::fromFloor(sector, heightPos, engine.getItemNodes()).y
-           || testPos.Y < HeightInfo::fromCeiling(sector, heightPos, engine.getItemNodes()).y)
+        if(testPos.Y > HeightInfo::fromFloor(sector, heightPos, slantPolicy).y
+           || testPos.Y < HeightInfo::fromCeiling(sector, heightPos, slantPolicy).y)
         {
             end.position = testPos;
             end.room = tmp;
@@ -355,19 +352,19 @@ CameraController::ClampType CameraController::clampAlongZ(const core::RoomBoundP
 
 bool CameraController::clampPosition(const core::RoomBoundPosition& start,
                                      core::RoomBoundPosition& end,
-                                     const Engine& engine)
+                                     const SlantPolicy slantPolicy)
 {
     bool firstUnclamped;
     ClampType secondClamp;
     if(abs(end.position.Z - start.position.Z) <= abs(end.position.X - start.position.X))
     {
-        firstUnclamped = clampAlongZ(start, end, engine) == ClampType::None;
-        secondClamp = clampAlongX(start, end, engine);
+        firstUnclamped = clampAlongZ(start, end, slantPolicy) == ClampType::None;
+        secondClamp = clampAlongX(start, end, slantPolicy);
     }
     else
     {
-        firstUnclamped = clampAlongX(start, end, engine) == ClampType::None;
-        secondClamp = clampAlongZ(start, end, engine);
+        firstUnclamped = clampAlongX(start, end, slantPolicy) == ClampType::None;
+        secondClamp = clampAlongZ(start, end, slantPolicy);
     }
 
     if(secondClamp == ClampType::Wall)
@@ -376,11 +373,14 @@ bool CameraController::clampPosition(const core::RoomBoundPosition& start,
     }
 
     const auto sector = loader::file::findRealFloorSector(end);
-    return clampY(start.position, end.position, sector, engine) && firstUnclamped && secondClamp == ClampType::None;
+    return clampY(start.position, end.position, sector, slantPolicy) && firstUnclamped
+           && secondClamp == ClampType::None;
 }
 
 std::unordered_set<const loader::file::Portal*> CameraController::update()
 {
+    util::ProfileZone zone{"camera"};
+
     m_rotationAroundCenter.X = util::clamp(m_rotationAroundCenter.X, -85_deg, +85_deg);
 
     if(m_mode == CameraMode::Cinematic)
@@ -395,12 +395,12 @@ std::unordered_set<const loader::file::Portal*> CameraController::update()
     }
 
     if(m_modifier != CameraModifier::AllowSteepSlants)
-        HeightInfo::skipSteepSlants = true;
+        m_slantPolicy = SlantPolicy::SkipSteep;
 
     const bool fixed = m_targetItem != nullptr && (m_mode == CameraMode::Fixed || m_mode == CameraMode::Heavy);
 
     // if we have a fixed position, we also have an item we're looking at
-    items::ItemNode* const focusedItem = fixed ? m_targetItem.get() : &m_engine->getLara();
+    items::ItemNode* const focusedItem = fixed ? m_targetItem : &m_engine->getLara();
     BOOST_ASSERT(focusedItem != nullptr);
     auto focusBBox = focusedItem->getBoundingBox();
     auto focusY = focusedItem->m_state.position.position.Y;
@@ -414,7 +414,7 @@ std::unordered_set<const loader::file::Portal*> CameraController::update()
         // lara moves around and looks at some item, some sort of involuntary free look;
         // in this case, we have an item to look at, but the camera is _not_ fixed
 
-        BOOST_ASSERT(m_targetItem.get() != focusedItem);
+        BOOST_ASSERT(m_targetItem != focusedItem);
         const auto distToFocused
             = m_targetItem->m_state.position.position.distanceTo(focusedItem->m_state.position.position);
         auto eyeRotY
@@ -490,8 +490,8 @@ std::unordered_set<const loader::file::Portal*> CameraController::update()
         }
 
         const auto sector = loader::file::findRealFloorSector(*m_center);
-        if(HeightInfo::fromFloor(sector, m_center->position, m_engine->getItemNodes()).y < m_center->position.Y)
-            HeightInfo::skipSteepSlants = false;
+        if(HeightInfo::fromFloor(sector, m_center->position, m_slantPolicy).y < m_center->position.Y)
+            m_slantPolicy = SlantPolicy::All;
 
         if(m_mode == CameraMode::Chase || m_modifier == CameraModifier::Chase)
             chaseItem(*focusedItem);
@@ -510,7 +510,7 @@ std::unordered_set<const loader::file::Portal*> CameraController::update()
         m_eyeCenterDistance = core::DefaultCameraLaraDistance;
         m_fixedCameraId = -1;
     }
-    HeightInfo::skipSteepSlants = false;
+    m_slantPolicy = SlantPolicy::All;
 
     return tracePortals();
 }
@@ -523,7 +523,7 @@ void CameraController::handleFixedCamera()
     core::RoomBoundPosition pos(&m_engine->getRooms().at(camera.room));
     pos.position = camera.position;
 
-    if(!clampPosition(*m_center, pos, *m_engine))
+    if(!clampPosition(*m_center, pos, m_slantPolicy))
     {
         // ReSharper disable once CppExpressionWithoutSideEffects
         moveIntoGeometry(pos, core::QuarterSectorSize);
@@ -561,8 +561,8 @@ core::Length CameraController::moveIntoGeometry(core::RoomBoundPosition& pos, co
             && isVerticallyOutsideRoom(pos.position + core::TRVec(margin, 0_len, 0_len), room))
         pos.position.X = sector->box->xmax - margin;
 
-    auto bottom = HeightInfo::fromFloor(sector, pos.position, m_engine->getItemNodes()).y - margin;
-    auto top = HeightInfo::fromCeiling(sector, pos.position, m_engine->getItemNodes()).y + margin;
+    auto bottom = HeightInfo::fromFloor(sector, pos.position, m_slantPolicy).y - margin;
+    auto top = HeightInfo::fromCeiling(sector, pos.position, m_slantPolicy).y + margin;
     if(bottom < top)
         top = bottom = (bottom + top) / 2;
 
@@ -577,27 +577,26 @@ bool CameraController::isVerticallyOutsideRoom(const core::TRVec& pos,
                                                const gsl::not_null<const loader::file::Room*>& room) const
 {
     const auto sector = findRealFloorSector(pos, room);
-    const auto floor = HeightInfo::fromFloor(sector, pos, m_engine->getItemNodes()).y;
-    const auto ceiling = HeightInfo::fromCeiling(sector, pos, m_engine->getItemNodes()).y;
+    const auto floor = HeightInfo::fromFloor(sector, pos, m_slantPolicy).y;
+    const auto ceiling = HeightInfo::fromCeiling(sector, pos, m_slantPolicy).y;
     return pos.Y > floor || pos.Y <= ceiling;
 }
 
 void CameraController::updatePosition(const core::RoomBoundPosition& eyePositionGoal, const int smoothFactor)
 {
     m_eye->position += (eyePositionGoal.position - m_eye->position) / smoothFactor;
-    HeightInfo::skipSteepSlants = false;
+    m_slantPolicy = SlantPolicy::All;
     m_eye->room = eyePositionGoal.room;
     auto sector = loader::file::findRealFloorSector(*m_eye);
-    auto floor = HeightInfo::fromFloor(sector, m_eye->position, m_engine->getItemNodes()).y - core::QuarterSectorSize;
+    auto floor = HeightInfo::fromFloor(sector, m_eye->position, m_slantPolicy).y - core::QuarterSectorSize;
     if(floor <= m_eye->position.Y && floor <= eyePositionGoal.position.Y)
     {
-        clampPosition(*m_center, *m_eye, *m_engine);
+        clampPosition(*m_center, *m_eye, m_slantPolicy);
         sector = loader::file::findRealFloorSector(*m_eye);
-        floor = HeightInfo::fromFloor(sector, m_eye->position, m_engine->getItemNodes()).y - core::QuarterSectorSize;
+        floor = HeightInfo::fromFloor(sector, m_eye->position, m_slantPolicy).y - core::QuarterSectorSize;
     }
 
-    auto ceiling
-        = HeightInfo::fromCeiling(sector, m_eye->position, m_engine->getItemNodes()).y + core::QuarterSectorSize;
+    auto ceiling = HeightInfo::fromCeiling(sector, m_eye->position, m_slantPolicy).y + core::QuarterSectorSize;
     if(floor < ceiling)
     {
         floor = ceiling = (floor + ceiling) / 2;
@@ -741,7 +740,7 @@ void CameraController::handleEnemy(const items::ItemNode& item)
 void CameraController::clampBox(core::RoomBoundPosition& eyePositionGoal,
                                 const std::function<ClampCallback>& callback) const
 {
-    clampPosition(*m_center, eyePositionGoal, *m_engine);
+    clampPosition(*m_center, eyePositionGoal, m_slantPolicy);
     BOOST_ASSERT(m_center->room->getSectorByAbsolutePosition(m_center->position) != nullptr);
     auto clampBox = m_center->room->getSectorByAbsolutePosition(m_center->position)->box;
     BOOST_ASSERT(clampBox != nullptr);
@@ -1107,7 +1106,7 @@ YAML::Node CameraController::save() const
         result["item"] = std::find_if(m_engine->getItemNodes().begin(),
                                       m_engine->getItemNodes().end(),
                                       [&](const std::pair<uint16_t, std::shared_ptr<items::ItemNode>>& entry) {
-                                          return entry.second == m_targetItem;
+                                          return entry.second.get() == m_targetItem;
                                       })
                              ->first;
     }
@@ -1116,7 +1115,7 @@ YAML::Node CameraController::save() const
         result["lastItem"] = std::find_if(m_engine->getItemNodes().begin(),
                                           m_engine->getItemNodes().end(),
                                           [&](const std::pair<uint16_t, std::shared_ptr<items::ItemNode>>& entry) {
-                                              return entry.second == m_previousItem;
+                                              return entry.second.get() == m_previousItem;
                                           })
                                  ->first;
     }
@@ -1163,7 +1162,7 @@ void CameraController::load(const YAML::Node& n)
         const auto it = m_engine->getItemNodes().find(n["item"].as<uint16_t>());
         if(it == m_engine->getItemNodes().end())
             BOOST_THROW_EXCEPTION(std::domain_error("Invalid item reference"));
-        m_targetItem = it->second.get();
+        m_targetItem = it->second.get().get();
     }
     if(!n["lastItem"].IsDefined())
     {
@@ -1174,7 +1173,7 @@ void CameraController::load(const YAML::Node& n)
         const auto it = m_engine->getItemNodes().find(n["lastItem"].as<uint16_t>());
         if(it == m_engine->getItemNodes().end())
             BOOST_THROW_EXCEPTION(std::domain_error("Invalid item reference"));
-        m_previousItem = it->second.get();
+        m_previousItem = it->second.get().get();
     }
     if(!n["enemy"].IsDefined())
     {
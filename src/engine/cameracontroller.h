@@ -2,6 +2,7 @@
 
 #include "audio/soundengine.h"
 #include "core/angle.h"
+#include "heightinfo.h"
 #include "loader/file/datatypes.h"
 #include "render/scene/Camera.h"
 
@@ -63,6 +64,9 @@ private:
 
     bool m_fixed = false;
 
+    //! @brief The slants considered while updating the camera; steep ones are skipped unless looking at the floor.
+    SlantPolicy m_slantPolicy = SlantPolicy::All;
+
     /**
      * @brief If <0, bounce randomly around +/- @c m_bounce/2, increasing value by 5 each frame; if >0, do a single Y bounce downwards by @c m_bounce.
      */
@@ -80,8 +84,9 @@ private:
 
     //! @brief An item to point the camera to.
     //! @note Also modifies Lara's head and torso rotation.
-    std::shared_ptr<items::ItemNode> m_targetItem = nullptr;
-    std::shared_ptr<const items::ItemNode> m_previousItem = nullptr;
+    //! @note Items are never removed from the engine's item map, so the pointer stays valid.
+    items::ItemNode* m_targetItem = nullptr;
+    const items::ItemNode* m_previousItem = nullptr;
     std::shared_ptr<items::ItemNode> m_enemy = nullptr;
     //! @brief Movement smoothness for adjusting the pivot position.
     int m_smoothness = 8;
@@ -136,13 +141,13 @@ public:
                         const core::Frame& timeout,
                         bool switchIsOn);
 
-    void setLookAtItem(const std::shared_ptr<items::ItemNode>& item)
+    void setLookAtItem(items::ItemNode* item)
     {
         if(item != nullptr && (m_mode == CameraMode::Fixed || m_mode == CameraMode::Heavy))
             m_targetItem = item;
     }
 
-    void handleCommandSequence(const floordata::FloorDataValue* cmdSequence);
+    void handleCommandSequence(const floordata::Trigger& trigger);
 
     std::unordered_set<const loader::file::Portal*> update();
 
@@ -206,12 +211,14 @@ public:
      * @brief Clamps a point between two endpoints if there is a floordata-defined obstacle
      * @param[in] start Starting point
      * @param[in] end Destination of the movement, clamped if necessary
-     * @param[in] engine For accessing boxes and floordata
+     * @param[in] slantPolicy The floor and ceiling slants to consider
      * @retval false if clamped
      *
      * @warning Please be aware that the return value is reverted and not what you might expect...
      */
-    static bool clampPosition(const core::RoomBoundPosition& start, core::RoomBoundPosition& end, const Engine& engine);
+    static bool clampPosition(const core::RoomBoundPosition& start,
+                              core::RoomBoundPosition& end,
+                              SlantPolicy slantPolicy = SlantPolicy::All);
 
     void setBounce(const core::Length& bounce)
     {
@@ -240,7 +247,7 @@ private:
     static bool clampY(const core::TRVec& start,
                        core::TRVec& end,
                        const gsl::not_null<const loader::file::Sector*>& sector,
-                       const Engine& engine);
+                       SlantPolicy slantPolicy);
 
     enum class ClampType
     {
@@ -250,10 +257,10 @@ private:
     };
 
     static ClampType
-        clampAlongX(const core::RoomBoundPosition& start, core::RoomBoundPosition& end, const Engine& engine);
+        clampAlongX(const core::RoomBoundPosition& start, core::RoomBoundPosition& end, SlantPolicy slantPolicy);
 
     static ClampType
-        clampAlongZ(const core::RoomBoundPosition& start, core::RoomBoundPosition& end, const Engine& engine);
+        clampAlongZ(const core::RoomBoundPosition& start, core::RoomBoundPosition& end, SlantPolicy slantPolicy);
 
     void handleFixedCamera();
 
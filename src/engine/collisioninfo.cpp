@@ -2,6 +2,9 @@
 
 #include "core/magic.h"
 #include "laranode.h"
+#include "util/profiler.h"
+
+#include <algorithm>
 
 namespace engine
 {
@@ -23,6 +26,8 @@ core::Length reflectAtSectorBoundary(const core::Length& target, const core::Len
 
 void CollisionInfo::initHeightInfo(const core::TRVec& laraPos, const Engine& engine, const core::Length& height)
 {
+    util::ProfileZone zone{"collision"};
+
     collisionType = AxisColl::None;
     shift = core::TRVec{};
     facingAxis = *axisFromAngle(facingAngle, 45_deg);
@@ -31,7 +36,7 @@ void CollisionInfo::initHeightInfo(const core::TRVec& laraPos, const Engine& eng
     const auto refTestPos = laraPos - core::TRVec(0_len, height + core::ScalpToHandsHeight, 0_len);
     const auto currentSector = findRealFloorSector(refTestPos, &room);
 
-    mid.init(currentSector, refTestPos, engine.getItemNodes(), laraPos.Y, height);
+    mid.init(currentSector, refTestPos, laraPos.Y, height);
 
     std::tie(floorSlantX, floorSlantZ) = engine.getFloorSlantInfo(currentSector, laraPos);
 
@@ -78,7 +83,7 @@ void CollisionInfo::initHeightInfo(const core::TRVec& laraPos, const Engine& eng
     // Front
     auto testPos = refTestPos + core::TRVec(frontX, 0_len, frontZ);
     auto sector = findRealFloorSector(testPos, &room);
-    front.init(sector, testPos, engine.getItemNodes(), laraPos.Y, height);
+    front.init(sector, testPos, laraPos.Y, height);
     if(policyFlags.is_set(PolicyFlags::SlopesAreWalls) && front.floorSpace.slantClass == SlantClass::Steep
        && front.floorSpace.y < 0_len)
     {
@@ -86,9 +91,8 @@ void CollisionInfo::initHeightInfo(const core::TRVec& laraPos, const Engine& eng
     }
     else if(front.floorSpace.y > 0_len
             && ((policyFlags.is_set(PolicyFlags::SlopesArePits) && front.floorSpace.slantClass == SlantClass::Steep)
-                || (policyFlags.is_set(PolicyFlags::LavaIsPit) && front.floorSpace.lastCommandSequenceOrDeath != nullptr
-                    && floordata::FloorDataChunk::extractType(*front.floorSpace.lastCommandSequenceOrDeath)
-                           == floordata::FloorDataChunkType::Death)))
+                || (policyFlags.is_set(PolicyFlags::LavaIsPit) && front.floorSpace.floorData != nullptr
+                    && front.floorSpace.floorData->isDeath)))
     {
         front.floorSpace.y = 2 * core::QuarterSectorSize;
     }
@@ -96,7 +100,7 @@ void CollisionInfo::initHeightInfo(const core::TRVec& laraPos, const Engine& eng
     // Front left
     testPos = refTestPos + core::TRVec(frontLeftX, 0_len, frontLeftZ);
     sector = findRealFloorSector(testPos, &room);
-    frontLeft.init(sector, testPos, engine.getItemNodes(), laraPos.Y, height);
+    frontLeft.init(sector, testPos, laraPos.Y, height);
 
     if(policyFlags.is_set(PolicyFlags::SlopesAreWalls) && frontLeft.floorSpace.slantClass == SlantClass::Steep
        && frontLeft.floorSpace.y < 0_len)
@@ -105,10 +109,8 @@ void CollisionInfo::initHeightInfo(const core::TRVec& laraPos, const Engine& eng
     }
     else if(frontLeft.floorSpace.y > 0_len
             && ((policyFlags.is_set(PolicyFlags::SlopesArePits) && frontLeft.floorSpace.slantClass == SlantClass::Steep)
-                || (policyFlags.is_set(PolicyFlags::LavaIsPit)
-                    && frontLeft.floorSpace.lastCommandSequenceOrDeath != nullptr
-                    && floordata::FloorDataChunk::extractType(*frontLeft.floorSpace.lastCommandSequenceOrDeath)
-                           == floordata::FloorDataChunkType::Death)))
+                || (policyFlags.is_set(PolicyFlags::LavaIsPit) && frontLeft.floorSpace.floorData != nullptr
+                    && frontLeft.floorSpace.floorData->isDeath)))
     {
         frontLeft.floorSpace.y = 2 * core::QuarterSectorSize;
     }
@@ -116,7 +118,7 @@ void CollisionInfo::initHeightInfo(const core::TRVec& laraPos, const Engine& eng
     // Front right
     testPos = refTestPos + core::TRVec(frontRightX, 0_len, frontRightZ);
     sector = findRealFloorSector(testPos, &room);
-    frontRight.init(sector, testPos, engine.getItemNodes(), laraPos.Y, height);
+    frontRight.init(sector, testPos, laraPos.Y, height);
 
     if(policyFlags.is_set(PolicyFlags::SlopesAreWalls) && frontRight.floorSpace.slantClass == SlantClass::Steep
        && frontRight.floorSpace.y < 0_len)
@@ -126,10 +128,8 @@ void CollisionInfo::initHeightInfo(const core::TRVec& laraPos, const Engine& eng
     else if(frontRight.floorSpace.y > 0_len
             && ((policyFlags.is_set(PolicyFlags::SlopesArePits)
                  && frontRight.floorSpace.slantClass == SlantClass::Steep)
-                || (policyFlags.is_set(PolicyFlags::LavaIsPit)
-                    && frontRight.floorSpace.lastCommandSequenceOrDeath != nullptr
-                    && floordata::FloorDataChunk::extractType(*frontRight.floorSpace.lastCommandSequenceOrDeath)
-                           == floordata::FloorDataChunkType::Death)))
+                || (policyFlags.is_set(PolicyFlags::LavaIsPit) && frontRight.floorSpace.floorData != nullptr
+                    && frontRight.floorSpace.floorData->isDeath)))
     {
         frontRight.floorSpace.y = 2 * core::QuarterSectorSize;
     }
@@ -209,29 +209,35 @@ void CollisionInfo::initHeightInfo(const core::TRVec& laraPos, const Engine& eng
     }
 }
 
-std::set<gsl::not_null<const loader::file::Room*>> CollisionInfo::collectTouchingRooms(const core::TRVec& position,
-                                                                                       const core::Length& radius,
-                                                                                       const core::Length& height,
-                                                                                       const Engine& engine)
+CollisionInfo::TouchingRooms CollisionInfo::collectTouchingRooms(const core::TRVec& position,
+                                                                 const core::Length& radius,
+                                                                 const core::Length& height,
+                                                                 const Engine& engine)
 {
-    std::set<gsl::not_null<const loader::file::Room*>> result;
+    TouchingRooms result;
     auto room = engine.getLara().m_state.position.room;
-    result.emplace(room);
+    result.emplace_back(room);
 
-    const auto roomAt = [position, room](const core::Length& x, const core::Length& y, const core::Length& z) {
+    const auto addRoomAt = [position, room, &result](const core::Length& x,
+                                                     const core::Length& y,
+                                                     const core::Length& z) {
         auto tmp = room;
         findRealFloorSector(position + core::TRVec(x, y, z), &tmp);
-        return tmp;
+        if(std::find(result.begin(), result.end(), tmp) == result.end())
+            result.emplace_back(tmp);
     };
 
-    result.emplace(roomAt(radius, 0_len, radius));
-    result.emplace(roomAt(-radius, 0_len, radius));
-    result.emplace(roomAt(radius, 0_len, -radius));
-    result.emplace(roomAt(-radius, 0_len, -radius));
-    result.emplace(roomAt(radius, -height, radius));
-    result.emplace(roomAt(-radius, -height, radius));
-    result.emplace(roomAt(radius, -height, -radius));
-    result.emplace(roomAt(-radius, -height, -radius));
+    addRoomAt(radius, 0_len, radius);
+    addRoomAt(-radius, 0_len, radius);
+    addRoomAt(radius, 0_len, -radius);
+    addRoomAt(-radius, 0_len, -radius);
+    addRoomAt(radius, -height, radius);
+    addRoomAt(-radius, -height, radius);
+    addRoomAt(radius, -height, -radius);
+    addRoomAt(-radius, -height, -radius);
+
+    // keep the order in which rooms are checked independent of the order in which they were found
+    std::sort(result.begin(), result.end());
     return result;
 }
 
@@ -4,7 +4,7 @@
 #include "heightinfo.h"
 #include "type_safe/flag_set.hpp"
 
-#include <set>
+#include <boost/container/static_vector.hpp>
 
 namespace engine
 {
@@ -66,10 +66,13 @@ struct CollisionInfo
 
     void initHeightInfo(const core::TRVec& laraPos, const Engine& engine, const core::Length& height);
 
-    static std::set<gsl::not_null<const loader::file::Room*>> collectTouchingRooms(const core::TRVec& position,
-                                                                                   const core::Length& radius,
-                                                                                   const core::Length& height,
-                                                                                   const Engine& engine);
+    //! Lara's room and the rooms containing the corners of the given box around @a position, sorted by address.
+    using TouchingRooms = boost::container::static_vector<gsl::not_null<const loader::file::Room*>, 9>;
+
+    static TouchingRooms collectTouchingRooms(const core::TRVec& position,
+                                              const core::Length& radius,
+                                              const core::Length& height,
+                                              const Engine& engine);
 
     bool checkStaticMeshCollisions(const core::TRVec& position, const core::Length& height, const Engine& engine);
 };
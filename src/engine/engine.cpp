@@ -1,5 +1,6 @@
 #include "engine.h"
 
+#include "ai/ai.h"
 #include "audio/tracktype.h"
 #include "floordata/floordata.h"
 #include "items/animating.h"
@@ -46,19 +47,27 @@
 #include "laranode.h"
 #include "loader/file/level/level.h"
 #include "loader/trx/trx.h"
+#include "render/gl/arraybuffer.h"
 #include "render/gl/font.h"
+#include "render/gl/timerquery.h"
+#include "render/instancebatch.h"
 #include "render/renderpipeline.h"
+#include "render/roombatch.h"
+#include "render/scene/renderqueue.h"
 #include "render/scene/scene.h"
 #include "render/textureanimator.h"
 #include "script/reflection.h"
 #include "tracks_tr1.h"
 #include "ui/label.h"
+#include "util/profiler.h"
 #include "video/player.h"
 
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <glm/gtx/norm.hpp>
+#include <numeric>
+#include <sstream>
 
 namespace engine
 {
@@ -118,29 +127,85 @@ sol::state createScriptEngine()
             tbl[entry.second] = static_cast<std::underlying_type_t<TR1TrackId>>(entry.first);
     }
 
+    try
+    {
+        engine.safe_script_file("scripts/main.lua");
+    }
+    catch(sol::error& e)
+    {
+        BOOST_LOG_TRIVIAL(fatal) << "Failed to load main.lua: " << e.what();
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to load main.lua"));
+    }
+
     return engine;
 }
+
+const char* getProfileZoneName(const items::ItemNode& item)
+{
+    const auto name = toString(item.m_state.type.get_as<TR1ItemId>());
+    return name != nullptr ? name : "item";
+}
+
+render::SsaoQuality getSsaoQuality(const sol::state& scriptEngine)
+{
+    const sol::optional<std::string> quality = scriptEngine["graphics"]["ssao"];
+    if(!quality.has_value() || quality.value() == "full")
+        return render::SsaoQuality::Full;
+    if(quality.value() == "off")
+        return render::SsaoQuality::Off;
+    if(quality.value() == "low")
+        return render::SsaoQuality::Low;
+    if(quality.value() == "medium")
+        return render::SsaoQuality::Medium;
+    if(quality.value() == "high")
+        return render::SsaoQuality::High;
+
+    BOOST_LOG_TRIVIAL(warning) << "Unknown SSAO quality " << quality.value() << ", using full quality";
+    return render::SsaoQuality::Full;
+}
+
+//! Cycles through the SSAO qualities from off to full.
+render::SsaoQuality getNextSsaoQuality(const render::SsaoQuality quality)
+{
+    switch(quality)
+    {
+    case render::SsaoQuality::Off: return render::SsaoQuality::Low;
+    case render::SsaoQuality::Low: return render::SsaoQuality::Medium;
+    case render::SsaoQuality::Medium: return render::SsaoQuality::High;
+    case render::SsaoQuality::High: return render::SsaoQuality::Full;
+    case render::SsaoQuality::Full: return render::SsaoQuality::Off;
+    }
+    return render::SsaoQuality::Full;
+}
+
+const char* getSsaoQualityName(const render::SsaoQuality quality)
+{
+    switch(quality)
+    {
+    case render::SsaoQuality::Off: return "off";
+    case render::SsaoQuality::Low: return "low";
+    case render::SsaoQuality::Medium: return "medium";
+    case render::SsaoQuality::High: return "high";
+    case render::SsaoQuality::Full: return "full";
+    }
+    return "unknown";
+}
 } // namespace
 
 std::tuple<int8_t, int8_t> Engine::getFloorSlantInfo(gsl::not_null<const loader::file::Sector*> sector,
                                                      const core::TRVec& position) const
 {
-    while(sector->roomBelow != nullptr)
-    {
-        sector = sector->roomBelow->getSectorByAbsolutePosition(position);
-    }
+    sector = sector->floorSector;
 
     static const auto zero = std::make_tuple(0, 0);
 
     if(position.Y + core::QuarterSectorSize * 2 < sector->floorHeight)
         return zero;
-    if(sector->floorData == nullptr)
-        return zero;
-    if(floordata::FloorDataChunk{*sector->floorData}.type != floordata::FloorDataChunkType::FloorSlant)
+    if(sector->decodedFloorData == nullptr || !sector->decodedFloorData->floorSlant.is_initialized())
         return zero;
 
-    const auto fd = sector->floorData[1];
-    return std::make_tuple(gsl::narrow_cast<int8_t>(fd.get() & 0xff), gsl::narrow_cast<int8_t>(fd.get() >> 8));
+    const auto& slant = *sector->decodedFloorData->floorSlant;
+    return std::make_tuple(slant.x, slant.z);
 }
 
 void Engine::swapAllRooms()
@@ -497,6 +562,52 @@ std::shared_ptr<LaraNode> Engine::createItems()
                                  << int(item.type.get());
     }
 
+    // from now on, the visibility only changes together with the trigger state
+    for(const auto& item : m_itemNodes | boost::adaptors::map_values)
+    {
+        if(item.get() != lara)
+            item->updateVisibility();
+    }
+
+    // height queries only consider the items activated by a sector, so they don't need to search the item map;
+    // floor data refers to the items placed in the level, so items created at runtime, which are only kept in
+    // m_dynamicItems, can never patch floor or ceiling heights
+    BOOST_ASSERT(m_dynamicItems.empty());
+    for(auto& floorData : m_level->m_decodedFloorData | boost::adaptors::map_values)
+    {
+        floorData.patchingItems.clear();
+        for(const auto itemId : floorData.activatedItems)
+        {
+            const auto it = m_itemNodes.find(itemId);
+            if(it != m_itemNodes.end())
+                floorData.patchingItems.emplace_back(it->second.get().get());
+        }
+
+        // triggers are dispatched without looking up any ids
+        if(!floorData.trigger.is_initialized())
+            continue;
+
+        auto& trigger = *floorData.trigger;
+        if(trigger.conditionItemId.is_initialized())
+            trigger.conditionItem = getItem(*trigger.conditionItemId).get();
+
+        for(auto& command : trigger.commands)
+        {
+            switch(command.opcode)
+            {
+            case floordata::CommandOpcode::Activate:
+            case floordata::CommandOpcode::LookAt: command.item = getItem(command.parameter).get(); break;
+            case floordata::CommandOpcode::UnderwaterCurrent:
+                if(command.parameter < m_level->m_cameras.size())
+                    command.sink = &m_level->m_cameras[command.parameter];
+                else
+                    BOOST_LOG_TRIVIAL(warning) << "Underwater current sink " << command.parameter << " does not exist";
+                break;
+            default: break;
+            }
+        }
+    }
+
     return lara;
 }
 
@@ -538,9 +649,61 @@ void Engine::loadSceneData(bool linearTextureInterpolation)
             uniform.set(camera->getViewProjectionMatrix()); // portals are already in world space
         });
 
-    for(auto& mesh : m_level->m_meshes)
+    // static meshes and sprites placed in rooms are drawn instanced, sharing the geometry of the models
+    render::InstanceBatch instanceBatch{"room-instances"};
+    const auto instancedShader = render::scene::ShaderProgram::createFromFile(
+        "shaders/textured_2.vert", "shaders/textured_2.frag", {"INSTANCED"});
+    const auto instancedMaterials = createMaterials(instancedShader);
+    const auto instancedColorMaterial = std::make_shared<render::scene::Material>(
+        "shaders/colored_2.vert", "shaders/colored_2.frag", std::vector<std::string>{"INSTANCED"});
+    instancedColorMaterial->getUniform("u_modelMatrix")->bindModelMatrix();
+    instancedColorMaterial->getUniform("u_modelViewMatrix")->bindModelViewMatrix();
+    instancedColorMaterial->getUniform("u_camProjection")->bindProjectionMatrix();
+
+    std::set<size_t> staticMeshModels;
+    for(const auto& staticMesh : m_level->m_staticMeshes)
     {
-        m_models.emplace_back(mesh.createModel(m_level->m_textureTiles, materials, colorMaterial, *m_level->m_palette));
+        if(staticMesh.isVisible())
+            staticMeshModels.emplace(m_level->m_meshIndices.at(staticMesh.mesh));
+    }
+
+    const auto vertexBytesBefore = render::gl::getArrayBufferUploadBytes();
+    loader::file::MeshStats geometryStats;
+    std::map<size_t, render::InstanceBatch::Prototype> staticMeshPrototypes;
+    for(size_t i = 0; i < m_level->m_meshes.size(); ++i)
+    {
+        const auto& mesh = m_level->m_meshes[i];
+        loader::file::Mesh::ModelBuilder builder{
+            !mesh.normals.empty(), m_level->m_textureTiles, materials, colorMaterial, *m_level->m_palette};
+        builder.append(mesh);
+        m_models.emplace_back(builder.finalize(geometryStats));
+
+        if(staticMeshModels.find(i) != staticMeshModels.end())
+        {
+            staticMeshPrototypes.emplace(
+                i, builder.createInstancePrototype(instanceBatch, instancedMaterials, instancedColorMaterial));
+        }
+    }
+
+    const auto billboardShader = render::scene::ShaderProgram::createFromFile(
+        "shaders/textured_2.vert", "shaders/textured_2.frag", {"INSTANCED", "BILLBOARD"});
+    std::map<const render::gl::Texture*, std::shared_ptr<render::scene::Material>> billboardMaterials;
+    std::vector<render::InstanceBatch::Prototype> spritePrototypes;
+    for(const auto& sprite : m_level->m_sprites)
+    {
+        auto& material = billboardMaterials[sprite.texture.get()];
+        if(material == nullptr)
+        {
+            material = std::make_shared<render::scene::Material>(billboardShader);
+            material->getRenderState().setCullFace(false);
+            material->getUniform("u_diffuseTexture")->set(sprite.texture);
+            material->getUniform("u_modelMatrix")->bindModelMatrix();
+            material->getUniform("u_modelViewMatrix")->bindModelViewMatrix();
+            material->getUniform("u_camProjection")->bindProjectionMatrix();
+        }
+
+        spritePrototypes.emplace_back(
+            instanceBatch.addBillboard(sprite.x0, -sprite.y0, sprite.x1, -sprite.y1, sprite.t0, sprite.t1, material));
     }
 
     for(auto idx : m_level->m_meshIndices)
@@ -560,8 +723,12 @@ void Engine::loadSceneData(bool linearTextureInterpolation)
         }
     }
 
-    const auto waterTexturedShader
-        = render::scene::ShaderProgram::createFromFile("shaders/textured_2.vert", "shaders/textured_2.frag", {"WATER"});
+    // room geometry is drawn through the room batch, which needs the room offsets in the shader
+    const auto roomShader = render::scene::ShaderProgram::createFromFile(
+        "shaders/textured_2.vert", "shaders/textured_2.frag", {"ROOM_BATCH"});
+    const auto roomMaterials = createMaterials(roomShader);
+    const auto waterTexturedShader = render::scene::ShaderProgram::createFromFile(
+        "shaders/textured_2.vert", "shaders/textured_2.frag", {"WATER", "ROOM_BATCH"});
     auto waterMaterials = createMaterials(waterTexturedShader);
     for(const auto& m : waterMaterials | boost::adaptors::map_values)
     {
@@ -571,12 +738,41 @@ void Engine::loadSceneData(bool linearTextureInterpolation)
         });
     }
 
+    m_roomBatch = std::make_shared<render::RoomBatch>("room-batch");
     for(size_t i = 0; i < m_level->m_rooms.size(); ++i)
     {
-        m_level->m_rooms[i].createSceneNode(
-            i, *m_level, materials, waterMaterials, m_models, *m_textureAnimator, m_spriteMaterial, m_portalMaterial);
+        m_level->m_rooms[i].createSceneNode(i,
+                                            *m_level,
+                                            roomMaterials,
+                                            waterMaterials,
+                                            staticMeshPrototypes,
+                                            spritePrototypes,
+                                            *m_textureAnimator,
+                                            *m_roomBatch,
+                                            instanceBatch,
+                                            m_portalMaterial,
+                                            geometryStats);
         m_renderer->getScene()->addNode(m_level->m_rooms[i].node);
     }
+    m_roomBatch->finalize();
+    instanceBatch.finalize();
+
+    // the batch draws the rooms whose nodes are made visible by the portal tracer, so it must be visited last
+    auto roomBatchNode = std::make_shared<render::scene::Node>("room-batch");
+    roomBatchNode->setDrawable(m_roomBatch);
+    roomBatchNode->addUniformSetter(
+        "u_lightAmbient",
+        [](const render::scene::Node& /*node*/, render::gl::ProgramUniform& uniform) { uniform.set(1.0f); });
+    m_renderer->getScene()->addNode(roomBatchNode);
+    BOOST_LOG_TRIVIAL(info) << "Level geometry uses "
+                            << render::gl::getArrayBufferUploadBytes() - vertexBytesBefore
+                            << " bytes of vertex buffers, " << geometryStats.unpackedBytes
+                            << " bytes in the unpacked float layout";
+    BOOST_LOG_TRIVIAL(info) << "Level geometry has " << geometryStats.vertices << " vertices and "
+                            << geometryStats.indices << " indices, ACMR " << geometryStats.getAcmr();
+    BOOST_LOG_TRIVIAL(info) << "Room static meshes and sprites: " << instanceBatch.getStats().instances
+                            << " placements, " << instanceBatch.getStats().draws << " instanced draws instead of "
+                            << instanceBatch.getStats().meshes;
 
     m_lara = createItems();
     if(m_lara == nullptr)
@@ -600,9 +796,8 @@ void Engine::loadSceneData(bool linearTextureInterpolation)
     for(loader::file::SoundSource& src : m_level->m_soundSources)
     {
         m_positionalEmitters.emplace_back(src.position.toRenderSystem(), &m_audioEngine->m_soundEngine);
-        auto handle = m_audioEngine->playSound(src.sound_id, &m_positionalEmitters.back());
-        Expects(handle != nullptr);
-        handle->setLooping(true);
+        // sources out of the voice budget are kept as virtual voices, so no handle is needed here
+        m_audioEngine->playSound(src.sound_id, &m_positionalEmitters.back(), true);
     }
 }
 
@@ -615,27 +810,27 @@ std::shared_ptr<items::ItemNode> Engine::getItem(const uint16_t id) const
     return it->second.get();
 }
 
-void Engine::drawBars(const gsl::not_null<std::shared_ptr<render::gl::Image<render::gl::SRGBA8>>>& image)
+void Engine::drawBars(render::scene::QuadBatch& batch)
 {
     if(m_lara->isInWater())
     {
         const auto x0 = gsl::narrow<int32_t>(m_window->getViewport().width - 110);
 
         for(int i = 7; i <= 13; ++i)
-            image->line(x0 - 1, i, x0 + 101, i, m_level->m_palette->colors[0].toTextureColor());
-        image->line(x0 - 2, 14, x0 + 102, 14, m_level->m_palette->colors[17].toTextureColor());
-        image->line(x0 + 102, 6, x0 + 102, 14, m_level->m_palette->colors[17].toTextureColor());
-        image->line(x0 + 102, 6, x0 + 102, 14, m_level->m_palette->colors[19].toTextureColor());
-        image->line(x0 - 2, 6, x0 - 2, 14, m_level->m_palette->colors[19].toTextureColor());
+            batch.line(x0 - 1, i, x0 + 101, i, m_level->m_palette->colors[0].toTextureColor());
+        batch.line(x0 - 2, 14, x0 + 102, 14, m_level->m_palette->colors[17].toTextureColor());
+        batch.line(x0 + 102, 6, x0 + 102, 14, m_level->m_palette->colors[17].toTextureColor());
+        batch.line(x0 + 102, 6, x0 + 102, 14, m_level->m_palette->colors[19].toTextureColor());
+        batch.line(x0 - 2, 6, x0 - 2, 14, m_level->m_palette->colors[19].toTextureColor());
 
         const int p = util::clamp(m_lara->getAir() * 100 / core::LaraAir, 0, 100);
         if(p > 0)
         {
-            image->line(x0, 8, x0 + p, 8, m_level->m_palette->colors[32].toTextureColor());
-            image->line(x0, 9, x0 + p, 9, m_level->m_palette->colors[41].toTextureColor());
-            image->line(x0, 10, x0 + p, 10, m_level->m_palette->colors[32].toTextureColor());
-            image->line(x0, 11, x0 + p, 11, m_level->m_palette->colors[19].toTextureColor());
-            image->line(x0, 12, x0 + p, 12, m_level->m_palette->colors[21].toTextureColor());
+            batch.line(x0, 8, x0 + p, 8, m_level->m_palette->colors[32].toTextureColor());
+            batch.line(x0, 9, x0 + p, 9, m_level->m_palette->colors[41].toTextureColor());
+            batch.line(x0, 10, x0 + p, 10, m_level->m_palette->colors[32].toTextureColor());
+            batch.line(x0, 11, x0 + p, 11, m_level->m_palette->colors[19].toTextureColor());
+            batch.line(x0, 12, x0 + p, 12, m_level->m_palette->colors[21].toTextureColor());
         }
     }
 
@@ -657,20 +852,20 @@ void Engine::drawBars(const gsl::not_null<std::shared_ptr<render::gl::Image<rend
 
     const int x0 = 8;
     for(int i = 7; i <= 13; ++i)
-        image->line(x0 - 1, i, x0 + 101, i, m_level->m_palette->colors[0].toTextureColor(alpha), true);
-    image->line(x0 - 2, 14, x0 + 102, 14, m_level->m_palette->colors[17].toTextureColor(alpha), true);
-    image->line(x0 + 102, 6, x0 + 102, 14, m_level->m_palette->colors[17].toTextureColor(alpha), true);
-    image->line(x0 + 102, 6, x0 + 102, 14, m_level->m_palette->colors[19].toTextureColor(alpha), true);
-    image->line(x0 - 2, 6, x0 - 2, 14, m_level->m_palette->colors[19].toTextureColor(alpha), true);
+        batch.line(x0 - 1, i, x0 + 101, i, m_level->m_palette->colors[0].toTextureColor(alpha));
+    batch.line(x0 - 2, 14, x0 + 102, 14, m_level->m_palette->colors[17].toTextureColor(alpha));
+    batch.line(x0 + 102, 6, x0 + 102, 14, m_level->m_palette->colors[17].toTextureColor(alpha));
+    batch.line(x0 + 102, 6, x0 + 102, 14, m_level->m_palette->colors[19].toTextureColor(alpha));
+    batch.line(x0 - 2, 6, x0 - 2, 14, m_level->m_palette->colors[19].toTextureColor(alpha));
 
     const int p = util::clamp(m_lara->m_state.health * 100 / core::LaraHealth, 0, 100);
     if(p > 0)
     {
-        image->line(x0, 8, x0 + p, 8, m_level->m_palette->colors[8].toTextureColor(alpha), true);
-        image->line(x0, 9, x0 + p, 9, m_level->m_palette->colors[11].toTextureColor(alpha), true);
-        image->line(x0, 10, x0 + p, 10, m_level->m_palette->colors[8].toTextureColor(alpha), true);
-        image->line(x0, 11, x0 + p, 11, m_level->m_palette->colors[6].toTextureColor(alpha), true);
-        image->line(x0, 12, x0 + p, 12, m_level->m_palette->colors[24].toTextureColor(alpha), true);
+        batch.line(x0, 8, x0 + p, 8, m_level->m_palette->colors[8].toTextureColor(alpha));
+        batch.line(x0, 9, x0 + p, 9, m_level->m_palette->colors[11].toTextureColor(alpha));
+        batch.line(x0, 10, x0 + p, 10, m_level->m_palette->colors[8].toTextureColor(alpha));
+        batch.line(x0, 11, x0 + p, 11, m_level->m_palette->colors[6].toTextureColor(alpha));
+        batch.line(x0, 12, x0 + p, 12, m_level->m_palette->colors[24].toTextureColor(alpha));
     }
 }
 
@@ -1090,7 +1285,7 @@ std::shared_ptr<items::PickupItem> Engine::createPickup(const core::TypeId type,
 
     auto node = std::make_shared<items::PickupItem>(this, "pickup", room, item, sprite, m_spriteMaterial);
 
-    m_dynamicItems.emplace(node);
+    registerDynamicItem(node);
     addChild(room->node, node->getNode());
 
     return node;
@@ -1126,49 +1321,150 @@ const std::vector<int16_t>& Engine::getAnimCommands() const
 
 void Engine::update(const bool godMode)
 {
-    for(const auto& item : m_itemNodes | boost::adaptors::map_values)
+    util::ProfileZone zone{"update"};
+
+    updateCreaturePaths();
+
     {
-        if(item.get() == m_lara) // Lara is special and needs to be updated last
-            continue;
+        util::ProfileZone itemsZone{"items"};
+        const auto itemsStart = std::chrono::high_resolution_clock::now();
+
+        // items activated while updating are appended, and only updated from the next tick on
+        const auto activeCount = m_activeItems.size();
+        for(size_t i = 0; i < activeCount; ++i)
+        {
+            const auto item = m_activeItems[i];
+            if(item == nullptr || item == m_lara.get()) // Lara is special and needs to be updated last
+                continue;
 
-        if(item->m_isActive)
+            util::ProfileZone itemZone{getProfileZoneName(*item)};
             item->update();
+            item->updateBoundingSphere();
+        }
 
-        item->getNode()->setVisible(item->m_state.triggerState != items::TriggerState::Invisible);
-    }
+        // close the gaps left by deactivated items
+        size_t used = 0;
+        for(const auto item : m_activeItems)
+        {
+            if(item == nullptr)
+                continue;
 
-    for(const auto& item : m_dynamicItems)
-    {
-        if(item->m_isActive)
-            item->update();
+            item->m_activeListIndex = used;
+            m_activeItems[used++] = item;
+        }
+        m_activeItems.resize(used);
 
-        item->getNode()->setVisible(item->m_state.triggerState != items::TriggerState::Invisible);
+        ++m_itemUpdateStats.ticks;
+        m_itemUpdateStats.items += activeCount;
+        m_itemUpdateStats.duration += std::chrono::high_resolution_clock::now() - itemsStart;
     }
 
-    auto currentParticles = std::move(m_particles);
-    for(const auto& particle : currentParticles)
     {
-        if(particle->update(*this))
-        {
-            m_particles.emplace_back(particle);
-            setParent(particle, particle->pos.room->node);
-            particle->updateLight();
-        }
-        else
+        util::ProfileZone particlesZone{"particles"};
+        auto currentParticles = std::move(m_particles);
+        for(const auto& particle : currentParticles)
         {
-            setParent(particle, nullptr);
+            if(particle->update(*this))
+            {
+                m_particles.emplace_back(particle);
+                setParent(particle, particle->pos.room->node);
+                particle->updateLight();
+            }
+            else
+            {
+                setParent(particle, nullptr);
+            }
         }
     }
 
     if(m_lara != nullptr)
     {
+        util::ProfileZone laraZone{"lara"};
         if(godMode)
             m_lara->m_state.health = core::LaraHealth;
         m_lara->update();
+        m_lara->updateBoundingSphere();
     }
 
     applyScheduledDeletions();
-    animateUV();
+
+    {
+        util::ProfileZone textureAnimatorZone{"texture-animator"};
+        animateUV();
+    }
+}
+
+void Engine::registerActiveItem(items::ItemNode& item)
+{
+    Expects(!item.m_activeListIndex.is_initialized());
+    item.m_activeListIndex = m_activeItems.size();
+    m_activeItems.emplace_back(&item);
+}
+
+void Engine::unregisterActiveItem(items::ItemNode& item)
+{
+    Expects(item.m_activeListIndex.is_initialized());
+    m_activeItems.at(*item.m_activeListIndex) = nullptr;
+    item.m_activeListIndex.reset();
+}
+
+void Engine::updateCreaturePaths()
+{
+    util::ProfileZone zone{"ai-think"};
+
+    m_thinkPhase.begin();
+    for(const auto item : m_activeItems)
+    {
+        if(item == nullptr || item->m_state.creatureInfo == nullptr)
+            continue;
+
+        m_thinkPhase.add(item->m_state.creatureInfo->lot);
+    }
+    m_thinkPhase.run(ai::BoxGraph{*this}, m_jobSystem);
+}
+
+void Engine::applyScheduledDeletions()
+{
+    if(m_scheduledDeletions.empty())
+        return;
+
+    // an item may have been scheduled more than once, so the deleted ones are kept alive until all are handled
+    std::vector<std::shared_ptr<items::ItemNode>> deleted;
+    for(const auto item : m_scheduledDeletions)
+    {
+        if(!item->m_dynamicListIndex.is_initialized())
+            continue;
+
+        item->deactivate();
+        deleted.emplace_back(unregisterDynamicItem(*item));
+    }
+
+    m_scheduledDeletions.clear();
+}
+
+void Engine::registerDynamicItem(const std::shared_ptr<items::ItemNode>& item)
+{
+    Expects(!item->m_dynamicListIndex.is_initialized());
+    item->m_dynamicListIndex = m_dynamicItems.size();
+    m_dynamicItems.emplace_back(item);
+    item->updateVisibility();
+}
+
+std::shared_ptr<items::ItemNode> Engine::unregisterDynamicItem(items::ItemNode& item)
+{
+    Expects(item.m_dynamicListIndex.is_initialized());
+    const auto index = *item.m_dynamicListIndex;
+    item.m_dynamicListIndex.reset();
+
+    // move the last item into the gap
+    std::shared_ptr<items::ItemNode> removed = m_dynamicItems[index].get();
+    if(index + 1 != m_dynamicItems.size())
+    {
+        m_dynamicItems[index] = m_dynamicItems.back();
+        m_dynamicItems[index]->m_dynamicListIndex = index;
+    }
+    m_dynamicItems.pop_back();
+    return removed;
 }
 
 void Engine::drawDebugInfo(const gsl::not_null<std::shared_ptr<render::gl::Font>>& font, const float fps)
@@ -1297,6 +1593,28 @@ void Engine::drawDebugInfo(const gsl::not_null<std::shared_ptr<render::gl::Font>
                  + ", Y=" + std::to_string(toDegrees(m_lara->rightArm.aimRotation.Y)));
 }
 
+void Engine::drawProfilerSummary(const gsl::not_null<std::shared_ptr<render::gl::Font>>& font)
+{
+    const auto& profiler = util::Profiler::instance();
+
+    const int x = font->getTarget()->getWidth() - 340;
+    int y = 40;
+    drawText(font, x, y, (boost::format("frame %.2f ms") % (profiler.getLastFrameDuration() / 1e6)).str());
+    y += 20;
+
+    for(const auto& zone : profiler.getLastFrameSummary())
+    {
+        if(y >= font->getTarget()->getHeight() - 40)
+            break;
+
+        drawText(font,
+                 x + zone.depth * 10,
+                 y,
+                 (boost::format("%s %.2f ms (%d)") % zone.name % (zone.total / 1e6) % zone.calls).str());
+        y += 20;
+    }
+}
+
 void Engine::drawText(const gsl::not_null<std::shared_ptr<render::gl::Font>>& font,
                       const int x,
                       const int y,
@@ -1308,7 +1626,8 @@ void Engine::drawText(const gsl::not_null<std::shared_ptr<render::gl::Font>>& fo
 
 Engine::Engine(bool fullscreen, const render::scene::Dimension2<int>& resolution)
     : m_renderer{std::make_unique<render::scene::Renderer>()}
-    , m_window{std::make_unique<render::scene::Window>(fullscreen, resolution)}
+    , m_window{std::make_unique<render::scene::Window>(
+          fullscreen, resolution, bool(m_scriptEngine["graphics"]["debugContext"]))}
     , splashImage{"splash.png"}
     , abibasFont{std::make_shared<render::gl::Font>("abibas.ttf", 48)}
     , m_scriptEngine{createScriptEngine()}
@@ -1320,21 +1639,12 @@ Engine::Engine(bool fullscreen, const render::scene::Dimension2<int>& resolution
     scaleSplashImage();
 
     screenOverlay = std::make_shared<render::scene::ScreenOverlay>(m_window->getViewport());
+    hud = std::make_shared<render::scene::QuadBatch>(m_window->getViewport());
 
-    abibasFont->setTarget(screenOverlay->getImage());
+    abibasFont->setTarget(hud);
 
     drawLoadingScreen("Booting");
 
-    try
-    {
-        m_scriptEngine.safe_script_file("scripts/main.lua");
-    }
-    catch(sol::error& e)
-    {
-        BOOST_LOG_TRIVIAL(fatal) << "Failed to load main.lua: " << e.what();
-        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to load main.lua"));
-    }
-
     const sol::optional<std::string> glidosPack = m_scriptEngine["getGlidosPack"]();
 
     std::unique_ptr<loader::trx::Glidos> glidos;
@@ -1541,7 +1851,8 @@ Engine::Engine(bool fullscreen, const render::scene::Dimension2<int>& resolution
         }
     }
 
-    m_renderPipeline = std::make_shared<render::RenderPipeline>(m_window->getViewport());
+    m_renderPipeline
+        = std::make_shared<render::RenderPipeline>(m_window->getViewport(), getSsaoQuality(m_scriptEngine));
 }
 
 void Engine::run()
@@ -1553,6 +1864,7 @@ void Engine::run()
     render::gl::Framebuffer::unbindAll();
 
     screenOverlay->init(m_window->getViewport());
+    hud->setViewport(m_window->getViewport());
 
     if(const sol::optional<std::string> video = levelInfo["video"])
     {
@@ -1582,11 +1894,12 @@ void Engine::run()
     bool showDebugInfo = false;
 
     auto font = std::make_shared<render::gl::Font>("DroidSansMono.ttf", 12);
-    font->setTarget(screenOverlay->getImage());
+    font->setTarget(hud);
 
-    auto trFont = ui::CachedFont(*m_level->m_spriteSequences.at(TR1ItemId::FontGraphics));
+    const ui::CachedFont trFont{*m_level->m_spriteSequences.at(TR1ItemId::FontGraphics), *hud};
 
     auto nextFrameTime = std::chrono::high_resolution_clock::now() + frameDuration;
+    core::Frame latencyLogFrame = 0_frame;
 
     const bool isCutscene = !levelInfo.get<std::string>("cutscene").empty();
 
@@ -1595,9 +1908,22 @@ void Engine::run()
         m_audioEngine->playStopCdTrack(trackToPlay.value(), false);
     }
 
+    const sol::optional<std::string> profilerTrace = m_scriptEngine["profiler"]["trace"];
+    util::Profiler::setEnabled(bool(m_scriptEngine["profiler"]["enabled"]));
+
+    render::gl::GpuTimer geometryTimer{"geometry-pass"};
+    render::gl::GpuTimer portalTimer{"portal-depth-pass"};
+    render::gl::GpuTimer hudTimer{"hud-pass"};
+
     while(!m_window->windowShouldClose())
     {
-        screenOverlay->getImage()->fill({0, 0, 0, 0});
+        util::Profiler::instance().beginFrame();
+        util::ProfileZone frameZone{"frame"};
+
+        const auto glCallsLastFrame = render::gl::getCallCount();
+        render::gl::resetCallCount();
+
+        hud->clear();
 
         if(!levelName.empty())
         {
@@ -1606,15 +1932,12 @@ void Engine::run()
             tmp.alignY = ui::Label::Alignment::Bottom;
             tmp.outline = true;
             tmp.addBackground(0, 0, 0, 0);
-            tmp.draw(trFont, *screenOverlay->getImage(), *m_level->m_palette);
+            tmp.draw(trFont, *hud, *m_level->m_palette);
         }
 
-        m_audioEngine->m_soundEngine.update();
-        m_inputHandler->update();
-
-        if(m_inputHandler->getInputState().debug.justPressed())
         {
-            showDebugInfo = !showDebugInfo;
+            util::ProfileZone audioZone{"audio"};
+            m_audioEngine->m_soundEngine.update();
         }
 
         {
@@ -1625,38 +1948,67 @@ void Engine::run()
             nextFrameTime += frameDuration;
         }
 
+        // sample input as late as possible, so that events arriving during the throttling above
+        // are seen by this tick instead of the next one
+        m_inputHandler->update();
+
+        if(m_inputHandler->getInputState().debug.justPressed())
+        {
+            showDebugInfo = !showDebugInfo;
+        }
+
+        if(m_inputHandler->getInputState().ssao.justPressed())
+        {
+            m_renderPipeline->setSsaoQuality(getNextSsaoQuality(m_renderPipeline->getSsaoQuality()));
+            BOOST_LOG_TRIVIAL(info) << "SSAO quality: " << getSsaoQualityName(m_renderPipeline->getSsaoQuality());
+        }
+
         update(bool(m_scriptEngine["cheats"]["godMode"]));
 
+        latencyLogFrame += 1_frame;
+        if(latencyLogFrame >= core::FrameRate * 10_sec)
+        {
+            latencyLogFrame = 0_frame;
+            logInputLatency();
+            logRenderQueueStats();
+            logPathSearchStats();
+            logItemUpdateStats();
+        }
+
         if(m_window->updateWindowSize())
         {
             m_renderer->getScene()->getActiveCamera()->setAspectRatio(m_window->getAspectRatio());
             m_renderPipeline->resize(m_window->getViewport());
-            screenOverlay->init(m_window->getViewport());
-            font->setTarget(screenOverlay->getImage());
+            hud->setViewport(m_window->getViewport());
         }
 
         std::unordered_set<const loader::file::Portal*> waterEntryPortals;
-        if(!isCutscene)
         {
-            waterEntryPortals = getCameraController().update();
-        }
-        else
-        {
-            if(++getCameraController().m_cinematicFrame >= m_level->m_cinematicFrames.size())
-                break;
+            util::ProfileZone cameraZone{"camera"};
+            if(!isCutscene)
+            {
+                waterEntryPortals = getCameraController().update();
+            }
+            else
+            {
+                if(++getCameraController().m_cinematicFrame >= m_level->m_cinematicFrames.size())
+                    break;
 
-            waterEntryPortals = m_cameraController->updateCinematic(
-                m_level->m_cinematicFrames[getCameraController().m_cinematicFrame], false);
+                waterEntryPortals = m_cameraController->updateCinematic(
+                    m_level->m_cinematicFrames[getCameraController().m_cinematicFrame], false);
+            }
         }
         doGlobalEffect();
 
         if(m_lara != nullptr)
-            drawBars(screenOverlay->getImage());
+            drawBars(*hud);
 
         m_renderPipeline->update(*getCameraController().getCamera(), m_renderer->getGameTime());
 
         {
+            util::ProfileZone zone{"geometry-pass"};
             render::gl::DebugGroup dbg{"geometry-pass"};
+            render::gl::GpuTimerScope gpuTimer{geometryTimer};
             m_renderPipeline->bindGeometryFrameBuffer();
             m_renderer->render();
         }
@@ -1666,7 +2018,9 @@ void Engine::run()
         context.setCurrentNode(&dummyNode);
 
         {
+            util::ProfileZone zone{"portal-depth-pass"};
             render::gl::DebugGroup dbg{"portal-depth-pass"};
+            render::gl::GpuTimerScope gpuTimer{portalTimer};
             m_renderPipeline->bindPortalFrameBuffer();
             const auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(m_renderer->getGameTime());
             m_portalMaterial->getUniform("u_time")->set(gsl::narrow_cast<float>(now.time_since_epoch().count()));
@@ -1681,6 +2035,35 @@ void Engine::run()
         if(showDebugInfo)
         {
             drawDebugInfo(font, m_renderer->getFrameRate());
+            drawText(font,
+                     font->getTarget()->getWidth() - 140,
+                     font->getTarget()->getHeight() - 40,
+                     std::to_string(glCallsLastFrame) + " gl calls");
+            const auto& queueStats = m_renderer->getRenderQueue().getStats();
+            drawText(font,
+                     font->getTarget()->getWidth() - 280,
+                     font->getTarget()->getHeight() - 20,
+                     std::to_string(queueStats.draws) + " draws, " + std::to_string(queueStats.sorted.programs)
+                         + " programs, " + std::to_string(queueStats.sorted.materials) + " materials");
+            const auto& roomBatchStats = m_roomBatch->getStats();
+            drawText(font,
+                     font->getTarget()->getWidth() - 280,
+                     font->getTarget()->getHeight() - 80,
+                     std::to_string(roomBatchStats.commands) + " room parts in "
+                         + std::to_string(roomBatchStats.draws) + " draws");
+            drawText(font,
+                     font->getTarget()->getWidth() - 280,
+                     font->getTarget()->getHeight() - 100,
+                     std::to_string(m_activeItems.size()) + " of "
+                         + std::to_string(m_itemNodes.size() + m_dynamicItems.size()) + " items active");
+            const auto& cullingStats = m_renderer->getCullingStats();
+            drawText(font,
+                     font->getTarget()->getWidth() - 280,
+                     font->getTarget()->getHeight() - 60,
+                     std::to_string(cullingStats.culled) + " of " + std::to_string(cullingStats.tested)
+                         + " nodes culled");
+            if(util::Profiler::isEnabled())
+                drawProfilerSummary(font);
             for(const auto& ctrl : m_itemNodes | boost::adaptors::map_values)
             {
                 const auto vertex = glm::vec3{m_renderer->getScene()->getActiveCamera()->getViewMatrix()
@@ -1710,15 +2093,16 @@ void Engine::run()
         }
 
         {
-            render::gl::DebugGroup dbg{"screen-overlay-pass"};
-            screenOverlay->render(context);
+            util::ProfileZone zone{"hud-pass"};
+            render::gl::DebugGroup dbg{"hud-pass"};
+            render::gl::GpuTimerScope gpuTimer{hudTimer};
+            hud->render(context);
         }
         m_window->swapBuffers();
 
         if(m_inputHandler->getInputState().save.justPressed())
         {
             scaleSplashImage();
-            abibasFont->setTarget(screenOverlay->getImage());
             drawLoadingScreen("Saving...");
 
             BOOST_LOG_TRIVIAL(info) << "Save";
@@ -1731,7 +2115,6 @@ void Engine::run()
         else if(m_inputHandler->getInputState().load.justPressed())
         {
             scaleSplashImage();
-            abibasFont->setTarget(screenOverlay->getImage());
             drawLoadingScreen("Loading...");
 
             BOOST_LOG_TRIVIAL(info) << "Load";
@@ -1740,6 +2123,72 @@ void Engine::run()
             nextFrameTime = std::chrono::high_resolution_clock::now() + frameDuration;
         }
     }
+
+    if(util::Profiler::isEnabled() && profilerTrace)
+        util::Profiler::instance().writeChromeTrace(profilerTrace.value());
+}
+
+void Engine::logInputLatency()
+{
+    auto& tracker = m_inputHandler->getLatencyTracker();
+    if(tracker.getSampleCount() == 0)
+        return;
+
+    BOOST_LOG_TRIVIAL(debug) << "Input latency (" << tracker.getSampleCount()
+                             << " events): p50=" << tracker.getPercentile(50).count()
+                             << "us, p90=" << tracker.getPercentile(90).count()
+                             << "us, p99=" << tracker.getPercentile(99).count() << "us";
+    tracker.reset();
+}
+
+void Engine::logRenderQueueStats()
+{
+    const auto& stats = m_renderer->getRenderQueue().getStats();
+    if(stats.draws == 0)
+        return;
+
+    BOOST_LOG_TRIVIAL(debug) << "Render queue (" << stats.draws << " draws): " << stats.sorted.programs << " programs, "
+                             << stats.sorted.materials << " materials, " << stats.sorted.states
+                             << " render states; in recording order: " << stats.recorded.programs << " programs, "
+                             << stats.recorded.materials << " materials, " << stats.recorded.states
+                             << " render states";
+}
+
+void Engine::logItemUpdateStats()
+{
+    const auto ticks = std::exchange(m_itemUpdateStats.ticks, 0);
+    const auto items = std::exchange(m_itemUpdateStats.items, 0);
+    const auto duration = std::exchange(m_itemUpdateStats.duration, std::chrono::nanoseconds::zero());
+    if(ticks == 0)
+        return;
+
+    BOOST_LOG_TRIVIAL(debug) << "Item updates (" << ticks << " ticks): "
+                             << std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / ticks
+                             << "us for " << items / ticks << " active items per tick, of "
+                             << m_itemNodes.size() + m_dynamicItems.size() << " items";
+}
+
+void Engine::logPathSearchStats()
+{
+    const auto& histogram = m_thinkPhase.getBudget().getHistogram();
+    const auto ticks = std::accumulate(histogram.begin(), histogram.end(), size_t{0});
+    if(ticks == 0)
+        return;
+
+    std::ostringstream buckets;
+    size_t worst = 0;
+    for(size_t expanded = 0; expanded < histogram.size(); ++expanded)
+    {
+        if(histogram[expanded] == 0)
+            continue;
+
+        worst = expanded;
+        buckets << " " << expanded << ":" << histogram[expanded];
+    }
+
+    BOOST_LOG_TRIVIAL(debug) << "Path searches (" << ticks << " ticks): worst tick " << worst
+                             << " expanded nodes; nodes:ticks" << buckets.str();
+    m_thinkPhase.getBudget().resetHistogram();
 }
 
 void Engine::scaleSplashImage()
@@ -1773,12 +2222,13 @@ void Engine::drawLoadingScreen(const std::string& state)
     {
         m_renderer->getScene()->getActiveCamera()->setAspectRatio(m_window->getAspectRatio());
         screenOverlay->init(m_window->getViewport());
-        abibasFont->setTarget(screenOverlay->getImage());
+        hud->setViewport(m_window->getViewport());
 
         scaleSplashImage();
     }
     screenOverlay->getImage()->assign(reinterpret_cast<const render::gl::SRGBA8*>(splashImageScaled.data()),
                                       m_window->getViewport().width * m_window->getViewport().height);
+    hud->clear();
     abibasFont->drawText(state, 40, gsl::narrow<int>(m_window->getViewport().height - 100), 255, 255, 255, 192);
 
     render::gl::Framebuffer::unbindAll();
@@ -1788,6 +2238,7 @@ void Engine::drawLoadingScreen(const std::string& state)
     render::scene::Node dummyNode{""};
     context.setCurrentNode(&dummyNode);
     screenOverlay->render(context);
+    hud->render(context);
     m_window->swapBuffers();
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ai/thinkphase.h"
 #include "audioengine.h"
 #include "cameracontroller.h"
 #include "floordata/floordata.h"
@@ -8,9 +9,12 @@
 #include "loader/file/animationid.h"
 #include "loader/file/item.h"
 #include "render/scene/ScreenOverlay.h"
+#include "render/scene/quadbatch.h"
 #include "util/cimgwrapper.h"
+#include "util/jobsystem.h"
 
 #include <boost/filesystem/path.hpp>
+#include <chrono>
 #include <memory>
 
 namespace hid
@@ -49,10 +53,16 @@ class Font;
 }
 
 class RenderPipeline;
+class RoomBatch;
 } // namespace render
 
 namespace engine
 {
+namespace ai
+{
+struct LotInfo;
+}
+
 namespace items
 {
 class ItemNode;
@@ -75,9 +85,24 @@ private:
 
     std::map<uint16_t, gsl::not_null<std::shared_ptr<items::ItemNode>>> m_itemNodes;
 
-    std::set<gsl::not_null<std::shared_ptr<items::ItemNode>>> m_dynamicItems;
+    //! Items spawned while playing, in no particular order; each item knows its slot, so it's removed in O(1).
+    std::vector<gsl::not_null<std::shared_ptr<items::ItemNode>>> m_dynamicItems;
+
+    //! May contain items more than once, and items not in #m_dynamicItems, which are not deleted.
+    std::vector<items::ItemNode*> m_scheduledDeletions;
+
+    //! Items to be updated each tick in activation order; deactivated items leave gaps until the end of the tick.
+    std::vector<items::ItemNode*> m_activeItems;
+
+    struct ItemUpdateStats
+    {
+        size_t ticks = 0;
+        //! Sum of the active items over all ticks.
+        size_t items = 0;
+        std::chrono::nanoseconds duration{0};
+    };
 
-    std::set<items::ItemNode*> m_scheduledDeletions;
+    ItemUpdateStats m_itemUpdateStats;
 
     std::vector<gsl::not_null<std::shared_ptr<render::scene::Model>>> m_models;
 
@@ -91,12 +116,20 @@ private:
 
     std::shared_ptr<render::TextureAnimator> m_textureAnimator;
 
+    std::shared_ptr<render::RoomBatch> m_roomBatch;
+
     std::unique_ptr<hid::InputHandler> m_inputHandler;
 
     bool m_roomsAreSwapped = false;
 
     std::vector<gsl::not_null<std::shared_ptr<Particle>>> m_particles;
 
+    //! Shared by the path searches of all creatures; up to six creatures still get the original depth of 5 nodes.
+    ai::ThinkPhase m_thinkPhase{32};
+
+    //! Shared executor for all work the engine spreads across threads.
+    util::JobSystem m_jobSystem{std::max(1u, std::thread::hardware_concurrency())};
+
     // list of meshes and models, resolved through m_meshIndices
     std::vector<gsl::not_null<std::shared_ptr<render::scene::Model>>> m_modelsDirect;
     std::vector<gsl::not_null<const loader::file::Mesh*>> m_meshesDirect;
@@ -105,7 +138,10 @@ private:
     std::shared_ptr<render::scene::Material> m_portalMaterial{nullptr};
 
     std::shared_ptr<render::RenderPipeline> m_renderPipeline;
+    //! Full-screen images, i.e. the splash screen and videos.
     std::shared_ptr<render::scene::ScreenOverlay> screenOverlay;
+    //! Everything drawn on top of the scene, i.e. bars, labels and debug text.
+    std::shared_ptr<render::scene::QuadBatch> hud;
     std::unique_ptr<render::scene::Renderer> m_renderer;
     std::unique_ptr<render::scene::Window> m_window;
     sol::table levelInfo;
@@ -178,6 +214,11 @@ public:
         return m_itemNodes;
     }
 
+    ai::ThinkPhase& getThinkPhase()
+    {
+        return m_thinkPhase;
+    }
+
     const auto& getDynamicItems() const
     {
         return m_dynamicItems;
@@ -233,6 +274,11 @@ public:
         return m_inventory;
     }
 
+    auto& getJobSystem()
+    {
+        return m_jobSystem;
+    }
+
     bool hasLevel() const
     {
         return m_level != nullptr;
@@ -275,7 +321,7 @@ public:
 
         auto node = std::make_shared<T>(this, room, item, *model);
 
-        m_dynamicItems.emplace(node);
+        registerDynamicItem(node);
         addChild(room->node, node->getNode());
 
         return node;
@@ -290,7 +336,7 @@ public:
 
     std::shared_ptr<items::ItemNode> getItem(uint16_t id) const;
 
-    void drawBars(const gsl::not_null<std::shared_ptr<render::gl::Image<render::gl::SRGBA8>>>& image);
+    void drawBars(render::scene::QuadBatch& batch);
 
     void useAlternativeLaraAppearance(bool withHead = false);
 
@@ -299,28 +345,24 @@ public:
         return m_models.at(idx);
     }
 
+    void registerActiveItem(items::ItemNode& item);
+
+    void unregisterActiveItem(items::ItemNode& item);
+
     void scheduleDeletion(items::ItemNode* item)
     {
-        m_scheduledDeletions.insert(item);
+        m_scheduledDeletions.emplace_back(item);
     }
 
-    void applyScheduledDeletions()
-    {
-        if(m_scheduledDeletions.empty())
-            return;
+    void applyScheduledDeletions();
 
-        for(const auto& del : m_scheduledDeletions)
-        {
-            auto it = std::find_if(m_dynamicItems.begin(),
-                                   m_dynamicItems.end(),
-                                   [del](const std::shared_ptr<items::ItemNode>& i) { return i.get() == del; });
-            if(it == m_dynamicItems.end())
-                continue;
-            m_dynamicItems.erase(it);
-        }
+    void registerDynamicItem(const std::shared_ptr<items::ItemNode>& item);
 
-        m_scheduledDeletions.clear();
-    }
+    //! Removes the item from the dynamic items, returning the reference held so far.
+    std::shared_ptr<items::ItemNode> unregisterDynamicItem(items::ItemNode& item);
+
+    //! Advances the path searches of all active creatures on the worker pool, see ai::ThinkPhase.
+    void updateCreaturePaths();
 
     void turn180Effect(items::ItemNode& node);
 
@@ -447,8 +489,21 @@ public:
 
     void drawDebugInfo(const gsl::not_null<std::shared_ptr<render::gl::Font>>& font, float fps);
 
+    void drawProfilerSummary(const gsl::not_null<std::shared_ptr<render::gl::Font>>& font);
+
     void scaleSplashImage();
 
+    void logInputLatency();
+
+    //! Logs the state changes of the last render queue submission, compared to issuing the draws unsorted.
+    void logRenderQueueStats();
+
+    //! Logs the average time spent updating the items per tick, and the number of active items.
+    void logItemUpdateStats();
+
+    //! Logs how many box graph nodes the creature path searches expanded per tick since the last call.
+    void logPathSearchStats();
+
     void drawLoadingScreen(const std::string& state);
     ;
 
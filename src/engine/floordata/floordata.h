@@ -9,8 +9,21 @@
 #include <vector>
 #include <yaml-cpp/yaml.h>
 
+namespace loader
+{
+namespace file
+{
+struct Camera;
+}
+} // namespace loader
+
 namespace engine
 {
+namespace items
+{
+class ItemNode;
+}
+
 namespace floordata
 {
 struct FloorDataChunk
@@ -230,32 +243,192 @@ private:
     }
 };
 
-inline boost::optional<uint8_t> getPortalTarget(const FloorDataValue* fdData)
+//! A command of a command sequence, with its parameters decoded.
+struct TriggerCommand
 {
-    if(fdData == nullptr)
-        return {};
-
-    FloorDataChunk chunk{fdData[0]};
-    if(chunk.type == FloorDataChunkType::FloorSlant)
+    explicit TriggerCommand(const Command& command)
+        : opcode{command.opcode}
+        , parameter{command.parameter}
     {
-        if(chunk.isLast)
-            return {};
-        fdData += 2;
-        chunk = FloorDataChunk{fdData[0]};
     }
-    if(chunk.type == FloorDataChunkType::CeilingSlant)
+
+    CommandOpcode opcode;
+    uint16_t parameter;
+    //! The parameters following a CommandOpcode::SwitchCamera command.
+    boost::optional<CameraParameters> cameraParameters;
+    //! The item of a CommandOpcode::Activate or CommandOpcode::LookAt command, resolved by the engine; @c nullptr
+    //! if the item doesn't exist, which is only tolerated by CommandOpcode::LookAt.
+    //! @note Items are never removed from the engine's item map, so the pointer stays valid.
+    items::ItemNode* item = nullptr;
+    //! The sink of a CommandOpcode::UnderwaterCurrent command, resolved by the engine.
+    const loader::file::Camera* sink = nullptr;
+};
+
+//! A command sequence, decoded into its condition and commands.
+struct Trigger
+{
+    //! @param fd The command sequence's chunk header.
+    explicit Trigger(const FloorDataValue* fd)
+        : condition{FloorDataChunk{fd[0]}.sequenceCondition}
+        , activationRequest{fd[1]}
     {
-        if(chunk.isLast)
-            return {};
-        fdData += 2;
-        chunk = FloorDataChunk{fdData[0]};
+        fd += 2;
+
+        switch(condition)
+        {
+        case SequenceCondition::ItemActivated:
+        case SequenceCondition::KeyUsed:
+        case SequenceCondition::ItemPickedUp: conditionItemId = Command{*fd++}.parameter; break;
+        default: break;
+        }
+
+        while(true)
+        {
+            const Command command{*fd++};
+            commands.emplace_back(command);
+            if(command.opcode == CommandOpcode::SwitchCamera)
+            {
+                commands.back().cameraParameters.emplace(*fd++);
+                command.isLast = commands.back().cameraParameters->isLast;
+            }
+
+            if(command.isLast)
+                break;
+        }
     }
-    if(chunk.type == FloorDataChunkType::PortalSector)
+
+    SequenceCondition condition;
+    ActivationState activationRequest;
+    //! The switch, key hole or pick-up the condition depends on.
+    boost::optional<uint16_t> conditionItemId;
+    //! The item of #conditionItemId, resolved by the engine like TriggerCommand::item.
+    items::ItemNode* conditionItem = nullptr;
+    std::vector<TriggerCommand> commands;
+};
+
+/**
+ * @brief The parts of a sector's floor data needed for height queries, portal lookups and triggers.
+ *
+ * @details
+ * The floor data is decoded once when loading the level, and shared by all sectors using the same floor data, so
+ * that queries don't need to walk the raw chunks again.
+ */
+struct DecodedFloorData
+{
+    //! Raw slant values of a floor or a ceiling, in quarter sectors across the sector.
+    struct Slant
     {
-        return gsl::narrow_cast<uint8_t>(fdData[1].get());
+        int8_t x;
+        int8_t z;
+    };
+
+    boost::optional<Slant> floorSlant;
+    boost::optional<Slant> ceilingSlant;
+    boost::optional<uint8_t> portalTarget;
+    //! Whether the sector is deadly, e.g. lava.
+    bool isDeath = false;
+    //! The command sequence handled when Lara or a heavy item is in the sector.
+    boost::optional<Trigger> trigger;
+    //! The parameters of all activation commands, i.e. the items which may patch the floor or ceiling height.
+    std::vector<uint16_t> activatedItems;
+    //! The items of #activatedItems, resolved by the engine once the items are created; these are always items
+    //! placed in the level, never items created at runtime.
+    std::vector<const items::ItemNode*> patchingItems;
+
+    explicit DecodedFloorData(const FloorDataValue* fd)
+    {
+        Expects(fd != nullptr);
+
+        // the last death chunk, or the first command sequence
+        const FloorDataValue* lastCommandSequenceOrDeath = nullptr;
+        // a floor slant is recognized anywhere, but a ceiling slant only as the first chunk or directly after a
+        // leading floor slant, and a portal only directly after these leading slants
+        enum class Leading
+        {
+            Nothing,
+            FloorSlant,
+            CeilingSlant,
+            Other
+        };
+        Leading leading = Leading::Nothing;
+        while(true)
+        {
+            const FloorDataChunk chunkHeader{*fd++};
+            switch(chunkHeader.type)
+            {
+            case FloorDataChunkType::FloorSlant:
+                floorSlant = extractSlant(*fd++);
+                leading = leading == Leading::Nothing ? Leading::FloorSlant : Leading::Other;
+                break;
+            case FloorDataChunkType::CeilingSlant:
+                if(leading == Leading::Nothing || leading == Leading::FloorSlant)
+                {
+                    ceilingSlant = extractSlant(*fd);
+                    leading = Leading::CeilingSlant;
+                }
+                else
+                {
+                    leading = Leading::Other;
+                }
+                ++fd;
+                break;
+            case FloorDataChunkType::PortalSector:
+                if(leading != Leading::Other)
+                    portalTarget = gsl::narrow_cast<uint8_t>(fd->get());
+                leading = Leading::Other;
+                ++fd;
+                break;
+            case FloorDataChunkType::Death:
+                lastCommandSequenceOrDeath = fd - 1;
+                leading = Leading::Other;
+                break;
+            case FloorDataChunkType::CommandSequence:
+                if(lastCommandSequenceOrDeath == nullptr)
+                    lastCommandSequenceOrDeath = fd - 1;
+                leading = Leading::Other;
+                ++fd;
+                while(true)
+                {
+                    const Command command{*fd++};
+
+                    if(command.opcode == CommandOpcode::Activate)
+                        activatedItems.emplace_back(command.parameter);
+                    else if(command.opcode == CommandOpcode::SwitchCamera)
+                        command.isLast = CameraParameters{*fd++}.isLast;
+
+                    if(command.isLast)
+                        break;
+                }
+                break;
+            default: leading = Leading::Other; break;
+            }
+            if(chunkHeader.isLast)
+                break;
+        }
+
+        if(lastCommandSequenceOrDeath == nullptr)
+            return;
+
+        // a death chunk may be followed by the command sequence to handle
+        const FloorDataChunk chunkHeader{*lastCommandSequenceOrDeath};
+        if(chunkHeader.type == FloorDataChunkType::Death)
+        {
+            isDeath = true;
+            if(chunkHeader.isLast)
+                return;
+
+            ++lastCommandSequenceOrDeath;
+        }
+
+        if(FloorDataChunk::extractType(*lastCommandSequenceOrDeath) == FloorDataChunkType::CommandSequence)
+            trigger.emplace(lastCommandSequenceOrDeath);
     }
 
-    return {};
-}
+private:
+    static Slant extractSlant(const FloorDataValue fd)
+    {
+        return Slant{gsl::narrow_cast<int8_t>(fd.get() & 0xff), gsl::narrow_cast<int8_t>((fd.get() >> 8) & 0xff)};
+    }
+};
 } // namespace floordata
 } // namespace engine
@@ -0,0 +1,642 @@
+#define BOOST_TEST_MODULE floordata_test
+
+#include "floordata.h"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+
+gsl_api void gsl::fail_fast_assert_handler(char const* const /*expression*/,
+                                           char const* const message,
+                                           char const* const /*file*/,
+                                           int /*line*/)
+{
+    throw gsl::fail_fast(message);
+}
+
+using namespace engine::floordata;
+
+namespace
+{
+/**
+ * @brief The results of the chunk walkers which were run on every query before the floor data was decoded.
+ *
+ * @details
+ * The walkers below are the ones of HeightInfo::fromFloor, HeightInfo::fromCeiling and getPortalTarget, with the
+ * height calculations and item patches replaced by recording the values they used.
+ */
+struct WalkedFloorData
+{
+    boost::optional<DecodedFloorData::Slant> floorSlant;
+    boost::optional<DecodedFloorData::Slant> ceilingSlant;
+    boost::optional<uint8_t> portalTarget;
+    const FloorDataValue* lastCommandSequenceOrDeath = nullptr;
+    //! The items patching the floor.
+    std::vector<uint16_t> floorItems;
+    //! The items patching the ceiling.
+    std::vector<uint16_t> ceilingItems;
+};
+
+DecodedFloorData::Slant extractSlant(const FloorDataValue fd)
+{
+    return DecodedFloorData::Slant{gsl::narrow_cast<int8_t>(fd.get() & 0xff),
+                                   gsl::narrow_cast<int8_t>((fd.get() >> 8) & 0xff)};
+}
+
+void walkFloor(const FloorDataValue* fd, WalkedFloorData& walked)
+{
+    while(true)
+    {
+        const FloorDataChunk chunkHeader{*fd++};
+        switch(chunkHeader.type)
+        {
+        case FloorDataChunkType::FloorSlant:
+            walked.floorSlant = extractSlant(*fd);
+            // Fall-through
+        case FloorDataChunkType::CeilingSlant:
+        case FloorDataChunkType::PortalSector: ++fd; break;
+        case FloorDataChunkType::Death: walked.lastCommandSequenceOrDeath = fd - 1; break;
+        case FloorDataChunkType::CommandSequence:
+            if(walked.lastCommandSequenceOrDeath == nullptr)
+                walked.lastCommandSequenceOrDeath = fd - 1;
+            ++fd;
+            while(true)
+            {
+                const Command command{*fd++};
+
+                if(command.opcode == CommandOpcode::Activate)
+                    walked.floorItems.emplace_back(command.parameter);
+                else if(command.opcode == CommandOpcode::SwitchCamera)
+                    command.isLast = CameraParameters{*fd++}.isLast;
+
+                if(command.isLast)
+                    break;
+            }
+            break;
+        default: break;
+        }
+        if(chunkHeader.isLast)
+            break;
+    }
+}
+
+void walkCeiling(const FloorDataValue* fd, WalkedFloorData& walked)
+{
+    // the next chunk header is read even if a leading floor slant is the last chunk; the streams are followed by a
+    // padding value which isn't a valid chunk type, so that this yields no ceiling slant as the decoded data does
+    const FloorDataValue* slantFd = fd;
+    FloorDataChunk chunkHeader{*slantFd++};
+    if(chunkHeader.type == FloorDataChunkType::FloorSlant)
+    {
+        ++slantFd;
+        chunkHeader = FloorDataChunk{*slantFd++};
+    }
+    if(chunkHeader.type == FloorDataChunkType::CeilingSlant)
+        walked.ceilingSlant = extractSlant(*slantFd);
+
+    while(true)
+    {
+        const FloorDataChunk header{*fd++};
+        switch(header.type)
+        {
+        case FloorDataChunkType::CeilingSlant:
+        case FloorDataChunkType::FloorSlant:
+        case FloorDataChunkType::PortalSector: ++fd; break;
+        case FloorDataChunkType::Death: break;
+        case FloorDataChunkType::CommandSequence:
+            ++fd;
+            while(true)
+            {
+                const Command command{*fd++};
+
+                if(command.opcode == CommandOpcode::Activate)
+                    walked.ceilingItems.emplace_back(command.parameter);
+                else if(command.opcode == CommandOpcode::SwitchCamera)
+                    command.isLast = CameraParameters{*fd++}.isLast;
+
+                if(command.isLast)
+                    break;
+            }
+            break;
+        default: break;
+        }
+        if(header.isLast)
+            break;
+    }
+}
+
+boost::optional<uint8_t> getPortalTarget(const FloorDataValue* fdData)
+{
+    FloorDataChunk chunk{fdData[0]};
+    if(chunk.type == FloorDataChunkType::FloorSlant)
+    {
+        if(chunk.isLast)
+            return {};
+        fdData += 2;
+        chunk = FloorDataChunk{fdData[0]};
+    }
+    if(chunk.type == FloorDataChunkType::CeilingSlant)
+    {
+        if(chunk.isLast)
+            return {};
+        fdData += 2;
+        chunk = FloorDataChunk{fdData[0]};
+    }
+    if(chunk.type == FloorDataChunkType::PortalSector)
+        return gsl::narrow_cast<uint8_t>(fdData[1].get());
+
+    return {};
+}
+
+WalkedFloorData walk(const FloorDataValue* fd)
+{
+    WalkedFloorData walked;
+    walkFloor(fd, walked);
+    walkCeiling(fd, walked);
+    walked.portalTarget = getPortalTarget(fd);
+    return walked;
+}
+
+bool operator==(const DecodedFloorData::Slant& a, const DecodedFloorData::Slant& b)
+{
+    return a.x == b.x && a.z == b.z;
+}
+
+template<typename T>
+void checkOptional(const boost::optional<T>& decoded, const boost::optional<T>& walked)
+{
+    BOOST_REQUIRE_EQUAL(decoded.is_initialized(), walked.is_initialized());
+    if(walked.is_initialized())
+        BOOST_CHECK(*decoded == *walked);
+}
+
+/**
+ * @brief Follows @a floorData the way LaraNode::handleCommandSequence did, and compares it with @a decoded.
+ * @return The number of commands compared.
+ */
+size_t checkTrigger(const FloorDataValue* floorData, const DecodedFloorData& decoded)
+{
+    if(floorData == nullptr)
+    {
+        BOOST_CHECK(!decoded.isDeath);
+        BOOST_CHECK(!decoded.trigger.is_initialized());
+        return 0;
+    }
+
+    FloorDataChunk chunkHeader{*floorData};
+    BOOST_CHECK_EQUAL(decoded.isDeath, chunkHeader.type == FloorDataChunkType::Death);
+    if(chunkHeader.type == FloorDataChunkType::Death)
+    {
+        if(chunkHeader.isLast)
+        {
+            BOOST_CHECK(!decoded.trigger.is_initialized());
+            return 0;
+        }
+
+        ++floorData;
+    }
+
+    chunkHeader = FloorDataChunk{*floorData++};
+    if(chunkHeader.type != FloorDataChunkType::CommandSequence)
+    {
+        // this was an assertion failure
+        BOOST_CHECK(!decoded.trigger.is_initialized());
+        return 0;
+    }
+
+    BOOST_REQUIRE(decoded.trigger.is_initialized());
+    const auto& trigger = *decoded.trigger;
+    BOOST_CHECK(trigger.condition == chunkHeader.sequenceCondition);
+
+    const ActivationState activationRequest{*floorData++};
+    BOOST_CHECK(trigger.activationRequest.getActivationSet() == activationRequest.getActivationSet());
+    BOOST_CHECK_EQUAL(trigger.activationRequest.isOneshot(), activationRequest.isOneshot());
+    BOOST_CHECK_EQUAL(trigger.activationRequest.isInverted(), activationRequest.isInverted());
+    BOOST_CHECK_EQUAL(trigger.activationRequest.isLocked(), activationRequest.isLocked());
+    BOOST_CHECK(trigger.activationRequest.getTimeout() == activationRequest.getTimeout());
+
+    switch(chunkHeader.sequenceCondition)
+    {
+    case SequenceCondition::ItemActivated:
+    case SequenceCondition::KeyUsed:
+    case SequenceCondition::ItemPickedUp:
+        BOOST_REQUIRE(trigger.conditionItemId.is_initialized());
+        BOOST_CHECK_EQUAL(*trigger.conditionItemId, Command{*floorData++}.parameter);
+        break;
+    default: BOOST_CHECK(!trigger.conditionItemId.is_initialized()); break;
+    }
+
+    auto decodedCommand = trigger.commands.begin();
+    while(true)
+    {
+        BOOST_REQUIRE(decodedCommand != trigger.commands.end());
+
+        const Command command{*floorData++};
+        BOOST_CHECK(decodedCommand->opcode == command.opcode);
+        BOOST_CHECK_EQUAL(decodedCommand->parameter, command.parameter);
+        if(command.opcode == CommandOpcode::SwitchCamera)
+        {
+            const CameraParameters camParams{*floorData++};
+            command.isLast = camParams.isLast;
+
+            BOOST_REQUIRE(decodedCommand->cameraParameters.is_initialized());
+            BOOST_CHECK(decodedCommand->cameraParameters->timeout == camParams.timeout);
+            BOOST_CHECK_EQUAL(decodedCommand->cameraParameters->oneshot, camParams.oneshot);
+            BOOST_CHECK_EQUAL(decodedCommand->cameraParameters->isLast, camParams.isLast);
+            BOOST_CHECK_EQUAL(decodedCommand->cameraParameters->smoothness, camParams.smoothness);
+        }
+        else
+        {
+            BOOST_CHECK(!decodedCommand->cameraParameters.is_initialized());
+        }
+
+        ++decodedCommand;
+        if(command.isLast)
+            break;
+    }
+    BOOST_CHECK(decodedCommand == trigger.commands.end());
+    return trigger.commands.size();
+}
+
+void checkEquivalence(const FloorDataValue* fd)
+{
+    const DecodedFloorData decoded{fd};
+    const auto walked = walk(fd);
+
+    checkOptional(decoded.floorSlant, walked.floorSlant);
+    checkOptional(decoded.ceilingSlant, walked.ceilingSlant);
+    checkOptional(decoded.portalTarget, walked.portalTarget);
+    BOOST_CHECK_EQUAL_COLLECTIONS(decoded.activatedItems.begin(),
+                                  decoded.activatedItems.end(),
+                                  walked.floorItems.begin(),
+                                  walked.floorItems.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(decoded.activatedItems.begin(),
+                                  decoded.activatedItems.end(),
+                                  walked.ceilingItems.begin(),
+                                  walked.ceilingItems.end());
+    checkTrigger(walked.lastCommandSequenceOrDeath, decoded);
+}
+
+//! Creates random floor data in the layout of the original levels, with occasional chunks out of order.
+class FloorDataGenerator
+{
+public:
+    explicit FloorDataGenerator(const uint32_t seed)
+        : m_random{seed}
+    {
+    }
+
+    FloorData create()
+    {
+        FloorData data;
+        std::vector<size_t> headers;
+
+        const auto addChunk = [&data, &headers](const FloorDataChunkType type, const uint16_t flags) {
+            headers.emplace_back(data.size());
+            data.emplace_back(static_cast<uint16_t>(static_cast<uint16_t>(type) | flags));
+        };
+
+        // slants and portals are usually at the start, in this order
+        const bool shuffled = chance(10);
+        std::vector<FloorDataChunkType> leading;
+        if(chance(40))
+            leading.emplace_back(FloorDataChunkType::FloorSlant);
+        if(chance(30))
+            leading.emplace_back(FloorDataChunkType::CeilingSlant);
+        if(chance(20))
+            leading.emplace_back(FloorDataChunkType::PortalSector);
+        if(shuffled)
+            std::shuffle(leading.begin(), leading.end(), m_random);
+
+        for(const auto type : leading)
+        {
+            addChunk(type, 0);
+            if(type == FloorDataChunkType::PortalSector)
+                data.emplace_back(static_cast<uint16_t>(uniform(0, 255)));
+            else
+                data.emplace_back(static_cast<uint16_t>(uniform(0, 0xffff)));
+        }
+
+        if(chance(10))
+            addChunk(FloorDataChunkType::Death, 0);
+        for(int i = uniform(0, 2); i > 0; --i)
+            addCommandSequence(data, headers);
+        if(chance(5))
+            addChunk(FloorDataChunkType::Death, 0);
+        if(chance(5))
+            addChunk(FloorDataChunkType::Climb, 0);
+
+        if(headers.empty())
+            addChunk(FloorDataChunkType::Death, 0);
+        data[headers.back()] = static_cast<uint16_t>(data[headers.back()].get() | 0x8000u);
+
+        // walking a leading floor slant which is the last chunk reads one value beyond the chunks
+        data.emplace_back(uint16_t{0});
+        return data;
+    }
+
+private:
+    std::mt19937 m_random;
+
+    int uniform(const int min, const int max)
+    {
+        return std::uniform_int_distribution<int>{min, max}(m_random);
+    }
+
+    bool chance(const int percent)
+    {
+        return uniform(0, 99) < percent;
+    }
+
+    void addCommandSequence(FloorData& data, std::vector<size_t>& headers)
+    {
+        const auto condition = static_cast<uint16_t>(uniform(0, 9));
+        headers.emplace_back(data.size());
+        data.emplace_back(static_cast<uint16_t>(static_cast<uint16_t>(FloorDataChunkType::CommandSequence)
+                                                | (condition << 8u)));
+        // activation request
+        data.emplace_back(static_cast<uint16_t>(uniform(0, 0xffff)));
+
+        const auto conditionType = static_cast<SequenceCondition>(condition);
+        if(conditionType == SequenceCondition::ItemActivated || conditionType == SequenceCondition::KeyUsed
+           || conditionType == SequenceCondition::ItemPickedUp)
+        {
+            data.emplace_back(static_cast<uint16_t>(uniform(0, 0x3ff)));
+        }
+
+        for(int i = uniform(1, 5); i > 0; --i)
+        {
+            const auto opcode = static_cast<uint16_t>(uniform(0, 10));
+            // the last flag of a camera switch is taken from its parameters, so set it randomly on the command
+            const bool isLast = i == 1;
+            uint16_t command = static_cast<uint16_t>((opcode << 10u) | uniform(0, 0x3ff));
+            if(static_cast<CommandOpcode>(opcode) == CommandOpcode::SwitchCamera)
+            {
+                if(chance(50))
+                    command |= 0x8000u;
+                data.emplace_back(command);
+                data.emplace_back(static_cast<uint16_t>((isLast ? 0x8000u : 0u) | uniform(0, 0x7fff)));
+            }
+            else
+            {
+                if(isLast)
+                    command |= 0x8000u;
+                data.emplace_back(command);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Reads the floor data of a TR1 level, and the indices into it used by its sectors.
+ *
+ * @details
+ * Only the parts needed to locate the floor data are parsed, so that the test doesn't depend on the level loader.
+ */
+bool readLevelFloorData(const std::string& filename, FloorData& floorData, std::vector<size_t>& sectorIndices)
+{
+    std::ifstream file{filename, std::ios::binary};
+    if(!file.is_open())
+        return false;
+
+    const auto readU16 = [&file]() {
+        uint8_t bytes[2];
+        file.read(reinterpret_cast<char*>(bytes), 2);
+        return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8u));
+    };
+    const auto readU32 = [&readU16]() {
+        const uint32_t low = readU16();
+        return low | (uint32_t{readU16()} << 16u);
+    };
+    const auto skip = [&file](const std::streamoff bytes) { file.seekg(bytes, std::ios::cur); };
+
+    BOOST_REQUIRE_EQUAL(readU32(), 0x20u);
+    skip(std::streamoff{readU32()} * 256 * 256);
+    skip(4);
+
+    const auto rooms = readU16();
+    for(uint16_t room = 0; room < rooms; ++room)
+    {
+        skip(16);
+        skip(std::streamoff{readU32()} * 2); // geometry
+        skip(std::streamoff{readU16()} * 32); // portals
+        const auto sectorCountZ = readU16();
+        const auto sectorCountX = readU16();
+        for(int i = 0; i < sectorCountZ * sectorCountX; ++i)
+        {
+            const auto floorDataIndex = readU16();
+            if(floorDataIndex != 0)
+                sectorIndices.emplace_back(floorDataIndex);
+            skip(6);
+        }
+        skip(2); // ambient darkness
+        skip(std::streamoff{readU16()} * 18); // lights
+        skip(std::streamoff{readU16()} * 18); // static meshes
+        skip(4); // alternate room and flags
+    }
+
+    floorData.resize(readU32());
+    for(auto& value : floorData)
+        value = readU16();
+
+    return file.good();
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(floordata_tests)
+
+BOOST_AUTO_TEST_CASE(test_random_floor_data_equivalence)
+{
+    FloorDataGenerator generator{4711};
+    for(int i = 0; i < 20000; ++i)
+    {
+        const auto data = generator.create();
+        BOOST_TEST_CONTEXT("stream " << i)
+        {
+            checkEquivalence(data.data());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_slants_and_portal)
+{
+    // a floor slant, a ceiling slant and a portal in their usual order
+    const FloorData data{uint16_t{0x0002}, uint16_t{0xfe03}, uint16_t{0x0003}, uint16_t{0x0201},
+                         uint16_t{0x8001}, uint16_t{0x0007}};
+    const DecodedFloorData decoded{data.data()};
+    BOOST_REQUIRE(decoded.floorSlant.is_initialized());
+    BOOST_CHECK_EQUAL(decoded.floorSlant->x, 3);
+    BOOST_CHECK_EQUAL(decoded.floorSlant->z, -2);
+    BOOST_REQUIRE(decoded.ceilingSlant.is_initialized());
+    BOOST_CHECK_EQUAL(decoded.ceilingSlant->x, 1);
+    BOOST_CHECK_EQUAL(decoded.ceilingSlant->z, 2);
+    BOOST_REQUIRE(decoded.portalTarget.is_initialized());
+    BOOST_CHECK_EQUAL(*decoded.portalTarget, 7);
+    BOOST_CHECK(!decoded.isDeath);
+    BOOST_CHECK(!decoded.trigger.is_initialized());
+    checkEquivalence(data.data());
+}
+
+BOOST_AUTO_TEST_CASE(test_out_of_order_chunks_are_ignored)
+{
+    // a ceiling slant and a portal after a command sequence were never used by the chunk walkers
+    const FloorData data{uint16_t{0x0004},
+                         uint16_t{0x0000},
+                         uint16_t{0x8000 | 0x0005},
+                         uint16_t{0x0003},
+                         uint16_t{0x0101},
+                         uint16_t{0x8001},
+                         uint16_t{0x0002},
+                         uint16_t{0x0000}};
+    const DecodedFloorData decoded{data.data()};
+    BOOST_CHECK(!decoded.ceilingSlant.is_initialized());
+    BOOST_CHECK(!decoded.portalTarget.is_initialized());
+    BOOST_REQUIRE_EQUAL(decoded.activatedItems.size(), 1u);
+    BOOST_CHECK_EQUAL(decoded.activatedItems[0], 5);
+    checkEquivalence(data.data());
+}
+
+BOOST_AUTO_TEST_CASE(test_death_followed_by_command_sequence)
+{
+    const FloorData data{uint16_t{0x0005}, uint16_t{0x8004}, uint16_t{0x3e00}, uint16_t{0x8000 | (6u << 10u) | 12u}};
+    const DecodedFloorData decoded{data.data()};
+    BOOST_CHECK(decoded.isDeath);
+    BOOST_REQUIRE(decoded.trigger.is_initialized());
+    BOOST_CHECK(decoded.trigger->condition == SequenceCondition::LaraIsHere);
+    BOOST_CHECK(decoded.trigger->activationRequest.isFullyActivated());
+    BOOST_REQUIRE_EQUAL(decoded.trigger->commands.size(), 1u);
+    BOOST_CHECK(decoded.trigger->commands[0].opcode == CommandOpcode::LookAt);
+    BOOST_CHECK_EQUAL(decoded.trigger->commands[0].parameter, 12);
+    BOOST_CHECK(decoded.activatedItems.empty());
+    checkEquivalence(data.data());
+}
+
+BOOST_AUTO_TEST_CASE(test_switch_sequence_with_camera_parameters)
+{
+    // a switch activating item 3 and showing two cameras; the sequence ends with the camera parameters' end flag,
+    // not with the command's, and the word after it belongs to the next sector
+    const FloorData data{uint16_t{0x8000 | (2u << 8u) | 0x04},
+                         uint16_t{0x3e00 | 0x0100 | 0x0005},
+                         uint16_t{0x0009},
+                         uint16_t{0x0003},
+                         uint16_t{0x8000 | (1u << 10u) | 2u},
+                         uint16_t{0x0200 | 0x0100 | 0x0004},
+                         uint16_t{(1u << 10u) | 5u},
+                         uint16_t{0x8000 | 0x0400 | 0x0001},
+                         uint16_t{(6u << 10u) | 7u}};
+    const DecodedFloorData decoded{data.data()};
+    BOOST_CHECK(!decoded.isDeath);
+    BOOST_REQUIRE(decoded.trigger.is_initialized());
+    const auto& trigger = *decoded.trigger;
+    BOOST_CHECK(trigger.condition == SequenceCondition::ItemActivated);
+    BOOST_CHECK(trigger.activationRequest.isFullyActivated());
+    BOOST_CHECK(trigger.activationRequest.isOneshot());
+    BOOST_REQUIRE(trigger.conditionItemId.is_initialized());
+    BOOST_CHECK_EQUAL(*trigger.conditionItemId, 9);
+    BOOST_CHECK(trigger.conditionItem == nullptr);
+
+    BOOST_REQUIRE_EQUAL(trigger.commands.size(), 3u);
+    BOOST_CHECK(trigger.commands[0].opcode == CommandOpcode::Activate);
+    BOOST_CHECK_EQUAL(trigger.commands[0].parameter, 3);
+    BOOST_CHECK(!trigger.commands[0].cameraParameters.is_initialized());
+    BOOST_CHECK(trigger.commands[0].item == nullptr);
+
+    BOOST_CHECK(trigger.commands[1].opcode == CommandOpcode::SwitchCamera);
+    BOOST_CHECK_EQUAL(trigger.commands[1].parameter, 2);
+    BOOST_REQUIRE(trigger.commands[1].cameraParameters.is_initialized());
+    BOOST_CHECK(trigger.commands[1].cameraParameters->timeout == core::Seconds{4});
+    BOOST_CHECK(trigger.commands[1].cameraParameters->oneshot);
+    BOOST_CHECK(!trigger.commands[1].cameraParameters->isLast);
+    BOOST_CHECK_EQUAL(trigger.commands[1].cameraParameters->smoothness, 2);
+
+    BOOST_CHECK(trigger.commands[2].opcode == CommandOpcode::SwitchCamera);
+    BOOST_CHECK_EQUAL(trigger.commands[2].parameter, 5);
+    BOOST_REQUIRE(trigger.commands[2].cameraParameters.is_initialized());
+    BOOST_CHECK(trigger.commands[2].cameraParameters->timeout == core::Seconds{1});
+    BOOST_CHECK(!trigger.commands[2].cameraParameters->oneshot);
+    BOOST_CHECK(trigger.commands[2].cameraParameters->isLast);
+    BOOST_CHECK_EQUAL(trigger.commands[2].cameraParameters->smoothness, 4);
+
+    checkEquivalence(data.data());
+}
+
+BOOST_AUTO_TEST_CASE(test_level_floor_data)
+{
+#ifdef FLOORDATA_TEST_LEVEL
+    FloorData floorData;
+    std::vector<size_t> sectorIndices;
+    BOOST_REQUIRE(readLevelFloorData(FLOORDATA_TEST_LEVEL, floorData, sectorIndices));
+    BOOST_REQUIRE(!sectorIndices.empty());
+    // the walkers may read one value beyond the last chunk
+    floorData.emplace_back(uint16_t{0});
+
+    size_t triggers = 0;
+    size_t commands = 0;
+    for(const auto index : sectorIndices)
+    {
+        BOOST_REQUIRE_LT(index, floorData.size());
+        BOOST_TEST_CONTEXT("floor data index " << index)
+        {
+            checkEquivalence(&floorData[index]);
+
+            // every trigger of the level, with its commands and camera parameters, must match the raw walk
+            const DecodedFloorData decoded{&floorData[index]};
+            const auto compared = checkTrigger(walk(&floorData[index]).lastCommandSequenceOrDeath, decoded);
+            if(decoded.trigger.is_initialized())
+                ++triggers;
+            commands += compared;
+        }
+    }
+    BOOST_CHECK_GT(triggers, 0u);
+    BOOST_TEST_MESSAGE(triggers << " triggers with " << commands << " commands compared");
+
+    // no timing is asserted as it depends on the machine; the numbers are only reported
+    static constexpr int Rounds = 2000;
+    std::vector<DecodedFloorData> decoded;
+    decoded.reserve(sectorIndices.size());
+    for(const auto index : sectorIndices)
+        decoded.emplace_back(&floorData[index]);
+
+    size_t walkedSum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for(int round = 0; round < Rounds; ++round)
+    {
+        for(const auto index : sectorIndices)
+        {
+            const auto walked = walk(&floorData[index]);
+            walkedSum += walked.floorItems.size() + walked.ceilingItems.size() + walked.floorSlant.is_initialized()
+                         + walked.ceilingSlant.is_initialized() + walked.portalTarget.is_initialized();
+        }
+    }
+    const auto walkDuration = std::chrono::high_resolution_clock::now() - start;
+
+    size_t decodedSum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for(int round = 0; round < Rounds; ++round)
+    {
+        for(const auto& data : decoded)
+        {
+            // the decoded items are read twice, like the walkers do for the floor and the ceiling
+            decodedSum += 2 * data.activatedItems.size() + data.floorSlant.is_initialized()
+                          + data.ceilingSlant.is_initialized() + data.portalTarget.is_initialized();
+        }
+    }
+    const auto decodedDuration = std::chrono::high_resolution_clock::now() - start;
+    BOOST_CHECK_EQUAL(walkedSum, decodedSum);
+
+    const auto queries = static_cast<double>(Rounds) * sectorIndices.size();
+    const auto toQps = [queries](const std::chrono::high_resolution_clock::duration& duration) {
+        return static_cast<int64_t>(queries / std::max(std::chrono::duration<double>(duration).count(), 1e-9));
+    };
+    BOOST_TEST_MESSAGE(sectorIndices.size() << " sectors with floor data; walking the chunks: " << toQps(walkDuration)
+                                            << " queries/s, reading the decoded data: " << toQps(decodedDuration)
+                                            << " queries/s");
+#else
+    BOOST_TEST_MESSAGE("No test level configured");
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
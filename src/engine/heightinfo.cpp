@@ -6,100 +6,67 @@
 
 namespace engine
 {
-bool HeightInfo::skipSteepSlants = false;
-
 HeightInfo HeightInfo::fromFloor(gsl::not_null<const loader::file::Sector*> roomSector,
                                  const core::TRVec& pos,
-                                 const std::map<uint16_t, gsl::not_null<std::shared_ptr<items::ItemNode>>>& itemList)
+                                 const SlantPolicy slantPolicy)
 {
     HeightInfo hi;
 
-    while(roomSector->roomBelow != nullptr)
-    {
-        roomSector = roomSector->roomBelow->getSectorByAbsolutePosition(pos);
-    }
+    roomSector = roomSector->floorSector;
 
     hi.y = roomSector->floorHeight;
 
-    if(roomSector->floorData == nullptr)
+    const auto floorData = roomSector->decodedFloorData;
+    if(floorData == nullptr)
     {
         return hi;
     }
 
     // process additional slant and item height patches
-    const engine::floordata::FloorDataValue* fd = roomSector->floorData;
-    while(true)
+    if(floorData->floorSlant.is_initialized())
     {
-        const floordata::FloorDataChunk chunkHeader{*fd++};
-        switch(chunkHeader.type)
-        {
-        case floordata::FloorDataChunkType::FloorSlant:
+        const core::Length::type xSlant = floorData->floorSlant->x;
+        const core::Length::type absX = std::abs(xSlant);
+        const core::Length::type zSlant = floorData->floorSlant->z;
+        const core::Length::type absZ = std::abs(zSlant);
+        if(slantPolicy == SlantPolicy::All || (absX <= 2 && absZ <= 2))
         {
-            const core::Length::type xSlant = gsl::narrow_cast<int8_t>(fd->get() & 0xff);
-            const core::Length::type absX = std::abs(xSlant);
-            const core::Length::type zSlant = gsl::narrow_cast<int8_t>((fd->get() >> 8) & 0xff);
-            const core::Length::type absZ = std::abs(zSlant);
-            if(!skipSteepSlants || (absX <= 2 && absZ <= 2))
+            if(absX <= 2 && absZ <= 2)
+                hi.slantClass = SlantClass::Max512;
+            else
+                hi.slantClass = SlantClass::Steep;
+
+            const auto localX = pos.X % core::SectorSize;
+            const auto localZ = pos.Z % core::SectorSize;
+
+            if(zSlant > 0) // lower edge at -Z
             {
-                if(absX <= 2 && absZ <= 2)
-                    hi.slantClass = SlantClass::Max512;
-                else
-                    hi.slantClass = SlantClass::Steep;
-
-                const auto localX = pos.X % core::SectorSize;
-                const auto localZ = pos.Z % core::SectorSize;
-
-                if(zSlant > 0) // lower edge at -Z
-                {
-                    const core::Length dist = core::SectorSize - localZ;
-                    hi.y += dist * zSlant * core::QuarterSectorSize / core::SectorSize;
-                }
-                else if(zSlant < 0) // lower edge at +Z
-                {
-                    const auto dist = localZ;
-                    hi.y -= dist * zSlant * core::QuarterSectorSize / core::SectorSize;
-                }
-
-                if(xSlant > 0) // lower edge at -X
-                {
-                    const auto dist = core::SectorSize - localX;
-                    hi.y += dist * xSlant * core::QuarterSectorSize / core::SectorSize;
-                }
-                else if(xSlant < 0) // lower edge at +X
-                {
-                    const auto dist = localX;
-                    hi.y -= dist * xSlant * core::QuarterSectorSize / core::SectorSize;
-                }
+                const core::Length dist = core::SectorSize - localZ;
+                hi.y += dist * zSlant * core::QuarterSectorSize / core::SectorSize;
             }
-        }
-            // Fall-through
-        case floordata::FloorDataChunkType::CeilingSlant:
-        case floordata::FloorDataChunkType::PortalSector: ++fd; break;
-        case floordata::FloorDataChunkType::Death: hi.lastCommandSequenceOrDeath = fd - 1; break;
-        case floordata::FloorDataChunkType::CommandSequence:
-            if(hi.lastCommandSequenceOrDeath == nullptr)
-                hi.lastCommandSequenceOrDeath = fd - 1;
-            ++fd;
-            while(true)
+            else if(zSlant < 0) // lower edge at +Z
+            {
+                const auto dist = localZ;
+                hi.y -= dist * zSlant * core::QuarterSectorSize / core::SectorSize;
+            }
+
+            if(xSlant > 0) // lower edge at -X
+            {
+                const auto dist = core::SectorSize - localX;
+                hi.y += dist * xSlant * core::QuarterSectorSize / core::SectorSize;
+            }
+            else if(xSlant < 0) // lower edge at +X
             {
-                const floordata::Command command{*fd++};
-
-                if(command.opcode == floordata::CommandOpcode::Activate)
-                {
-                    itemList.at(command.parameter)->patchFloor(pos, hi.y);
-                }
-                else if(command.opcode == floordata::CommandOpcode::SwitchCamera)
-                {
-                    command.isLast = floordata::CameraParameters{*fd++}.isLast;
-                }
-
-                if(command.isLast)
-                    break;
+                const auto dist = localX;
+                hi.y -= dist * xSlant * core::QuarterSectorSize / core::SectorSize;
             }
-        default: break;
         }
-        if(chunkHeader.isLast)
-            break;
+    }
+
+    hi.floorData = floorData;
+    for(const auto item : floorData->patchingItems)
+    {
+        item->patchFloor(pos, hi.y);
     }
 
     return hi;
@@ -107,107 +74,58 @@ HeightInfo HeightInfo::fromFloor(gsl::not_null<const loader::file::Sector*> room
 
 HeightInfo HeightInfo::fromCeiling(gsl::not_null<const loader::file::Sector*> roomSector,
                                    const core::TRVec& pos,
-                                   const std::map<uint16_t, gsl::not_null<std::shared_ptr<items::ItemNode>>>& itemList)
+                                   const SlantPolicy slantPolicy)
 {
     HeightInfo hi;
 
-    while(roomSector->roomAbove != nullptr)
-    {
-        roomSector = roomSector->roomAbove->getSectorByAbsolutePosition(pos);
-    }
+    roomSector = roomSector->ceilingSector;
 
     hi.y = roomSector->ceilingHeight;
 
-    if(roomSector->floorData != nullptr)
+    if(roomSector->decodedFloorData != nullptr && roomSector->decodedFloorData->ceilingSlant.is_initialized())
     {
-        const engine::floordata::FloorDataValue* fd = roomSector->floorData;
-        floordata::FloorDataChunk chunkHeader{*fd};
-        ++fd;
-
-        if(chunkHeader.type == floordata::FloorDataChunkType::FloorSlant)
+        const auto& ceilingSlant = *roomSector->decodedFloorData->ceilingSlant;
+        const core::Length::type xSlant = ceilingSlant.x;
+        const core::Length::type absX = std::abs(xSlant);
+        const core::Length::type zSlant = ceilingSlant.z;
+        const core::Length::type absZ = std::abs(zSlant);
+        if(slantPolicy == SlantPolicy::All || (absX <= 2 && absZ <= 2))
         {
-            ++fd;
+            const auto localX = pos.X % core::SectorSize;
+            const auto localZ = pos.Z % core::SectorSize;
 
-            chunkHeader = floordata::FloorDataChunk{*fd};
-            ++fd;
-        }
+            if(zSlant > 0) // lower edge at -Z
+            {
+                const auto dist = core::SectorSize - localZ;
+                hi.y -= dist * zSlant * core::QuarterSectorSize / core::SectorSize;
+            }
+            else if(zSlant < 0) // lower edge at +Z
+            {
+                const auto dist = localZ;
+                hi.y += dist * zSlant * core::QuarterSectorSize / core::SectorSize;
+            }
 
-        if(chunkHeader.type == floordata::FloorDataChunkType::CeilingSlant)
-        {
-            const core::Length::type xSlant = gsl::narrow_cast<int8_t>(fd->get() & 0xff);
-            const core::Length::type absX = std::abs(xSlant);
-            const core::Length::type zSlant = gsl::narrow_cast<int8_t>((fd->get() >> 8) & 0xff);
-            const core::Length::type absZ = std::abs(zSlant);
-            if(!skipSteepSlants || (absX <= 2 && absZ <= 2))
+            if(xSlant > 0) // lower edge at -X
             {
-                const auto localX = pos.X % core::SectorSize;
-                const auto localZ = pos.Z % core::SectorSize;
-
-                if(zSlant > 0) // lower edge at -Z
-                {
-                    const auto dist = core::SectorSize - localZ;
-                    hi.y -= dist * zSlant * core::QuarterSectorSize / core::SectorSize;
-                }
-                else if(zSlant < 0) // lower edge at +Z
-                {
-                    const auto dist = localZ;
-                    hi.y += dist * zSlant * core::QuarterSectorSize / core::SectorSize;
-                }
-
-                if(xSlant > 0) // lower edge at -X
-                {
-                    const auto dist = localX;
-                    hi.y -= dist * xSlant * core::QuarterSectorSize / core::SectorSize;
-                }
-                else if(xSlant < 0) // lower edge at +X
-                {
-                    const auto dist = core::SectorSize - localX;
-                    hi.y += dist * xSlant * core::QuarterSectorSize / core::SectorSize;
-                }
+                const auto dist = localX;
+                hi.y -= dist * xSlant * core::QuarterSectorSize / core::SectorSize;
+            }
+            else if(xSlant < 0) // lower edge at +X
+            {
+                const auto dist = core::SectorSize - localX;
+                hi.y += dist * xSlant * core::QuarterSectorSize / core::SectorSize;
             }
         }
     }
 
-    while(roomSector->roomBelow != nullptr)
-    {
-        roomSector = roomSector->roomBelow->getSectorByAbsolutePosition(pos);
-    }
+    roomSector = roomSector->floorSector;
 
-    if(roomSector->floorData == nullptr)
+    if(roomSector->decodedFloorData == nullptr)
         return hi;
 
-    const engine::floordata::FloorDataValue* fd = roomSector->floorData;
-    while(true)
+    for(const auto item : roomSector->decodedFloorData->patchingItems)
     {
-        const floordata::FloorDataChunk chunkHeader{*fd++};
-        switch(chunkHeader.type)
-        {
-        case floordata::FloorDataChunkType::CeilingSlant:
-        case floordata::FloorDataChunkType::FloorSlant:
-        case floordata::FloorDataChunkType::PortalSector: ++fd; break;
-        case floordata::FloorDataChunkType::Death: break;
-        case floordata::FloorDataChunkType::CommandSequence:
-            ++fd;
-            while(true)
-            {
-                const floordata::Command command{*fd++};
-
-                if(command.opcode == floordata::CommandOpcode::Activate)
-                {
-                    itemList.at(command.parameter)->patchCeiling(pos, hi.y);
-                }
-                else if(command.opcode == floordata::CommandOpcode::SwitchCamera)
-                {
-                    command.isLast = floordata::CameraParameters{*fd++}.isLast;
-                }
-
-                if(command.isLast)
-                    break;
-            }
-        default: break;
-        }
-        if(chunkHeader.isLast)
-            break;
+        item->patchCeiling(pos, hi.y);
     }
 
     return hi;
@@ -13,21 +13,35 @@ enum class SlantClass
     Steep
 };
 
+//! Decides which floor and ceiling slants are applied by height queries.
+enum class SlantPolicy
+{
+    All,
+    //! Ignores slants steeper than two quarter sectors, which the camera glides over.
+    SkipSteep
+};
+
+/**
+ * @brief The floor or ceiling height at a position.
+ *
+ * @details
+ * The queries only read the level data and the items referenced by the sector's floor data, so they may be run
+ * concurrently as long as no item is updated at the same time.
+ */
 struct HeightInfo
 {
     core::Length y = 0_len;
     SlantClass slantClass = SlantClass::None;
-    const engine::floordata::FloorDataValue* lastCommandSequenceOrDeath = nullptr;
-
-    static bool skipSteepSlants;
+    //! The floor data of the sector, for handling its trigger; only set for floor heights.
+    const engine::floordata::DecodedFloorData* floorData = nullptr;
 
     static HeightInfo fromFloor(gsl::not_null<const loader::file::Sector*> roomSector,
                                 const core::TRVec& pos,
-                                const std::map<uint16_t, gsl::not_null<std::shared_ptr<items::ItemNode>>>& itemList);
+                                SlantPolicy slantPolicy = SlantPolicy::All);
 
     static HeightInfo fromCeiling(gsl::not_null<const loader::file::Sector*> roomSector,
                                   const core::TRVec& pos,
-                                  const std::map<uint16_t, gsl::not_null<std::shared_ptr<items::ItemNode>>>& itemList);
+                                  SlantPolicy slantPolicy = SlantPolicy::All);
 
     HeightInfo() = default;
 };
@@ -39,15 +53,14 @@ struct VerticalSpaceInfo
 
     void init(const gsl::not_null<const loader::file::Sector*>& roomSector,
               const core::TRVec& position,
-              const std::map<uint16_t, gsl::not_null<std::shared_ptr<items::ItemNode>>>& itemList,
               const core::Length itemY,
               const core::Length itemHeight)
     {
-        floorSpace = HeightInfo::fromFloor(roomSector, position, itemList);
+        floorSpace = HeightInfo::fromFloor(roomSector, position);
         if(floorSpace.y != -core::HeightLimit)
             floorSpace.y -= itemY;
 
-        ceilingSpace = HeightInfo::fromCeiling(roomSector, position, itemList);
+        ceilingSpace = HeightInfo::fromCeiling(roomSector, position);
         if(ceilingSpace.y != -core::HeightLimit)
             ceilingSpace.y -= itemY - itemHeight;
     }
@@ -109,13 +109,13 @@ bool AIAgent::animateCreature(const core::Angle angle, core::Angle tilt)
     auto currentFloor = sector->box->floor;
 
     core::Length nextFloor = 0_len;
-    if(lotInfo.nodes.at(sector->box).exit_box == nullptr)
+    if(lotInfo.getNode(sector->box).exit_box == nullptr)
     {
         nextFloor = currentFloor;
     }
     else
     {
-        nextFloor = lotInfo.nodes.at(sector->box).exit_box->floor;
+        nextFloor = lotInfo.getNode(sector->box).exit_box->floor;
     }
 
     if(sector->box == nullptr || m_state.box->*zoneRef != sector->box->*zoneRef
@@ -146,13 +146,13 @@ bool AIAgent::animateCreature(const core::Angle angle, core::Angle tilt)
 
         currentFloor = sector->box->floor;
 
-        if(lotInfo.nodes.at(sector->box).exit_box == nullptr)
+        if(lotInfo.getNode(sector->box).exit_box == nullptr)
         {
             nextFloor = sector->box->floor;
         }
         else
         {
-            nextFloor = lotInfo.nodes.at(sector->box).exit_box->floor;
+            nextFloor = lotInfo.getNode(sector->box).exit_box->floor;
         }
     }
 
@@ -316,8 +316,7 @@ bool AIAgent::animateCreature(const core::Angle angle, core::Angle tilt)
 
         currentFloor
             = HeightInfo::fromFloor(sector,
-                                    core::TRVec{m_state.position.position.X, bboxMinY, m_state.position.position.Z},
-                                    getEngine().getItemNodes())
+                                    core::TRVec{m_state.position.position.X, bboxMinY, m_state.position.position.Z})
                   .y;
 
         if(m_state.position.position.Y + moveY > currentFloor)
@@ -341,8 +340,7 @@ bool AIAgent::animateCreature(const core::Angle angle, core::Angle tilt)
         {
             const auto ceiling = HeightInfo::fromCeiling(
                                      sector,
-                                     core::TRVec{m_state.position.position.X, bboxMinY, m_state.position.position.Z},
-                                     getEngine().getItemNodes())
+                                     core::TRVec{m_state.position.position.X, bboxMinY, m_state.position.position.Z})
                                      .y;
 
             const auto y = m_state.type == TR1ItemId::CrocodileInWater ? 0_len : bbox.minY;
@@ -365,8 +363,7 @@ bool AIAgent::animateCreature(const core::Angle angle, core::Angle tilt)
             core::TRVec{m_state.position.position.X, bboxMinY, m_state.position.position.Z}, &room);
         m_state.floor
             = HeightInfo::fromFloor(sector,
-                                    core::TRVec{m_state.position.position.X, bboxMinY, m_state.position.position.Z},
-                                    getEngine().getItemNodes())
+                                    core::TRVec{m_state.position.position.X, bboxMinY, m_state.position.position.Z})
                   .y;
 
         core::Angle yaw{0_deg};
@@ -401,7 +398,7 @@ bool AIAgent::animateCreature(const core::Angle angle, core::Angle tilt)
     m_state.rotation.X = 0_au;
 
     sector = loader::file::findRealFloorSector(m_state.position.position, &room);
-    m_state.floor = HeightInfo::fromFloor(sector, m_state.position.position, getEngine().getItemNodes()).y;
+    m_state.floor = HeightInfo::fromFloor(sector, m_state.position.position).y;
 
     setCurrentRoom(room);
 
@@ -447,7 +444,7 @@ bool AIAgent::canShootAtLara(const ai::AiInfo& aiInfo) const
     auto start = m_state.position;
     auto end = getEngine().getLara().m_state.position;
     end.position.Y -= 768_len;
-    return CameraController::clampPosition(start, end, getEngine());
+    return CameraController::clampPosition(start, end);
 }
 
 namespace
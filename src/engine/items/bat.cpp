@@ -12,7 +12,7 @@ void Bat::update()
 {
     if(m_state.triggerState == TriggerState::Invisible)
     {
-        m_state.triggerState = TriggerState::Active;
+        setTriggerState(TriggerState::Active);
     }
 
     m_state.initCreatureInfo(getEngine());
@@ -11,7 +11,7 @@ void Bear::update()
 {
     if(m_state.triggerState == TriggerState::Invisible)
     {
-        m_state.triggerState = TriggerState::Active;
+        setTriggerState(TriggerState::Active);
     }
 
     m_state.initCreatureInfo(getEngine());
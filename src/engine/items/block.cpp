@@ -129,7 +129,7 @@ void Block::update()
 
     auto pos = m_state.position;
     auto sector = loader::file::findRealFloorSector(pos);
-    const auto height = HeightInfo::fromFloor(sector, pos.position, getEngine().getItemNodes()).y;
+    const auto height = HeightInfo::fromFloor(sector, pos.position).y;
     if(height > pos.position.Y)
     {
         m_state.falling = true;
@@ -157,8 +157,7 @@ void Block::update()
     loader::file::Room::patchHeightsForBlock(*this, -core::SectorSize);
     pos = m_state.position;
     sector = loader::file::findRealFloorSector(pos);
-    getEngine().getLara().handleCommandSequence(
-        HeightInfo::fromFloor(sector, pos.position, getEngine().getItemNodes()).lastCommandSequenceOrDeath, true);
+    getEngine().getLara().handleCommandSequence(HeightInfo::fromFloor(sector, pos.position).floorData, true);
 }
 
 bool Block::isOnFloor(const core::Length& height) const
@@ -28,9 +28,9 @@ void engine::items::RollingBall::update()
         auto room = m_state.position.room;
         auto sector = loader::file::findRealFloorSector(m_state.position.position, &room);
         setCurrentRoom(room);
-        const auto hi = HeightInfo::fromFloor(sector, m_state.position.position, getEngine().getItemNodes());
+        const auto hi = HeightInfo::fromFloor(sector, m_state.position.position);
         m_state.floor = hi.y;
-        getEngine().getLara().handleCommandSequence(hi.lastCommandSequenceOrDeath, true);
+        getEngine().getLara().handleCommandSequence(hi.floorData, true);
         if(m_state.floor - core::QuarterSectorSize <= m_state.position.position.Y)
         {
             m_state.fallspeed = 0_spd;
@@ -41,7 +41,7 @@ void engine::items::RollingBall::update()
         // let's see if we hit a wall, and if that's the case, stop.
         const auto testPos = m_state.position.position + util::pitch(core::SectorSize / 2, m_state.rotation.Y);
         sector = loader::file::findRealFloorSector(testPos, room);
-        if(HeightInfo::fromFloor(sector, testPos, getEngine().getItemNodes()).y < m_state.position.position.Y)
+        if(HeightInfo::fromFloor(sector, testPos).y < m_state.position.position.Y)
         {
             m_state.fallspeed = 0_spd;
             m_state.touch_bits.reset();
@@ -17,13 +17,13 @@ public:
     {
     }
 
-    void patchFloor(const core::TRVec& pos, core::Length& y) override
+    void patchFloor(const core::TRVec& pos, core::Length& y) const override
     {
         if(pos.Y <= m_state.position.position.Y)
             y = m_state.position.position.Y;
     }
 
-    void patchCeiling(const core::TRVec& pos, core::Length& y) override
+    void patchCeiling(const core::TRVec& pos, core::Length& y) const override
     {
         if(pos.Y <= m_state.position.position.Y)
             return;
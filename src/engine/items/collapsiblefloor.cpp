@@ -44,7 +44,7 @@ void CollapsibleFloor::update()
     const auto sector = loader::file::findRealFloorSector(m_state.position.position, &room);
     setCurrentRoom(room);
 
-    const HeightInfo h = HeightInfo::fromFloor(sector, m_state.position.position, getEngine().getItemNodes());
+    const HeightInfo h = HeightInfo::fromFloor(sector, m_state.position.position);
     m_state.floor = h.y;
     if(m_state.current_anim_state != 2_as || m_state.position.position.Y < h.y)
         return;
@@ -19,7 +19,7 @@ public:
 
     void update() override;
 
-    void patchFloor(const core::TRVec& pos, core::Length& y) override
+    void patchFloor(const core::TRVec& pos, core::Length& y) const override
     {
         if(pos.Y > m_state.position.position.Y - 512_len)
             return;
@@ -30,7 +30,7 @@ public:
         y = m_state.position.position.Y - 512_len;
     }
 
-    void patchCeiling(const core::TRVec& pos, core::Length& y) override
+    void patchCeiling(const core::TRVec& pos, core::Length& y) const override
     {
         if(pos.Y <= m_state.position.position.Y - 512_len)
             return;
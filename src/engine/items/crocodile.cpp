@@ -11,7 +11,7 @@ void Crocodile::update()
 {
     if(m_state.triggerState == TriggerState::Invisible)
     {
-        m_state.triggerState = TriggerState::Active;
+        setTriggerState(TriggerState::Active);
     }
 
     m_state.initCreatureInfo(getEngine());
@@ -117,7 +117,7 @@ void Crocodile::update()
                 auto room = m_state.position.room;
                 auto sector = loader::file::findRealFloorSector(m_state.position.position, &room);
                 m_state.position.position.Y
-                    = HeightInfo::fromFloor(sector, m_state.position.position, getEngine().getItemNodes()).y;
+                    = HeightInfo::fromFloor(sector, m_state.position.position).y;
                 m_state.rotation.X = 0_deg;
 
                 loadObjectInfo(true);
@@ -125,7 +125,7 @@ void Crocodile::update()
             ModelItemNode::update();
             auto room = m_state.position.room;
             auto sector = loader::file::findRealFloorSector(m_state.position.position, &room);
-            m_state.floor = HeightInfo::fromFloor(sector, m_state.position.position, getEngine().getItemNodes()).y;
+            m_state.floor = HeightInfo::fromFloor(sector, m_state.position.position).y;
             setCurrentRoom(room);
         }
     }
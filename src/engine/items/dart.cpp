@@ -39,7 +39,7 @@ void Dart::update()
     if(room != m_state.position.room)
         setCurrentRoom(room);
 
-    const HeightInfo h = HeightInfo::fromFloor(sector, m_state.position.position, getEngine().getItemNodes());
+    const HeightInfo h = HeightInfo::fromFloor(sector, m_state.position.position);
     m_state.floor = h.y;
 
     if(m_state.position.position.Y < m_state.floor)
@@ -80,6 +80,12 @@ ItemNode::ItemNode(const gsl::not_null<Engine*>& engine,
     }
 }
 
+void ItemNode::setTriggerState(const TriggerState triggerState)
+{
+    m_state.triggerState = triggerState;
+    updateVisibility();
+}
+
 void ItemNode::setCurrentRoom(const gsl::not_null<const loader::file::Room*>& newRoom)
 {
     if(newRoom == m_state.position.room)
@@ -115,6 +121,7 @@ ModelItemNode::ModelItemNode(const gsl::not_null<Engine*>& engine,
 
     m_skeleton->updatePose(m_state);
     m_lighting.bind(*m_skeleton);
+    updateBoundingSphere();
 }
 
 void ModelItemNode::update()
@@ -203,12 +210,24 @@ void ItemNode::activate()
         return;
     }
 
-    m_isActive = true;
+    setActive(true);
 }
 
 void ItemNode::deactivate()
 {
-    m_isActive = false;
+    setActive(false);
+}
+
+void ItemNode::setActive(const bool active)
+{
+    if(m_isActive == active)
+        return;
+
+    m_isActive = active;
+    if(active)
+        getEngine().registerActiveItem(*this);
+    else
+        getEngine().unregisterActiveItem(*this);
 }
 
 std::shared_ptr<audio::SourceHandle> ItemNode::playSoundEffect(const core::SoundId id)
@@ -249,7 +268,7 @@ bool ItemNode::triggerPickUp()
         return false;
     }
 
-    m_state.triggerState = TriggerState::Deactivated;
+    setTriggerState(TriggerState::Deactivated);
     return true;
 }
 
@@ -274,7 +293,8 @@ YAML::Node ItemNode::save() const
 void ItemNode::load(const YAML::Node& n)
 {
     m_state.load(n["state"], *m_engine);
-    m_isActive = n["active"].as<bool>();
+    setActive(n["active"].as<bool>());
+    updateVisibility();
 
     if(getNode()->getChildren().empty())
     {
@@ -299,6 +319,7 @@ void ItemNode::load(const YAML::Node& n)
 
     addChild(m_state.position.room->node, getNode());
     applyTransform();
+    updateBoundingSphere();
 }
 
 bool InteractionLimits::canInteract(const ItemState& item, const ItemState& lara) const
@@ -355,6 +376,17 @@ loader::file::BoundingBox ModelItemNode::getBoundingBox() const
     return m_skeleton->getBoundingBox(m_state);
 }
 
+void ModelItemNode::updateBoundingSphere()
+{
+    const auto bbox = getBoundingBox();
+    const core::TRVec min{bbox.minX, bbox.minY, bbox.minZ};
+    const core::TRVec max{bbox.maxX, bbox.maxY, bbox.maxZ};
+    auto sphere = render::scene::BoundingSphere::fromBox(min.toRenderSystem(), max.toRenderSystem());
+    // the frame boxes don't cover everything attached to the skeleton, e.g. weapons or flares
+    sphere.radius *= 1.5f;
+    m_skeleton->setBoundingSphere(sphere);
+}
+
 SpriteItemNode::SpriteItemNode(const gsl::not_null<Engine*>& engine,
                                const std::string& name,
                                const gsl::not_null<const loader::file::Room*>& room,
@@ -369,6 +401,7 @@ SpriteItemNode::SpriteItemNode(const gsl::not_null<Engine*>& engine,
 
     m_node = std::make_shared<render::scene::Node>(name);
     m_node->setDrawable(model);
+    m_node->setBoundingSphere(model->getBoundingSphere());
     m_node->addUniformSetter(
         "u_diffuseTexture",
         [texture = sprite.texture](const render::scene::Node& /*node*/, render::gl::ProgramUniform& uniform) {
@@ -159,8 +159,18 @@ struct ItemState final : public audio::Emitter
 
 class ItemNode
 {
+    friend class engine::Engine;
+
     const gsl::not_null<Engine*> m_engine;
 
+    //! The slot in the engine's list of active items while #m_isActive is set.
+    boost::optional<size_t> m_activeListIndex;
+
+    //! The slot in the engine's list of dynamic items, if this item was spawned while playing.
+    boost::optional<size_t> m_dynamicListIndex;
+
+    void setActive(bool active);
+
 public:
     ItemState m_state;
 
@@ -200,8 +210,22 @@ public:
 
     virtual std::shared_ptr<render::scene::Node> getNode() const = 0;
 
+    //! Updates the sphere used to cull the node, e.g. after its animation changed.
+    virtual void updateBoundingSphere()
+    {
+    }
+
     void setCurrentRoom(const gsl::not_null<const loader::file::Room*>& newRoom);
 
+    //! Changes the trigger state, and hides the node while the item is invisible.
+    void setTriggerState(TriggerState triggerState);
+
+    //! Shows or hides the node according to the trigger state, e.g. after it was set while constructing or loading.
+    void updateVisibility()
+    {
+        getNode()->setVisible(m_state.triggerState != TriggerState::Invisible);
+    }
+
     void applyTransform();
 
     void rotate(const core::Angle dx, const core::Angle dy, const core::Angle dz)
@@ -243,11 +267,11 @@ public:
         m_state.speed -= (m_state.speed.retype_as<float>() * f).retype_as<core::Speed>();
     }
 
-    virtual void patchFloor(const core::TRVec& /*pos*/, core::Length& /*y*/)
+    virtual void patchFloor(const core::TRVec& /*pos*/, core::Length& /*y*/) const
     {
     }
 
-    virtual void patchCeiling(const core::TRVec& /*pos*/, core::Length& /*y*/)
+    virtual void patchCeiling(const core::TRVec& /*pos*/, core::Length& /*y*/) const
     {
     }
 
@@ -390,6 +414,8 @@ public:
 
     loader::file::BoundingBox getBoundingBox() const override;
 
+    void updateBoundingSphere() override;
+
     bool isNear(const ModelItemNode& other, const core::Length& radius) const;
 
     bool isNear(const Particle& other, const core::Length& radius) const;
@@ -10,7 +10,7 @@ void Larson::update()
 {
     if(m_state.triggerState == TriggerState::Invisible)
     {
-        m_state.triggerState = TriggerState::Active;
+        setTriggerState(TriggerState::Active);
     }
 
     m_state.initCreatureInfo(getEngine());
@@ -37,7 +37,7 @@ void PickupItem::collide(LaraNode& lara, CollisionInfo& /*collisionInfo*/)
         {
             if(lara.m_state.frame_number == 2970_frame)
             {
-                m_state.triggerState = TriggerState::Invisible;
+                setTriggerState(TriggerState::Invisible);
                 getEngine().getInventory().put(m_state.type);
                 setParent(getNode(), nullptr);
                 m_state.collidable = false;
@@ -82,7 +82,7 @@ void PickupItem::collide(LaraNode& lara, CollisionInfo& /*collisionInfo*/)
                     lara.getNode()->getChild(7)->setDrawable(shotgunLara.models[7].get());
                 }
 
-                m_state.triggerState = TriggerState::Invisible;
+                setTriggerState(TriggerState::Invisible);
                 getEngine().getInventory().put(m_state.type);
                 setParent(getNode(), nullptr);
                 m_state.collidable = false;
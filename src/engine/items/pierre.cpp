@@ -31,7 +31,7 @@ void Pierre::update()
 
     if(m_state.triggerState == TriggerState::Invisible)
     {
-        m_state.triggerState = TriggerState::Active;
+        setTriggerState(TriggerState::Active);
     }
 
     m_state.initCreatureInfo(getEngine());
@@ -199,7 +199,7 @@ void Pierre::update()
         auto camPos = m_state.position;
         camPos.position.Y -= core::SectorSize;
         auto target = getEngine().getCameraController().getTRPosition();
-        if(engine::CameraController::clampPosition(target, camPos, getEngine()))
+        if(engine::CameraController::clampPosition(target, camPos))
         {
             m_state.creatureInfo->flags = 1;
         }
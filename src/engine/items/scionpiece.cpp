@@ -40,7 +40,7 @@ void ScionPieceItem::collide(LaraNode& lara, CollisionInfo& /*collisionInfo*/)
     }
     else if(lara.m_state.frame_number == lara.m_state.anim->firstFrame + 44_frame)
     {
-        m_state.triggerState = TriggerState::Invisible;
+        setTriggerState(TriggerState::Invisible);
         getEngine().getInventory().put(m_state.type);
         setParent(getNode(), nullptr);
         m_state.collidable = false;
@@ -22,14 +22,14 @@ public:
     {
     }
 
-    void patchFloor(const core::TRVec& pos, core::Length& y) override final
+    void patchFloor(const core::TRVec& pos, core::Length& y) const override final
     {
         const auto tmp = m_state.position.position.Y + getBridgeSlopeHeight(pos) / m_div;
         if(pos.Y <= tmp)
             y = tmp;
     }
 
-    void patchCeiling(const core::TRVec& pos, core::Length& y) override final
+    void patchCeiling(const core::TRVec& pos, core::Length& y) const override final
     {
         const auto tmp = m_state.position.position.Y + getBridgeSlopeHeight(pos) / m_div;
         if(pos.Y <= tmp)
@@ -43,7 +43,7 @@ void SwingingBlade::update()
     auto room = m_state.position.room;
     const auto sector = loader::file::findRealFloorSector(m_state.position.position, &room);
     setCurrentRoom(room);
-    m_state.floor = HeightInfo::fromFloor(sector, m_state.position.position, getEngine().getItemNodes()).y;
+    m_state.floor = HeightInfo::fromFloor(sector, m_state.position.position).y;
 
     ModelItemNode::update();
 }
@@ -85,8 +85,8 @@ void ThorHammerHandle::update()
     case 3:
     {
         const auto sector = loader::file::findRealFloorSector(m_state.position.position, m_state.position.room);
-        const auto hi = HeightInfo::fromFloor(sector, m_state.position.position, getEngine().getItemNodes());
-        getEngine().getLara().handleCommandSequence(hi.lastCommandSequenceOrDeath, true);
+        const auto hi = HeightInfo::fromFloor(sector, m_state.position.position);
+        getEngine().getLara().handleCommandSequence(hi.floorData, true);
 
         const auto oldPosX = m_state.position.position.X;
         const auto oldPosZ = m_state.position.position.Z;
@@ -32,7 +32,7 @@ public:
         ModelItemNode::update();
     }
 
-    void patchFloor(const core::TRVec& pos, core::Length& y) override
+    void patchFloor(const core::TRVec& pos, core::Length& y) const override
     {
         if(m_state.current_anim_state != 0_as || !possiblyOnTrapdoor(pos) || pos.Y > m_state.position.position.Y
            || y <= m_state.position.position.Y)
@@ -41,7 +41,7 @@ public:
         y = m_state.position.position.Y;
     }
 
-    void patchCeiling(const core::TRVec& pos, core::Length& y) override
+    void patchCeiling(const core::TRVec& pos, core::Length& y) const override
     {
         if(m_state.current_anim_state != 0_as || !possiblyOnTrapdoor(pos) || pos.Y <= m_state.position.position.Y
            || y > m_state.position.position.Y)
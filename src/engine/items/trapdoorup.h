@@ -19,7 +19,7 @@ public:
 
     void update() override;
 
-    void patchFloor(const core::TRVec& pos, core::Length& y) override
+    void patchFloor(const core::TRVec& pos, core::Length& y) const override
     {
         if(m_state.current_anim_state != 1_as || !possiblyOnTrapdoor(pos) || pos.Y > m_state.position.position.Y)
             return;
@@ -27,7 +27,7 @@ public:
         y = m_state.position.position.Y;
     }
 
-    void patchCeiling(const core::TRVec& pos, core::Length& y) override
+    void patchCeiling(const core::TRVec& pos, core::Length& y) const override
     {
         if(m_state.current_anim_state != 1_as || !possiblyOnTrapdoor(pos) || pos.Y <= m_state.position.position.Y)
             return;
@@ -255,7 +255,7 @@ bool AbstractStateHandler::canClimbOnto(const core::Axis axis) const
 
     const auto sector = findRealFloorSector(pos, m_lara.m_state.position.room);
     VerticalSpaceInfo space;
-    space.init(sector, pos, getEngine().getItemNodes(), pos.Y, 400_len);
+    space.init(sector, pos, pos.Y, 400_len);
     return space.floorSpace.y != -core::HeightLimit && space.floorSpace.y > 0_len && space.ceilingSpace.y < 0_len;
 }
 
@@ -548,7 +548,7 @@ core::Length AbstractStateHandler::getRelativeHeightAtDirection(core::Angle angl
 
     const auto sector = findRealFloorSector(pos, m_lara.m_state.position.room);
 
-    HeightInfo h = HeightInfo::fromFloor(sector, pos, getEngine().getItemNodes());
+    HeightInfo h = HeightInfo::fromFloor(sector, pos);
 
     if(h.y != -core::HeightLimit)
     {
@@ -734,10 +734,9 @@ bool AbstractStateHandler::applyLandingDamage()
     const auto sector = findRealFloorSector(m_lara.m_state.position.position, m_lara.m_state.position.room);
     const HeightInfo h
         = HeightInfo::fromFloor(sector,
-                                m_lara.m_state.position.position - core::TRVec{0_len, core::LaraWalkHeight, 0_len},
-                                getEngine().getItemNodes());
+                                m_lara.m_state.position.position - core::TRVec{0_len, core::LaraWalkHeight, 0_len});
     m_lara.m_state.floor = h.y;
-    m_lara.handleCommandSequence(h.lastCommandSequenceOrDeath, false);
+    m_lara.handleCommandSequence(h.floorData, false);
     const auto damageSpeed = m_lara.m_state.fallspeed - core::DamageFallSpeedThreshold;
     if(damageSpeed <= 0_spd)
     {
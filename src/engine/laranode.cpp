@@ -7,7 +7,9 @@
 #include "particle.h"
 #include "render/textureanimator.h"
 #include "tracks_tr1.h"
+#include "util/profiler.h"
 
+#include <algorithm>
 #include <boost/range/adaptors.hpp>
 #include <glm/gtx/norm.hpp>
 #include <stack>
@@ -211,7 +213,7 @@ void LaraNode::handleLaraStateOnLand()
     updateFloorHeight(-381_len);
 
     updateLarasWeaponsStatus();
-    handleCommandSequence(collisionInfo.mid.floorSpace.lastCommandSequenceOrDeath, false);
+    handleCommandSequence(collisionInfo.mid.floorSpace.floorData, false);
 
     applyTransform();
 
@@ -268,7 +270,7 @@ void LaraNode::handleLaraStateDiving()
 
     updateFloorHeight(0_len);
     updateLarasWeaponsStatus();
-    handleCommandSequence(collisionInfo.mid.floorSpace.lastCommandSequenceOrDeath, false);
+    handleCommandSequence(collisionInfo.mid.floorSpace.floorData, false);
 #ifndef NDEBUG
     lastUsedCollisionInfo = collisionInfo;
 #endif
@@ -325,7 +327,7 @@ void LaraNode::handleLaraStateSwimming()
 
     updateFloorHeight(core::DefaultCollisionRadius);
     updateLarasWeaponsStatus();
-    handleCommandSequence(collisionInfo.mid.floorSpace.lastCommandSequenceOrDeath, false);
+    handleCommandSequence(collisionInfo.mid.floorSpace.floorData, false);
 #ifndef NDEBUG
     lastUsedCollisionInfo = collisionInfo;
 #endif
@@ -564,18 +566,16 @@ void LaraNode::updateFloorHeight(const core::Length dy)
     auto room = m_state.position.room;
     const auto sector = findRealFloorSector(pos, &room);
     setCurrentRoom(room);
-    const HeightInfo hi = HeightInfo::fromFloor(sector, pos, getEngine().getItemNodes());
+    const HeightInfo hi = HeightInfo::fromFloor(sector, pos);
     m_state.floor = hi.y;
 }
 
-void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* floorData, const bool fromHeavy)
+void LaraNode::handleCommandSequence(const floordata::DecodedFloorData* floorData, const bool fromHeavy)
 {
     if(floorData == nullptr)
         return;
 
-    floordata::FloorDataChunk chunkHeader{*floorData};
-
-    if(chunkHeader.type == floordata::FloorDataChunkType::Death)
+    if(floorData->isDeath)
     {
         if(!fromHeavy)
         {
@@ -584,27 +584,24 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
                 //! @todo kill Lara
             }
         }
-
-        if(chunkHeader.isLast)
-            return;
-
-        ++floorData;
     }
 
-    chunkHeader = floordata::FloorDataChunk{*floorData++};
-    BOOST_ASSERT(chunkHeader.type == floordata::FloorDataChunkType::CommandSequence);
-    const floordata::ActivationState activationRequest{*floorData++};
+    if(!floorData->trigger.is_initialized())
+        return;
+
+    const floordata::Trigger& trigger = *floorData->trigger;
+    const floordata::ActivationState& activationRequest = trigger.activationRequest;
 
-    getEngine().getCameraController().handleCommandSequence(floorData);
+    getEngine().getCameraController().handleCommandSequence(trigger);
 
     bool conditionFulfilled, switchIsOn = false;
     if(fromHeavy)
     {
-        conditionFulfilled = chunkHeader.sequenceCondition == floordata::SequenceCondition::ItemIsHere;
+        conditionFulfilled = trigger.condition == floordata::SequenceCondition::ItemIsHere;
     }
     else
     {
-        switch(chunkHeader.sequenceCondition)
+        switch(trigger.condition)
         {
         case floordata::SequenceCondition::LaraIsHere: conditionFulfilled = true; break;
         case floordata::SequenceCondition::LaraOnGround:
@@ -615,7 +612,8 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
         break;
         case floordata::SequenceCondition::ItemActivated:
         {
-            auto swtch = getEngine().getItemNodes().at(floordata::Command{*floorData++}.parameter);
+            const auto swtch = trigger.conditionItem;
+            Expects(swtch != nullptr);
             if(!swtch->triggerSwitch(activationRequest.getTimeout()))
                 return;
 
@@ -625,7 +623,8 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
         break;
         case floordata::SequenceCondition::KeyUsed:
         {
-            auto key = getEngine().getItemNodes().at(floordata::Command{*floorData++}.parameter);
+            const auto key = trigger.conditionItem;
+            Expects(key != nullptr);
             if(key->triggerKey())
                 conditionFulfilled = true;
             else
@@ -633,11 +632,15 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
         }
         break;
         case floordata::SequenceCondition::ItemPickedUp:
-            if(getEngine().getItemNodes().at(floordata::Command{*floorData++}.parameter)->triggerPickUp())
+        {
+            const auto pickup = trigger.conditionItem;
+            Expects(pickup != nullptr);
+            if(pickup->triggerPickUp())
                 conditionFulfilled = true;
             else
                 return;
-            break;
+        }
+        break;
         case floordata::SequenceCondition::LaraInCombatMode:
             conditionFulfilled = getHandStatus() == HandStatus::Combat;
             break;
@@ -652,22 +655,22 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
 
     bool swapRooms = false;
     boost::optional<size_t> flipEffect;
-    while(true)
+    for(const floordata::TriggerCommand& command : trigger.commands)
     {
-        const floordata::Command command{*floorData++};
         switch(command.opcode)
         {
         case floordata::CommandOpcode::Activate:
         {
-            auto& item = *getEngine().getItemNodes().at(command.parameter);
+            Expects(command.item != nullptr);
+            auto& item = *command.item;
             if(item.m_state.activationState.isOneshot())
                 break;
 
             item.m_state.timer = activationRequest.getTimeout();
 
-            if(chunkHeader.sequenceCondition == floordata::SequenceCondition::ItemActivated)
+            if(trigger.condition == floordata::SequenceCondition::ItemActivated)
                 item.m_state.activationState ^= activationRequest.getActivationSet();
-            else if(chunkHeader.sequenceCondition == floordata::SequenceCondition::LaraOnGroundInverted)
+            else if(trigger.condition == floordata::SequenceCondition::LaraOnGroundInverted)
                 item.m_state.activationState &= ~activationRequest.getActivationSet();
             else
                 item.m_state.activationState |= activationRequest.getActivationSet();
@@ -685,7 +688,7 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
                || item.m_state.triggerState == items::TriggerState::Invisible
                || dynamic_cast<items::AIAgent*>(&item) == nullptr)
             {
-                item.m_state.triggerState = items::TriggerState::Active;
+                item.setTriggerState(items::TriggerState::Active);
                 item.m_state.touch_bits = 0;
                 item.activate();
                 break;
@@ -693,23 +696,22 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
         }
         break;
         case floordata::CommandOpcode::SwitchCamera:
-        {
-            const floordata::CameraParameters camParams{*floorData++};
-            getEngine().getCameraController().setCamOverride(camParams,
+            getEngine().getCameraController().setCamOverride(*command.cameraParameters,
                                                              command.parameter,
-                                                             chunkHeader.sequenceCondition,
+                                                             trigger.condition,
                                                              fromHeavy,
                                                              activationRequest.getTimeout(),
                                                              switchIsOn);
-            command.isLast = camParams.isLast;
-        }
-        break;
+            break;
         case floordata::CommandOpcode::LookAt:
-            getEngine().getCameraController().setLookAtItem(getEngine().getItem(command.parameter));
+            getEngine().getCameraController().setLookAtItem(command.item);
             break;
         case floordata::CommandOpcode::UnderwaterCurrent:
         {
-            const auto& sink = getEngine().getCameras().at(command.parameter);
+            if(command.sink == nullptr)
+                break;
+
+            const auto& sink = *command.sink;
             if(m_underwaterRoute.required_box != &getEngine().getBoxes()[sink.box_index])
             {
                 m_underwaterRoute.required_box = &getEngine().getBoxes()[sink.box_index];
@@ -722,7 +724,7 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
             BOOST_ASSERT(command.parameter < getEngine().mapFlipActivationStates.size());
             if(!getEngine().mapFlipActivationStates[command.parameter].isOneshot())
             {
-                if(chunkHeader.sequenceCondition == floordata::SequenceCondition::ItemActivated)
+                if(trigger.condition == floordata::SequenceCondition::ItemActivated)
                 {
                     getEngine().mapFlipActivationStates[command.parameter] ^= activationRequest.getActivationSet();
                 }
@@ -761,7 +763,7 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
         case floordata::CommandOpcode::EndLevel: getEngine().finishLevel(); break;
         case floordata::CommandOpcode::PlayTrack:
             getEngine().getAudioEngine().triggerCdTrack(
-                static_cast<TR1TrackId>(command.parameter), activationRequest, chunkHeader.sequenceCondition);
+                static_cast<TR1TrackId>(command.parameter), activationRequest, trigger.condition);
             break;
         case floordata::CommandOpcode::Secret:
             BOOST_ASSERT(command.parameter < 16);
@@ -773,9 +775,6 @@ void LaraNode::handleCommandSequence(const engine::floordata::FloorDataValue* fl
             break;
         default: break;
         }
-
-        if(command.isLast)
-            break;
     }
 
     if(!swapRooms)
@@ -814,20 +813,19 @@ void LaraNode::setCameraModifier(const CameraModifier k)
 
 void LaraNode::testInteractions(CollisionInfo& collisionInfo)
 {
+    util::ProfileZone zone{"collision-interactions"};
+
     m_state.is_hit = false;
     hit_direction.reset();
 
     if(m_state.health < 0_hp)
         return;
 
-    std::set<gsl::not_null<const loader::file::Room*>> rooms;
-    rooms.insert(m_state.position.room);
-    for(const loader::file::Portal& p : m_state.position.room->portals)
-        rooms.insert(&getEngine().getRooms().at(p.adjoining_room.get()));
+    const auto& rooms = m_state.position.room->touchingRooms;
 
     for(const auto& item : getEngine().getItemNodes() | boost::adaptors::map_values)
     {
-        if(rooms.find(item->m_state.position.room) == rooms.end())
+        if(std::find(rooms.begin(), rooms.end(), item->m_state.position.room) == rooms.end())
             continue;
 
         if(!item->m_state.collidable)
@@ -845,7 +843,7 @@ void LaraNode::testInteractions(CollisionInfo& collisionInfo)
 
     for(const auto& item : getEngine().getDynamicItems())
     {
-        if(rooms.find(item->m_state.position.room) == rooms.end())
+        if(std::find(rooms.begin(), rooms.end(), item->m_state.position.room) == rooms.end())
             continue;
 
         if(!item->m_state.collidable)
@@ -876,6 +874,7 @@ void LaraNode::handleUnderwaterCurrent(CollisionInfo& collisionInfo)
 {
     m_state.box = m_state.getCurrentSector()->box;
     core::TRVec targetPos;
+    m_underwaterRoute.updatePath(getEngine(), 5);
     if(!m_underwaterRoute.calculateTarget(getEngine(), targetPos, m_state))
         return;
 
@@ -1178,7 +1177,7 @@ void LaraNode::updateAimingState(const Weapon& weapon)
     auto targetVector = getVectorAngles(enemyChestPos.position - gunPosition.position);
     targetVector.X -= m_state.rotation.X;
     targetVector.Y -= m_state.rotation.Y;
-    if(!CameraController::clampPosition(gunPosition, enemyChestPos, getEngine()))
+    if(!CameraController::clampPosition(gunPosition, enemyChestPos))
     {
         rightArm.aiming = false;
         leftArm.aiming = false;
@@ -1335,7 +1334,7 @@ void LaraNode::findTarget(const Weapon& weapon)
             continue;
 
         auto enemyPos = getUpperThirdBBoxCtr(*std::dynamic_pointer_cast<const ModelItemNode>(currentEnemy.get()));
-        if(!CameraController::clampPosition(gunPosition, enemyPos, getEngine()))
+        if(!CameraController::clampPosition(gunPosition, enemyPos))
             continue;
 
         auto aimAngle = getVectorAngles(enemyPos.position - gunPosition.position);
@@ -2005,7 +2004,7 @@ bool LaraNode::fireWeapon(const WeaponId weaponId,
                                           gunPosition + core::TRVec{-bulletDir * VeryLargeDistanceProbablyClipping}};
 
         const core::RoomBoundPosition bulletPos{gunHolder.m_state.position.room, gunPosition};
-        CameraController::clampPosition(bulletPos, aimHitPos, getEngine());
+        CameraController::clampPosition(bulletPos, aimHitPos);
         playShotMissed(aimHitPos);
     }
     else
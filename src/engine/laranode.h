@@ -321,7 +321,7 @@ public:
 
     void updateFloorHeight(core::Length dy);
 
-    void handleCommandSequence(const engine::floordata::FloorDataValue* floorData, bool fromHeavy);
+    void handleCommandSequence(const floordata::DecodedFloorData* floorData, bool fromHeavy);
 
     void addSwimToDiveKeypressDuration(const core::Frame n) noexcept
     {
@@ -124,7 +124,7 @@ bool BubbleParticle::update(Engine& engine)
         return false;
     }
 
-    const auto ceiling = HeightInfo::fromCeiling(sector, pos.position, engine.getItemNodes()).y;
+    const auto ceiling = HeightInfo::fromCeiling(sector, pos.position).y;
     if(ceiling == -core::HeightLimit || pos.position.Y <= ceiling)
     {
         return false;
@@ -0,0 +1,924 @@
+#define BOOST_TEST_MODULE engine_test
+
+#include "ai/ai.h"
+#include "ai/thinkphase.h"
+#include "cameracontroller.h"
+#include "floordata/floordata.h"
+#include "heightinfo.h"
+#include "loader/file/level/level.h"
+#include "util/jobsystem.h"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+gsl_api void gsl::fail_fast_assert_handler(char const* const /*expression*/,
+                                           char const* const message,
+                                           char const* const /*file*/,
+                                           int /*line*/)
+{
+    throw gsl::fail_fast(message);
+}
+
+using namespace engine;
+
+namespace
+{
+/**
+ * @brief A column of three sectors, with a sloped floor at the bottom and a sloped ceiling at the top.
+ *
+ * @details
+ * The sector caches are set up the way the level loader resolves them, so that queries on any of the sectors
+ * reach the bottom-most and top-most sector directly.
+ */
+struct SectorColumn
+{
+    // a floor slant of 2 quarter sectors with the lower edge at -X
+    const floordata::FloorData floorData{uint16_t{0x8002}, uint16_t{0x0002}};
+    // a ceiling slant of 1 quarter sector with the lower edge at +Z
+    const floordata::FloorData ceilingData{uint16_t{0x8003}, uint16_t{0xff00}};
+    const floordata::DecodedFloorData decodedFloor{floorData.data()};
+    const floordata::DecodedFloorData decodedCeiling{ceilingData.data()};
+
+    loader::file::Sector top;
+    loader::file::Sector middle;
+    loader::file::Sector bottom;
+
+    SectorColumn()
+    {
+        top.ceilingHeight = -2048_len;
+        top.decodedFloorData = &decodedCeiling;
+        bottom.floorHeight = 1024_len;
+        bottom.decodedFloorData = &decodedFloor;
+
+        for(auto sector : {&top, &middle, &bottom})
+        {
+            sector->ceilingSector = &top;
+            sector->floorSector = &bottom;
+        }
+    }
+};
+
+std::vector<core::TRVec> getPositions()
+{
+    std::vector<core::TRVec> positions;
+    for(int x = 0; x < 1024; x += 64)
+    {
+        for(int z = 0; z < 1024; z += 64)
+            positions.emplace_back(core::Length{5 * 1024 + x}, 0_len, core::Length{3 * 1024 + z});
+    }
+    return positions;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(heightinfo_tests)
+
+BOOST_AUTO_TEST_CASE(test_slants)
+{
+    const SectorColumn column;
+
+    auto hi = HeightInfo::fromFloor(&column.middle, core::TRVec{5120_len, 0_len, 3072_len});
+    BOOST_CHECK_EQUAL(hi.y.get(), 1024 + 512);
+    BOOST_CHECK(hi.slantClass == SlantClass::Max512);
+    BOOST_CHECK(hi.floorData == &column.decodedFloor);
+
+    hi = HeightInfo::fromFloor(&column.middle, core::TRVec{5120_len + 512_len, 0_len, 3072_len});
+    BOOST_CHECK_EQUAL(hi.y.get(), 1024 + 256);
+
+    hi = HeightInfo::fromCeiling(&column.middle, core::TRVec{5120_len, 0_len, 3072_len + 512_len});
+    BOOST_CHECK_EQUAL(hi.y.get(), -2048 - 128);
+    BOOST_CHECK(hi.floorData == nullptr);
+
+    // the column caches lead to the same sectors from any sector of the column
+    BOOST_CHECK_EQUAL(HeightInfo::fromFloor(&column.top, core::TRVec{5120_len, 0_len, 3072_len}).y.get(), 1024 + 512);
+    BOOST_CHECK_EQUAL(HeightInfo::fromCeiling(&column.bottom, core::TRVec{5120_len, 0_len, 3584_len}).y.get(),
+                      -2048 - 128);
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_queries)
+{
+    // meant to be run with ThreadSanitizer as well, which reports any write the queries may do
+    static constexpr int Threads = 8;
+    static constexpr int Rounds = 200;
+
+    const SectorColumn column;
+    const auto positions = getPositions();
+
+    std::vector<core::Length> expectedFloors, expectedCeilings;
+    for(const auto& pos : positions)
+    {
+        expectedFloors.emplace_back(HeightInfo::fromFloor(&column.middle, pos).y);
+        expectedCeilings.emplace_back(HeightInfo::fromCeiling(&column.middle, pos).y);
+    }
+
+    std::atomic<size_t> mismatches{0};
+    std::vector<std::thread> threads;
+    for(int t = 0; t < Threads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for(int round = 0; round < Rounds; ++round)
+            {
+                // each thread walks the positions in a different order, so that they query different sectors
+                for(size_t i = 0; i < positions.size(); ++i)
+                {
+                    const auto index = (i * (2 * t + 1) + round) % positions.size();
+                    const auto policy = (round + t) % 2 == 0 ? SlantPolicy::All : SlantPolicy::SkipSteep;
+                    if(HeightInfo::fromFloor(&column.middle, positions[index], policy).y != expectedFloors[index])
+                        ++mismatches;
+                    if(HeightInfo::fromCeiling(&column.middle, positions[index], policy).y
+                       != expectedCeilings[index])
+                        ++mismatches;
+                }
+            }
+        });
+    }
+    for(auto& thread : threads)
+        thread.join();
+
+    BOOST_CHECK_EQUAL(mismatches.load(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+/**
+ * @brief Two rooms side by side, connected through portals along X, with random heights, slants and walls.
+ *
+ * @details
+ * As in the levels, the rooms overlap by two sector columns, so that the portal column of each room lies over a
+ * regular column of the other one.  The world is 14 sectors wide along X and 8 sectors deep along Z.
+ */
+struct TwoRooms
+{
+    static constexpr int Width = 14;
+    static constexpr int Depth = 8;
+    static constexpr int RoomWidth = 8;
+    static constexpr int SecondRoomOffset = Width - RoomWidth;
+
+    const std::array<floordata::FloorData, 3> slantData{{{uint16_t{0x8002}, uint16_t{0x0001}},
+                                                         {uint16_t{0x8002}, uint16_t{0x00fe}},
+                                                         {uint16_t{0x8002}, uint16_t{0x0200}}}};
+    const std::array<floordata::DecodedFloorData, 3> slants{{floordata::DecodedFloorData{slantData[0].data()},
+                                                             floordata::DecodedFloorData{slantData[1].data()},
+                                                             floordata::DecodedFloorData{slantData[2].data()}}};
+
+    std::array<loader::file::Room, 2> rooms;
+    //! Whether a world column is a wall, indexed by Depth*x+z.
+    std::vector<bool> walls;
+
+    explicit TwoRooms(const std::mt19937::result_type seed)
+    {
+        std::mt19937 rng{seed};
+
+        std::vector<loader::file::Sector> world(Width * Depth);
+        walls.resize(Width * Depth);
+        for(int x = 0; x < Width; ++x)
+        {
+            for(int z = 0; z < Depth; ++z)
+            {
+                const auto wall = x == 0 || x == Width - 1 || z == 0 || z == Depth - 1 || rng() % 10 == 0;
+                walls[Depth * x + z] = wall;
+                if(wall)
+                    continue;
+
+                auto& sector = world[Depth * x + z];
+                sector.floorHeight = core::QuarterSectorSize * static_cast<core::Length::type>(rng() % 9);
+                sector.ceilingHeight = -core::QuarterSectorSize * static_cast<core::Length::type>(1 + rng() % 8);
+                if(rng() % 4 == 0)
+                    sector.decodedFloorData = &slants[rng() % slants.size()];
+            }
+        }
+
+        for(size_t i = 0; i < rooms.size(); ++i)
+        {
+            auto& room = rooms[i];
+            const int offset = i == 0 ? 0 : SecondRoomOffset;
+            room.position = core::TRVec{core::SectorSize * offset, 0_len, 0_len};
+            room.sectorCountX = RoomWidth;
+            room.sectorCountZ = Depth;
+            for(int x = 0; x < RoomWidth; ++x)
+            {
+                for(int z = 0; z < Depth; ++z)
+                    room.sectors.emplace_back(world[Depth * (x + offset) + z]);
+            }
+        }
+
+        // the last column of the first room leads to the second room, and the first column of the second room back
+        for(int z = 1; z < Depth - 1; ++z)
+        {
+            auto& toSecond = rooms[0].sectors[Depth * (RoomWidth - 1) + z];
+            toSecond.reset();
+            toSecond.portalTarget = &rooms[1];
+            toSecond.portalRoom = &rooms[1];
+            toSecond.portalSector = &rooms[1].sectors[Depth * (RoomWidth - 1 - SecondRoomOffset) + z];
+
+            auto& toFirst = rooms[1].sectors[z];
+            toFirst.reset();
+            toFirst.portalTarget = &rooms[0];
+            toFirst.portalRoom = &rooms[0];
+            toFirst.portalSector = &rooms[0].sectors[Depth * SecondRoomOffset + z];
+        }
+
+        for(auto& room : rooms)
+        {
+            for(auto& sector : room.sectors)
+            {
+                sector.floorSector = &sector;
+                sector.ceilingSector = &sector;
+            }
+        }
+    }
+};
+
+/**
+ * @brief A reference copy of the two-pass camera clamping, for checking CameraController::clampPosition.
+ *
+ * @details
+ * Each axis is walked separately, starting over from the start room; the minor axis first, then the dominant one
+ * towards the possibly already clamped end.
+ */
+namespace twopass
+{
+using Axis = core::Length core::TRVec::*;
+
+bool isVerticallyOutside(const gsl::not_null<const loader::file::Sector*>& sector,
+                         const core::TRVec& pos,
+                         const core::Length& y)
+{
+    return y > HeightInfo::fromFloor(sector, pos).y || y < HeightInfo::fromCeiling(sector, pos).y;
+}
+
+enum class ClampType
+{
+    Ceiling,
+    Wall,
+    None
+};
+
+ClampType clampAlong(const Axis axis, const core::RoomBoundPosition& start, core::RoomBoundPosition& end)
+{
+    if(end.position.*axis == start.position.*axis)
+    {
+        return ClampType::None;
+    }
+
+    const auto d = end.position - start.position;
+    const auto sign = d.*axis < 0_len ? -1 : 1;
+
+    core::TRVec testPos;
+    testPos.*axis = (start.position.*axis / core::SectorSize) * core::SectorSize;
+    if(sign > 0)
+        testPos.*axis += core::SectorSize - 1_len;
+
+    core::TRVec step;
+    step.*axis = sign * core::SectorSize;
+    for(const Axis other : {&core::TRVec::X, &core::TRVec::Y, &core::TRVec::Z})
+    {
+        if(other == axis)
+            continue;
+        testPos.*other = start.position.*other + (testPos.*axis - start.position.*axis) * d.*other / d.*axis;
+        step.*other = step.*axis * d.*other / d.*axis;
+    }
+
+    end.room = start.room;
+
+    while(true)
+    {
+        if(sign > 0 && testPos.*axis >= end.position.*axis)
+            return ClampType::None;
+        if(sign < 0 && testPos.*axis <= end.position.*axis)
+            return ClampType::None;
+
+        if(isVerticallyOutside(loader::file::findRealFloorSector(testPos, &end.room), testPos, testPos.Y))
+        {
+            end.position = testPos;
+            return ClampType::Ceiling;
+        }
+
+        core::TRVec heightPos = testPos;
+        heightPos.*axis += sign * 1_len;
+        auto tmp = end.room;
+        if(isVerticallyOutside(loader::file::findRealFloorSector(heightPos, &tmp), heightPos, testPos.Y))
+        {
+            end.position = testPos;
+            end.room = tmp;
+            return ClampType::Wall;
+        }
+
+        testPos += step;
+    }
+}
+
+bool clampPosition(const core::RoomBoundPosition& start, core::RoomBoundPosition& end, bool& minorClamped)
+{
+    const bool xIsDominant = abs(end.position.Z - start.position.Z) <= abs(end.position.X - start.position.X);
+    minorClamped = clampAlong(xIsDominant ? &core::TRVec::Z : &core::TRVec::X, start, end) != ClampType::None;
+    const auto dominantClamp = clampAlong(xIsDominant ? &core::TRVec::X : &core::TRVec::Z, start, end);
+
+    if(dominantClamp == ClampType::Wall)
+        return false;
+
+    const auto sector = loader::file::findRealFloorSector(end);
+    const HeightInfo floor = HeightInfo::fromFloor(sector, end.position);
+    const HeightInfo ceiling = HeightInfo::fromCeiling(sector, end.position);
+    const auto d = end.position - start.position;
+    if(floor.y < end.position.Y && floor.y > start.position.Y)
+    {
+        end.position.Y = floor.y;
+        end.position.X = d.X * (floor.y - start.position.Y) / d.Y + start.position.X;
+        end.position.Z = d.Z * (floor.y - start.position.Y) / d.Y + start.position.Z;
+        return false;
+    }
+    if(ceiling.y > end.position.Y && ceiling.y < start.position.Y)
+    {
+        end.position.Y = ceiling.y;
+        end.position.X = d.X * (ceiling.y - start.position.Y) / d.Y + start.position.X;
+        end.position.Z = d.Z * (ceiling.y - start.position.Y) / d.Y + start.position.Z;
+        return false;
+    }
+
+    return !minorClamped && dominantClamp == ClampType::None;
+}
+} // namespace twopass
+
+struct Ray
+{
+    core::RoomBoundPosition start;
+    core::RoomBoundPosition end;
+};
+
+std::vector<Ray> getRays(const TwoRooms& level, const size_t count, const std::mt19937::result_type seed)
+{
+    std::mt19937 rng{seed};
+    std::vector<Ray> rays;
+    while(rays.size() < count)
+    {
+        const auto x = static_cast<int>(1 + rng() % (TwoRooms::Width - 2));
+        const auto z = static_cast<int>(1 + rng() % (TwoRooms::Depth - 2));
+        if(level.walls[TwoRooms::Depth * x + z])
+            continue;
+
+        core::TRVec start{core::SectorSize * x + core::Length{static_cast<core::Length::type>(rng() % 1024)},
+                          0_len,
+                          core::SectorSize * z + core::Length{static_cast<core::Length::type>(rng() % 1024)}};
+        gsl::not_null<const loader::file::Room*> room = &level.rooms[0];
+        const auto sector = loader::file::findRealFloorSector(start, &room);
+        const auto floor = HeightInfo::fromFloor(sector, start).y;
+        const auto ceiling = HeightInfo::fromCeiling(sector, start).y;
+        if(floor <= ceiling)
+            continue;
+        start.Y = ceiling + core::Length{static_cast<core::Length::type>(rng() % (floor - ceiling).get())};
+
+        const core::TRVec end
+            = start
+              + core::TRVec{core::Length{static_cast<core::Length::type>(rng() % 8193) - 4096},
+                            core::Length{static_cast<core::Length::type>(rng() % 2049) - 1024},
+                            core::Length{static_cast<core::Length::type>(rng() % 8193) - 4096}};
+        if(end.X < 0_len || end.Z < 0_len)
+            continue;
+
+        rays.emplace_back(Ray{core::RoomBoundPosition{room, start}, core::RoomBoundPosition{room, end}});
+    }
+    return rays;
+}
+
+bool isSamePosition(const core::TRVec& a, const core::TRVec& b)
+{
+    return a.X == b.X && a.Y == b.Y && a.Z == b.Z;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(camera_clamp_tests)
+
+BOOST_AUTO_TEST_CASE(test_clamp_matches_two_passes)
+{
+    static constexpr size_t Rays = 20000;
+
+    const TwoRooms level{4711};
+    const auto rays = getRays(level, Rays, 815);
+
+    size_t minorClamped = 0;
+    for(const auto& ray : rays)
+    {
+        auto expectedEnd = ray.end;
+        bool expectedMinorClamped = false;
+        const auto expectedResult = twopass::clampPosition(ray.start, expectedEnd, expectedMinorClamped);
+        if(expectedMinorClamped)
+            ++minorClamped;
+
+        auto end = ray.end;
+        const auto result = CameraController::clampPosition(ray.start, end);
+
+        BOOST_CHECK_EQUAL(expectedResult, result);
+        BOOST_CHECK(isSamePosition(expectedEnd.position, end.position));
+        BOOST_CHECK(expectedEnd.room == end.room);
+    }
+
+    // the dominant axis walks towards the end clamped along the minor axis, so both cases must be covered
+    BOOST_CHECK_GT(minorClamped, 0u);
+    BOOST_CHECK_LT(minorClamped, rays.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+//! A square grid of boxes on the same floor, each overlapping its four neighbours, with some of them blocked.
+struct BoxGrid
+{
+    static constexpr int Size = 12;
+
+    std::vector<loader::file::Box> boxes;
+    std::vector<uint16_t> overlaps;
+
+    explicit BoxGrid(const std::mt19937::result_type seed)
+    {
+        std::mt19937 rng{seed};
+
+        boxes.resize(Size * Size);
+        for(int x = 0; x < Size; ++x)
+        {
+            for(int z = 0; z < Size; ++z)
+            {
+                auto& box = boxes[Size * x + z];
+                box.xmin = core::SectorSize * x;
+                box.xmax = core::SectorSize * (x + 1) - 1_len;
+                box.zmin = core::SectorSize * z;
+                box.zmax = core::SectorSize * (z + 1) - 1_len;
+                box.blocked = rng() % 8 == 0;
+                box.blockable = false;
+                box.overlap_index = gsl::narrow<uint16_t>(overlaps.size());
+
+                if(x > 0)
+                    overlaps.emplace_back(gsl::narrow<uint16_t>(Size * (x - 1) + z));
+                if(x < Size - 1)
+                    overlaps.emplace_back(gsl::narrow<uint16_t>(Size * (x + 1) + z));
+                if(z > 0)
+                    overlaps.emplace_back(gsl::narrow<uint16_t>(Size * x + z - 1));
+                if(z < Size - 1)
+                    overlaps.emplace_back(gsl::narrow<uint16_t>(Size * x + z + 1));
+                overlaps.back() |= 0x8000u;
+            }
+        }
+    }
+
+    ai::BoxGraph getGraph() const
+    {
+        return ai::BoxGraph{boxes, overlaps, false};
+    }
+};
+
+struct SearchRun
+{
+    std::vector<ai::LotInfo> lots;
+    std::vector<size_t> expandedPerTick;
+    std::vector<std::chrono::nanoseconds> durationPerTick;
+};
+
+/**
+ * @brief Lets creatures chase targets moving to random boxes, the way Engine::update advances them.
+ * @param think The think phase to run each tick, as Engine::updateCreaturePaths does.
+ * @param jobs The pool to run the think phase on.
+ *
+ * @details
+ * Each tick, the think phase advances the searches of the creatures having a target first.  Then, as updateMood
+ * would, each creature gets a new target every @a retargetInterval ticks, until @a settleTicks before the end so that
+ * all searches can finish, and the search for it starts with the rest of its share.  The targets don't depend on the
+ * searches, so all runs chase the same targets.
+ */
+SearchRun runCreatures(const BoxGrid& grid,
+                       const size_t creatures,
+                       const size_t ticks,
+                       const size_t retargetInterval,
+                       const size_t settleTicks,
+                       ai::ThinkPhase& think,
+                       util::JobSystem& jobs)
+{
+    std::mt19937 rng{1234};
+    const auto graph = grid.getGraph();
+
+    SearchRun run;
+    for(size_t i = 0; i < creatures; ++i)
+        run.lots.emplace_back(grid.boxes);
+
+    for(size_t tick = 0; tick < ticks; ++tick)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        think.begin();
+        for(auto& lot : run.lots)
+            think.add(lot);
+        think.run(graph, jobs);
+
+        for(size_t i = 0; i < creatures; ++i)
+        {
+            if(tick + settleTicks >= ticks || tick % retargetInterval != i % retargetInterval)
+                continue;
+
+            const loader::file::Box* target;
+            do
+            {
+                target = &grid.boxes[rng() % grid.boxes.size()];
+            } while(target->blocked);
+
+            run.lots[i].required_box = target;
+            think.searchNewTarget(run.lots[i], graph);
+        }
+
+        run.durationPerTick.emplace_back(std::chrono::high_resolution_clock::now() - start);
+        run.expandedPerTick.emplace_back(think.getBudget().getExpanded());
+    }
+
+    think.begin();
+    return run;
+}
+
+//! The boxes from which the creature's finished search found a path to the target.
+std::vector<bool> getReachable(const BoxGrid& grid, const ai::LotInfo& lot)
+{
+    BOOST_REQUIRE(lot.target_box != nullptr);
+    const auto revision = lot.getNode(lot.target_box).search_revision;
+
+    std::vector<bool> reachable;
+    for(const auto& box : grid.boxes)
+    {
+        const auto& node = lot.getNode(&box);
+        reachable.emplace_back(node.search_revision == revision && !node.blocked);
+        if(!reachable.back() || &box == lot.target_box)
+            continue;
+
+        // the exits must lead to the target
+        const loader::file::Box* current = &box;
+        for(size_t steps = 0; current != lot.target_box && current != nullptr && steps < grid.boxes.size(); ++steps)
+            current = lot.getNode(current).exit_box;
+        BOOST_CHECK(current == lot.target_box);
+    }
+    return reachable;
+}
+
+std::chrono::nanoseconds getPercentile(std::vector<std::chrono::nanoseconds> durations, const size_t percentile)
+{
+    std::sort(durations.begin(), durations.end());
+    return durations[(durations.size() - 1) * percentile / 100];
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(path_search_tests)
+
+BOOST_AUTO_TEST_CASE(test_budget_is_shared_fairly)
+{
+    for(const size_t searches : {1u, 6u, 7u, 33u, 100u})
+    {
+        ai::SearchBudget budget{32};
+        std::vector<size_t> granted(searches, 0);
+        for(int tick = 0; tick < 1000; ++tick)
+        {
+            budget.nextTick();
+            size_t total = 0;
+            for(auto& perSearch : granted)
+            {
+                const auto share = budget.acquire(5);
+                perSearch += share;
+                total += share;
+            }
+            BOOST_CHECK_LE(total, 32u);
+            budget.recordExpanded(total);
+        }
+        budget.nextTick();
+
+        // without the budget being exhausted, each search gets the full depth
+        if(searches * 5 <= 32)
+            BOOST_CHECK_EQUAL(*std::min_element(granted.begin(), granted.end()), 5000u);
+
+        // nobody starves, and the shares differ by less than a tick's worth of nodes
+        const auto minMax = std::minmax_element(granted.begin(), granted.end());
+        BOOST_CHECK_GT(*minMax.first, 0u);
+        BOOST_CHECK_LE(*minMax.second - *minMax.first, 32u);
+
+        const auto& histogram = budget.getHistogram();
+        BOOST_CHECK_EQUAL(std::accumulate(histogram.begin(), histogram.end(), size_t{0}), 1000u);
+        BOOST_CHECK_EQUAL(histogram.back(), 0u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_many_creatures)
+{
+    // a headless stand-in for a level full of wolves and rats; each tick is timed like the "ai-think" zone
+    static constexpr size_t Creatures = 64;
+    static constexpr size_t Ticks = 3000;
+    static constexpr size_t RetargetInterval = 60;
+    static constexpr size_t SettleTicks = 1500;
+
+    const BoxGrid grid{4711};
+
+    util::JobSystem jobs{1};
+    // every search gets its full depth of 5 nodes per tick
+    ai::ThinkPhase unlimited{Creatures * 5};
+    const auto unbudgeted = runCreatures(grid, Creatures, Ticks, RetargetInterval, SettleTicks, unlimited, jobs);
+    ai::ThinkPhase think{32};
+    const auto budgeted = runCreatures(grid, Creatures, Ticks, RetargetInterval, SettleTicks, think, jobs);
+
+    for(size_t i = 0; i < Creatures; ++i)
+    {
+        // all searches finished and found paths from the same boxes
+        BOOST_REQUIRE(unbudgeted.lots[i].head == nullptr);
+        BOOST_REQUIRE(budgeted.lots[i].head == nullptr);
+        BOOST_CHECK(unbudgeted.lots[i].target_box == budgeted.lots[i].target_box);
+        BOOST_CHECK(getReachable(grid, unbudgeted.lots[i]) == getReachable(grid, budgeted.lots[i]));
+    }
+
+    const auto& histogram = think.getBudget().getHistogram();
+    BOOST_CHECK_EQUAL(std::accumulate(histogram.begin(), histogram.end(), size_t{0}), Ticks);
+    BOOST_CHECK_EQUAL(histogram.back(), 0u);
+    BOOST_CHECK_LE(*std::max_element(budgeted.expandedPerTick.begin(), budgeted.expandedPerTick.end()), 32u);
+
+    std::ostringstream buckets;
+    for(size_t expanded = 0; expanded < histogram.size(); ++expanded)
+    {
+        if(histogram[expanded] != 0)
+            buckets << " " << expanded << ":" << histogram[expanded];
+    }
+
+    const auto worstUnbudgeted = *std::max_element(unbudgeted.expandedPerTick.begin(), unbudgeted.expandedPerTick.end());
+    BOOST_TEST_MESSAGE(Creatures << " creatures, " << Ticks << " ticks; worst tick without the budget: "
+                                 << worstUnbudgeted << " nodes, "
+                                 << getPercentile(unbudgeted.durationPerTick, 100).count() << "ns (p50 "
+                                 << getPercentile(unbudgeted.durationPerTick, 50).count()
+                                 << "ns); worst tick with the budget: "
+                                 << getPercentile(budgeted.durationPerTick, 100).count() << "ns (p50 "
+                                 << getPercentile(budgeted.durationPerTick, 50).count()
+                                 << "ns); expanded nodes:ticks with the budget" << buckets.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_think_phase_does_not_depend_on_thread_count)
+{
+    static constexpr size_t Creatures = 64;
+    static constexpr size_t Ticks = 1000;
+
+    const BoxGrid grid{4711};
+
+    util::JobSystem oneThread{1};
+    ai::ThinkPhase oneThreadThink{32};
+    const auto serial = runCreatures(grid, Creatures, Ticks, 25, 0, oneThreadThink, oneThread);
+
+    util::JobSystem manyThreads{8};
+    ai::ThinkPhase manyThreadsThink{32};
+    const auto parallel = runCreatures(grid, Creatures, Ticks, 25, 0, manyThreadsThink, manyThreads);
+
+    BOOST_CHECK(serial.expandedPerTick == parallel.expandedPerTick);
+    BOOST_CHECK(oneThreadThink.getBudget().getHistogram() == manyThreadsThink.getBudget().getHistogram());
+    for(size_t i = 0; i < Creatures; ++i)
+    {
+        const auto& a = serial.lots[i];
+        const auto& b = parallel.lots[i];
+        BOOST_CHECK(a.head == b.head);
+        BOOST_CHECK(a.tail == b.tail);
+        BOOST_CHECK(a.target_box == b.target_box);
+        BOOST_CHECK_EQUAL(a.m_searchVersion, b.m_searchVersion);
+        BOOST_CHECK_EQUAL(a.searchShare, b.searchShare);
+        for(const auto& box : grid.boxes)
+        {
+            const auto& nodeA = a.getNode(&box);
+            const auto& nodeB = b.getNode(&box);
+            BOOST_CHECK(nodeA.exit_box == nodeB.exit_box);
+            BOOST_CHECK_EQUAL(nodeA.search_revision, nodeB.search_revision);
+            BOOST_CHECK_EQUAL(nodeA.blocked, nodeB.blocked);
+            BOOST_CHECK(nodeA.next_expansion == nodeB.next_expansion);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+/**
+ * @brief Rooms of random size scattered over a grid of sector columns, with random portals between overlapping rooms.
+ *
+ * @details
+ * Portals only lead to rooms with a higher index, so each column's portal chain ends, but may pass several rooms.
+ */
+struct ScatteredRooms
+{
+    static constexpr int WorldSize = 16;
+
+    std::vector<loader::file::Room> rooms;
+
+    explicit ScatteredRooms(const std::mt19937::result_type seed)
+    {
+        std::mt19937 rng{seed};
+
+        rooms.resize(8);
+        for(auto& room : rooms)
+        {
+            room.sectorCountX = 3 + static_cast<int>(rng() % 8);
+            room.sectorCountZ = 3 + static_cast<int>(rng() % 8);
+            room.position = core::TRVec{core::SectorSize * static_cast<int>(rng() % (WorldSize - room.sectorCountX)),
+                                        0_len,
+                                        core::SectorSize * static_cast<int>(rng() % (WorldSize - room.sectorCountZ))};
+            room.sectors.resize(room.sectorCountX * room.sectorCountZ);
+        }
+
+        for(size_t i = 0; i < rooms.size(); ++i)
+        {
+            auto& room = rooms[i];
+            for(int x = 0; x < room.sectorCountX; ++x)
+            {
+                for(int z = 0; z < room.sectorCountZ; ++z)
+                {
+                    if(rng() % 3 != 0)
+                        continue;
+
+                    // find a later room containing the column
+                    const auto column = room.position
+                                        + core::TRVec{core::SectorSize * x, 0_len, core::SectorSize * z};
+                    std::vector<uint16_t> candidates;
+                    for(size_t j = i + 1; j < rooms.size(); ++j)
+                    {
+                        const auto local = column - rooms[j].position;
+                        if(local.X >= 0_len && local.X < core::SectorSize * rooms[j].sectorCountX
+                           && local.Z >= 0_len && local.Z < core::SectorSize * rooms[j].sectorCountZ)
+                            candidates.emplace_back(gsl::narrow<uint16_t>(j));
+                    }
+                    if(candidates.empty())
+                        continue;
+
+                    const auto target = candidates[rng() % candidates.size()];
+                    room.sectors[room.sectorCountZ * x + z].portalTarget = &rooms[target];
+
+                    loader::file::Portal portal;
+                    portal.adjoining_room = target;
+                    room.portals.emplace_back(portal);
+                }
+            }
+        }
+
+        loader::file::updateRoomCaches(rooms);
+    }
+};
+
+//! Follows the portals one by one, the way findRealFloorSector did before the portal chains were cached.
+const loader::file::Sector* findPortalSectorUncached(const core::TRVec& position,
+                                                     const loader::file::Room*& room)
+{
+    while(true)
+    {
+        const auto sector = room->findFloorSectorWithClampedIndex((position.X - room->position.X) / core::SectorSize,
+                                                                  (position.Z - room->position.Z) / core::SectorSize);
+        if(sector->portalTarget == nullptr)
+            return sector;
+
+        room = sector->portalTarget;
+    }
+}
+
+/**
+ * @brief Checks the cached portal chain of every sector against an uncached walk.
+ * @return The number of sectors whose chain passes more than one portal.
+ */
+size_t checkPortalChains(const std::vector<loader::file::Room>& rooms)
+{
+    size_t chained = 0;
+    for(const auto& room : rooms)
+    {
+        for(int x = 0; x < room.sectorCountX; ++x)
+        {
+            for(int z = 0; z < room.sectorCountZ; ++z)
+            {
+                const auto& sector = room.sectors[room.sectorCountZ * x + z];
+                if(sector.portalTarget == nullptr)
+                {
+                    BOOST_CHECK(sector.portalSector == nullptr);
+                    BOOST_CHECK(sector.portalRoom == nullptr);
+                    continue;
+                }
+
+                const auto center = room.position
+                                    + core::TRVec{core::SectorSize * x + core::SectorSize / 2,
+                                                  0_len,
+                                                  core::SectorSize * z + core::SectorSize / 2};
+                // the clamped lookup may not return edge sectors, so start with the sector's own portal
+                const loader::file::Room* expectedRoom = sector.portalTarget;
+                const auto expectedSector = findPortalSectorUncached(center, expectedRoom);
+                BOOST_CHECK(sector.portalSector == expectedSector);
+                BOOST_CHECK(sector.portalRoom == expectedRoom);
+                if(sector.portalTarget != expectedRoom)
+                    ++chained;
+            }
+        }
+    }
+    return chained;
+}
+
+//! Checks that findRealFloorSector, starting in @a room, finds the same sector and room as an uncached walk.
+void checkRealFloorSector(const core::TRVec& position, const loader::file::Room& room)
+{
+    gsl::not_null<const loader::file::Room*> cachedRoom = &room;
+    const auto cachedSector = loader::file::findRealFloorSector(position, &cachedRoom);
+    const loader::file::Room* expectedRoom = &room;
+    const auto expectedSector = findPortalSectorUncached(position, expectedRoom);
+    BOOST_CHECK(cachedSector == expectedSector);
+    BOOST_CHECK(cachedRoom.get() == expectedRoom);
+}
+
+//! Checks that the touching rooms of each room are the room itself and the rooms its portals lead to.
+void checkTouchingRooms(const std::vector<loader::file::Room>& rooms)
+{
+    for(const auto& room : rooms)
+    {
+        std::set<const loader::file::Room*> expected{&room};
+        for(const auto& portal : room.portals)
+            expected.emplace(&rooms.at(portal.adjoining_room.get()));
+
+        BOOST_CHECK(std::is_sorted(room.touchingRooms.begin(), room.touchingRooms.end()));
+        BOOST_CHECK(std::equal(room.touchingRooms.begin(),
+                               room.touchingRooms.end(),
+                               expected.begin(),
+                               expected.end(),
+                               [](const auto& a, const auto& b) { return a.get() == b; }));
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(room_cache_tests)
+
+BOOST_AUTO_TEST_CASE(test_portal_chains_match_uncached_walk)
+{
+    for(const std::mt19937::result_type seed : {1u, 2u, 3u, 4u, 5u})
+    {
+        const ScatteredRooms level{seed};
+        BOOST_CHECK_GT(checkPortalChains(level.rooms), 0u);
+
+        // positions outside the room are clamped to its boundary, and don't take the cached chain
+        std::mt19937 rng{seed};
+        for(int i = 0; i < 10000; ++i)
+        {
+            const auto& room = level.rooms[rng() % level.rooms.size()];
+            const core::TRVec position{
+                core::SectorSize * -2 + core::Length{static_cast<core::Length::type>(rng() % (20 * 1024))},
+                core::Length{static_cast<core::Length::type>(rng() % 4096) - 2048},
+                core::SectorSize * -2 + core::Length{static_cast<core::Length::type>(rng() % (20 * 1024))}};
+            checkRealFloorSector(position, room);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_touching_rooms_match_portals)
+{
+    for(const std::mt19937::result_type seed : {1u, 2u, 3u, 4u, 5u})
+    {
+        const ScatteredRooms level{seed};
+        checkTouchingRooms(level.rooms);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_level_caches_match_uncached_walk)
+{
+    const auto level
+        = loader::file::level::Level::createLoader(ENGINE_TEST_LEVEL, loader::file::level::Game::Unknown);
+    BOOST_REQUIRE(level != nullptr);
+    level->loadFileData();
+    BOOST_REQUIRE(!level->m_rooms.empty());
+
+    checkPortalChains(level->m_rooms);
+    checkTouchingRooms(level->m_rooms);
+
+    // the corners and the center of every sector, and one sector beyond each edge of the room
+    static constexpr std::array<core::Length::type, 3> Offsets{
+        {1, core::SectorSize.get() / 2, core::SectorSize.get() - 1}};
+    for(const auto& room : level->m_rooms)
+    {
+        for(int x = -1; x <= room.sectorCountX; ++x)
+        {
+            for(int z = -1; z <= room.sectorCountZ; ++z)
+            {
+                for(const auto dx : Offsets)
+                {
+                    for(const auto dz : Offsets)
+                    {
+                        const auto position = room.position
+                                              + core::TRVec{core::SectorSize * x + core::Length{dx},
+                                                            0_len,
+                                                            core::SectorSize * z + core::Length{dz}};
+                        BOOST_TEST_CONTEXT("room " << &room - level->m_rooms.data() << ", sector " << x << "/" << z)
+                        {
+                            checkRealFloorSector(position, room);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,9 +6,38 @@
 
 namespace hid
 {
+namespace
+{
+void recordInputEvent(GLFWwindow* window)
+{
+    auto handler = static_cast<InputHandler*>(glfwGetWindowUserPointer(window));
+    if(handler == nullptr)
+        return;
+
+    handler->getLatencyTracker().recordEvent(InputLatencyTracker::Clock::now());
+}
+
+void keyCallback(GLFWwindow* window, int /*key*/, int /*scancode*/, const int action, int /*mods*/)
+{
+    if(action == GLFW_REPEAT)
+        return;
+
+    recordInputEvent(window);
+}
+
+void mouseButtonCallback(GLFWwindow* window, int /*button*/, int /*action*/, int /*mods*/)
+{
+    recordInputEvent(window);
+}
+} // namespace
+
 InputHandler::InputHandler(const gsl::not_null<GLFWwindow*>& window)
     : m_window{window}
 {
+    glfwSetWindowUserPointer(m_window, this);
+    glfwSetKeyCallback(m_window, &keyCallback);
+    glfwSetMouseButtonCallback(m_window, &mouseButtonCallback);
+
     glfwGetCursorPos(m_window, &m_lastCursorX, &m_lastCursorY);
 
     for(auto i = GLFW_JOYSTICK_1; i <= GLFW_JOYSTICK_LAST; ++i)
@@ -29,6 +58,13 @@ InputHandler::InputHandler(const gsl::not_null<GLFWwindow*>& window)
     }
 }
 
+InputHandler::~InputHandler()
+{
+    glfwSetKeyCallback(m_window, nullptr);
+    glfwSetMouseButtonCallback(m_window, nullptr);
+    glfwSetWindowUserPointer(m_window, nullptr);
+}
+
 #define PS1_TRIANGLE GLFW_GAMEPAD_BUTTON_Y
 #define PS1_SQUARE GLFW_GAMEPAD_BUTTON_X
 #define PS1_CIRCLE GLFW_GAMEPAD_BUTTON_B
@@ -42,6 +78,8 @@ void InputHandler::update()
 {
     static const constexpr float AxisThreshold = 0.5f;
 
+    glfwPollEvents();
+
     GLFWgamepadstate gamepadState;
     if(m_controllerIndex >= 0)
         glfwGetGamepadState(m_controllerIndex, &gamepadState);
@@ -93,6 +131,7 @@ void InputHandler::update()
                             || (m_controllerIndex >= 0 && gamepadState.buttons[PS1_L1] == GLFW_PRESS);
 
     m_inputState.debug = glfwGetKey(m_window, GLFW_KEY_F11) == GLFW_PRESS;
+    m_inputState.ssao = glfwGetKey(m_window, GLFW_KEY_F9) == GLFW_PRESS;
 
     m_inputState._1 = glfwGetKey(m_window, GLFW_KEY_1) == GLFW_PRESS
                       || (m_controllerIndex >= 0 && gamepadState.axes[GLFW_GAMEPAD_AXIS_RIGHT_Y] < -AxisThreshold);
@@ -136,5 +175,7 @@ void InputHandler::update()
     m_inputState.setXAxisMovement(left, right);
     m_inputState.setZAxisMovement(backward, forward);
     m_inputState.setStepMovement(stepLeft, stepRight);
+
+    m_latencyTracker.consume(InputLatencyTracker::Clock::now());
 }
 } // namespace hid
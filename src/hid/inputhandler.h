@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gsl-lite.hpp"
+#include "inputlatency.h"
 #include "inputstate.h"
 
 #include <GLFW/glfw3.h>
@@ -12,6 +13,18 @@ class InputHandler final
 public:
     explicit InputHandler(const gsl::not_null<GLFWwindow*>& window);
 
+    InputHandler(const InputHandler&) = delete;
+
+    InputHandler& operator=(const InputHandler&) = delete;
+
+    ~InputHandler();
+
+    /**
+     * @brief Polls pending window events and samples the current input state.
+     *
+     * Should be called immediately before the simulation tick consuming the input state, so that
+     * events arriving while the previous frame was rendered or throttled are not delayed by a full frame.
+     */
     void update();
 
     const InputState& getInputState() const
@@ -19,8 +32,19 @@ public:
         return m_inputState;
     }
 
+    const InputLatencyTracker& getLatencyTracker() const
+    {
+        return m_latencyTracker;
+    }
+
+    InputLatencyTracker& getLatencyTracker()
+    {
+        return m_latencyTracker;
+    }
+
 private:
     InputState m_inputState{};
+    InputLatencyTracker m_latencyTracker{};
 
     const gsl::not_null<GLFWwindow*> m_window;
     double m_lastCursorX = 0;
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "gsl-lite.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace hid
+{
+/**
+ * @brief Measures the time between an input event arriving and the simulation tick consuming it.
+ *
+ * Events are recorded with the time they were received, and are resolved into latency samples
+ * when a tick consumes the current input state.  The tracker does not depend on GLFW, so it can
+ * be fed with synthetic events and time points.
+ */
+class InputLatencyTracker final
+{
+public:
+    using Clock = std::chrono::high_resolution_clock;
+    using Duration = std::chrono::microseconds;
+
+    explicit InputLatencyTracker(const size_t maxSamples = 1024)
+        : m_maxSamples{maxSamples}
+    {
+        Expects(m_maxSamples > 0);
+        m_samples.reserve(m_maxSamples);
+        m_pending.reserve(64);
+    }
+
+    void recordEvent(const Clock::time_point& receivedAt)
+    {
+        m_pending.emplace_back(receivedAt);
+    }
+
+    void consume(const Clock::time_point& tick)
+    {
+        for(const auto& receivedAt : m_pending)
+        {
+            const auto latency = std::chrono::duration_cast<Duration>(tick - receivedAt);
+            const auto sample = std::max(latency, Duration::zero());
+            if(m_samples.size() < m_maxSamples)
+                m_samples.emplace_back(sample);
+            else
+                m_samples[m_nextSample] = sample;
+
+            m_nextSample = (m_nextSample + 1) % m_maxSamples;
+        }
+
+        m_pending.clear();
+    }
+
+    size_t getSampleCount() const
+    {
+        return m_samples.size();
+    }
+
+    /**
+     * @param[in] p Percentile in the range [0, 100].
+     * @return The latency of the given percentile of the recorded samples, or zero if there are none.
+     */
+    Duration getPercentile(const float p) const
+    {
+        Expects(p >= 0 && p <= 100);
+
+        if(m_samples.empty())
+            return Duration::zero();
+
+        auto sorted = m_samples;
+        const auto idx = std::min(sorted.size() - 1, static_cast<size_t>(p / 100 * sorted.size()));
+        std::nth_element(sorted.begin(), sorted.begin() + idx, sorted.end());
+        return sorted[idx];
+    }
+
+    void reset()
+    {
+        m_pending.clear();
+        m_samples.clear();
+        m_nextSample = 0;
+    }
+
+private:
+    const size_t m_maxSamples;
+    std::vector<Clock::time_point> m_pending;
+    std::vector<Duration> m_samples;
+    size_t m_nextSample = 0;
+};
+} // namespace hid
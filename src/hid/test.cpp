@@ -0,0 +1,118 @@
+#define BOOST_TEST_MODULE hid_test
+
+#include "inputlatency.h"
+
+#include <boost/test/included/unit_test.hpp>
+
+gsl_api void gsl::fail_fast_assert_handler(char const* const /*expression*/,
+                                           char const* const message,
+                                           char const* const /*file*/,
+                                           int /*line*/)
+{
+    throw gsl::fail_fast(message);
+}
+
+using namespace hid;
+
+namespace
+{
+using Clock = InputLatencyTracker::Clock;
+using Duration = InputLatencyTracker::Duration;
+
+Clock::time_point at(const int64_t us)
+{
+    return Clock::time_point{} + std::chrono::microseconds{us};
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(input_latency_tests)
+
+BOOST_AUTO_TEST_CASE(test_no_samples)
+{
+    InputLatencyTracker tracker;
+    BOOST_CHECK_EQUAL(tracker.getSampleCount(), 0u);
+    BOOST_CHECK(tracker.getPercentile(50) == Duration::zero());
+
+    // a tick without pending events doesn't add samples
+    tracker.consume(at(1000));
+    BOOST_CHECK_EQUAL(tracker.getSampleCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_percentiles)
+{
+    InputLatencyTracker tracker;
+    tracker.recordEvent(at(1000));
+    tracker.recordEvent(at(900));
+    tracker.recordEvent(at(800));
+    tracker.recordEvent(at(700));
+    tracker.consume(at(1100));
+
+    BOOST_REQUIRE_EQUAL(tracker.getSampleCount(), 4u);
+    BOOST_CHECK_EQUAL(tracker.getPercentile(0).count(), 100);
+    BOOST_CHECK_EQUAL(tracker.getPercentile(25).count(), 200);
+    BOOST_CHECK_EQUAL(tracker.getPercentile(50).count(), 300);
+    BOOST_CHECK_EQUAL(tracker.getPercentile(100).count(), 400);
+}
+
+BOOST_AUTO_TEST_CASE(test_events_are_consumed_once)
+{
+    InputLatencyTracker tracker;
+    tracker.recordEvent(at(0));
+    tracker.consume(at(500));
+    tracker.consume(at(16000));
+    BOOST_CHECK_EQUAL(tracker.getSampleCount(), 1u);
+    BOOST_CHECK_EQUAL(tracker.getPercentile(100).count(), 500);
+
+    // events received after a tick are resolved by the next one
+    tracker.recordEvent(at(17000));
+    tracker.consume(at(33000));
+    BOOST_CHECK_EQUAL(tracker.getSampleCount(), 2u);
+    BOOST_CHECK_EQUAL(tracker.getPercentile(100).count(), 16000);
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_latency_is_clamped)
+{
+    InputLatencyTracker tracker;
+    tracker.recordEvent(at(2000));
+    tracker.consume(at(1000));
+    BOOST_REQUIRE_EQUAL(tracker.getSampleCount(), 1u);
+    BOOST_CHECK(tracker.getPercentile(100) == Duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(test_oldest_samples_are_replaced)
+{
+    InputLatencyTracker tracker{4};
+    for(int64_t i = 1; i <= 6; ++i)
+    {
+        tracker.recordEvent(at(0));
+        tracker.consume(at(i * 100));
+    }
+
+    // the samples of 100us and 200us were overwritten by 500us and 600us
+    BOOST_REQUIRE_EQUAL(tracker.getSampleCount(), 4u);
+    BOOST_CHECK_EQUAL(tracker.getPercentile(0).count(), 300);
+    BOOST_CHECK_EQUAL(tracker.getPercentile(100).count(), 600);
+}
+
+BOOST_AUTO_TEST_CASE(test_reset)
+{
+    InputLatencyTracker tracker;
+    tracker.recordEvent(at(0));
+    tracker.consume(at(100));
+    tracker.recordEvent(at(200));
+    tracker.reset();
+    BOOST_CHECK_EQUAL(tracker.getSampleCount(), 0u);
+
+    // the pending event was dropped, too
+    tracker.consume(at(300));
+    BOOST_CHECK_EQUAL(tracker.getSampleCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_percentile)
+{
+    InputLatencyTracker tracker;
+    BOOST_CHECK_THROW(tracker.getPercentile(-1), gsl::fail_fast);
+    BOOST_CHECK_THROW(tracker.getPercentile(101), gsl::fail_fast);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
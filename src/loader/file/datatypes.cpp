@@ -2,15 +2,17 @@
 
 #include "engine/engine.h"
 #include "level/level.h"
+#include "meshoptimizer.h"
 #include "render/gl/vertexarray.h"
+#include "render/roombatch.h"
 #include "render/scene/Material.h"
-#include "render/scene/Sprite.h"
 #include "render/scene/mesh.h"
 #include "render/scene/names.h"
 #include "render/textureanimator.h"
 #include "util.h"
 #include "util/helpers.h"
 
+#include <algorithm>
 #include <boost/range/adaptors.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -20,72 +22,23 @@ namespace file
 {
 namespace
 {
-#pragma pack(push, 1)
+using RenderVertex = render::RoomBatch::Vertex;
 
-struct RenderVertex
-{
-    glm::vec3 position;
-    glm::vec4 color{1.0f};
-    glm::vec3 normal{0.0f};
-
-    static const render::gl::StructureLayout<RenderVertex>& getLayout()
-    {
-        static const render::gl::StructureLayout<RenderVertex> layout{
-            {VERTEX_ATTRIBUTE_POSITION_NAME, &RenderVertex::position},
-            {VERTEX_ATTRIBUTE_NORMAL_NAME, &RenderVertex::normal},
-            {VERTEX_ATTRIBUTE_COLOR_NAME, &RenderVertex::color}};
-
-        return layout;
-    }
-};
+static_assert(sizeof(RenderVertex) == 16, "Room vertices should fit into 16 bytes");
 
-#pragma pack(pop)
-
-struct MeshPart
+//! A room vertex along with its separately stored texture coordinates, used as the key for welding.
+struct WeldedVertex
 {
-    using IndexBuffer = std::vector<uint16_t>;
-    static_assert(std::is_unsigned<IndexBuffer::value_type>::value, "Index buffer entries must be unsigned");
-
-    IndexBuffer indices;
-    std::shared_ptr<render::scene::Material> material;
+    RenderVertex vertex;
+    glm::u16vec2 uv{0};
+    //! Animated vertices may only be shared if they follow the same corner of the same animated tile.
+    uint32_t animation = 0;
 };
 
-struct RenderModel
-{
-    std::vector<MeshPart> m_parts;
-
-    std::shared_ptr<render::scene::Model>
-        toModel(const gsl::not_null<std::shared_ptr<render::gl::StructuredArrayBuffer<RenderVertex>>>& vbuf,
-                const gsl::not_null<std::shared_ptr<render::gl::StructuredArrayBuffer<glm::vec2>>>& uvBuf)
-    {
-        auto model = std::make_shared<render::scene::Model>();
-
-        for(const MeshPart& localPart : m_parts)
-        {
-#ifndef NDEBUG
-            for(auto idx : localPart.indices)
-            {
-                BOOST_ASSERT(idx < vbuf->size());
-            }
-#endif
-
-            auto indexBuffer = std::make_shared<render::gl::ElementArrayBuffer<uint16_t>>();
-            indexBuffer->setData(localPart.indices, ::gl::BufferUsageARB::StaticDraw);
-
-            std::vector<gsl::not_null<std::shared_ptr<render::gl::ElementArrayBuffer<uint16_t>>>> indexBufs{
-                indexBuffer};
-            auto vBufs = std::make_tuple(vbuf, uvBuf);
-
-            auto mesh = std::make_shared<render::scene::MeshImpl<uint16_t, RenderVertex, glm::vec2>>(
-                std::make_shared<render::gl::VertexArray<uint16_t, RenderVertex, glm::vec2>>(
-                    indexBufs, vBufs, localPart.material->getShaderProgram()->getHandle()));
-            mesh->setMaterial(localPart.material);
-            model->addMesh(mesh);
-        }
+static_assert(sizeof(WeldedVertex) == 24, "Welded vertices must not contain padding");
 
-        return model;
-    }
-};
+//! Bytes per room vertex in the float layout used before packing: position, RGBA color and normal, plus the UVs.
+constexpr size_t UnpackedVertexBytes = 2 * sizeof(glm::vec3) + sizeof(glm::vec4) + sizeof(glm::vec2);
 
 template<size_t N>
 core::TRVec getCenter(const std::array<VertexIndex, N>& faceVertices, const std::vector<RoomVertex>& roomVertices)
@@ -106,22 +59,21 @@ void Room::createSceneNode(
     const level::Level& level,
     const std::map<TextureKey, gsl::not_null<std::shared_ptr<render::scene::Material>>>& materials,
     const std::map<TextureKey, gsl::not_null<std::shared_ptr<render::scene::Material>>>& waterMaterials,
-    const std::vector<gsl::not_null<std::shared_ptr<render::scene::Model>>>& staticMeshModels,
+    const std::map<size_t, render::InstanceBatch::Prototype>& staticMeshPrototypes,
+    const std::vector<render::InstanceBatch::Prototype>& spritePrototypes,
     render::TextureAnimator& animator,
-    const std::shared_ptr<render::scene::Material>& spriteMaterial,
-    const std::shared_ptr<render::scene::Material>& portalMaterial)
+    render::RoomBatch& roomBatch,
+    render::InstanceBatch& instanceBatch,
+    const std::shared_ptr<render::scene::Material>& portalMaterial,
+    MeshStats& stats)
 {
-    RenderModel renderModel;
+    std::vector<render::RoomBatch::Part> parts;
     std::map<TextureKey, size_t> texBuffers;
-    std::vector<RenderVertex> vbufData;
-    std::vector<glm::vec2> uvCoordsData;
-
-    const auto label = "Room:" + std::to_string(roomId);
-    auto vbuf = std::make_shared<render::gl::StructuredArrayBuffer<RenderVertex>>(RenderVertex::getLayout(), label);
+    VertexWelder<WeldedVertex> welder;
 
-    static const render::gl::StructureLayout<glm::vec2> uvAttribs{
-        {VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME, render::gl::StructureMember<glm::vec2>::Trivial{}}};
-    auto uvCoords = std::make_shared<render::gl::StructuredArrayBuffer<glm::vec2>>(uvAttribs, label + "-uv");
+    // vertex indices are relative to the room, but the animator needs to know where they end up in the batch
+    const auto baseVertex = roomBatch.getVertexCount();
+    const auto& uvCoords = roomBatch.getUvBuffer();
 
     for(const QuadFace& quad : rectangles)
     {
@@ -145,46 +97,49 @@ void Room::createSceneNode(
 
         if(texBuffers.find(tile.textureKey) == texBuffers.end())
         {
-            texBuffers[tile.textureKey] = renderModel.m_parts.size();
+            texBuffers[tile.textureKey] = parts.size();
 
-            renderModel.m_parts.emplace_back();
+            parts.emplace_back();
 
             auto it = isWaterRoom() ? waterMaterials.at(tile.textureKey) : materials.at(tile.textureKey);
-            renderModel.m_parts.back().material = it;
+            parts.back().material = it;
         }
         const auto partId = texBuffers[tile.textureKey];
 
-        const auto firstVertex = vbufData.size();
+        std::array<uint16_t, 4> corners{};
         for(int i = 0; i < 4; ++i)
         {
-            RenderVertex iv;
-            iv.position = quad.vertices[i].from(vertices).position.toRenderSystem();
-            iv.color = quad.vertices[i].from(vertices).color;
-            uvCoordsData.push_back(tile.uvCoordinates[i].toGl());
+            WeldedVertex wv;
+            wv.uv = tile.uvCoordinates[i].toPackedGl();
+            if(animator.isAnimated(quad.tileId))
+                wv.animation = (uint32_t{quad.tileId.get()} << 2u) + i + 1;
+
+            RenderVertex& iv = wv.vertex;
+            iv.position = packPosition(quad.vertices[i].from(vertices).position.toRenderSystem());
+            iv.color = packColor(quad.vertices[i].from(vertices).color);
 
             if(i <= 2)
             {
                 static const int indices[3] = {0, 1, 2};
-                iv.normal = generateNormal(quad.vertices[indices[(i + 0) % 3]].from(vertices).position,
-                                           quad.vertices[indices[(i + 1) % 3]].from(vertices).position,
-                                           quad.vertices[indices[(i + 2) % 3]].from(vertices).position);
+                iv.normal = packNormal(generateNormal(quad.vertices[indices[(i + 0) % 3]].from(vertices).position,
+                                                      quad.vertices[indices[(i + 1) % 3]].from(vertices).position,
+                                                      quad.vertices[indices[(i + 2) % 3]].from(vertices).position));
             }
             else
             {
                 static const int indices[3] = {0, 2, 3};
-                iv.normal = generateNormal(quad.vertices[indices[(i + 0) % 3]].from(vertices).position,
-                                           quad.vertices[indices[(i + 1) % 3]].from(vertices).position,
-                                           quad.vertices[indices[(i + 2) % 3]].from(vertices).position);
+                iv.normal = packNormal(generateNormal(quad.vertices[indices[(i + 0) % 3]].from(vertices).position,
+                                                      quad.vertices[indices[(i + 1) % 3]].from(vertices).position,
+                                                      quad.vertices[indices[(i + 2) % 3]].from(vertices).position));
             }
 
-            vbufData.push_back(iv);
+            corners[i] = welder.add(wv);
+            animator.registerVertex(quad.tileId, uvCoords, i, baseVertex + corners[i]);
         }
 
         for(int i : {0, 1, 2, 0, 2, 3})
         {
-            animator.registerVertex(quad.tileId, uvCoords, i, firstVertex + i);
-            renderModel.m_parts[partId].indices.emplace_back(
-                gsl::narrow<MeshPart::IndexBuffer::value_type>(firstVertex + i));
+            parts[partId].indices.emplace_back(corners[i]);
         }
     }
     for(const Triangle& tri : triangles)
@@ -209,51 +164,73 @@ void Room::createSceneNode(
 
         if(texBuffers.find(tile.textureKey) == texBuffers.end())
         {
-            texBuffers[tile.textureKey] = renderModel.m_parts.size();
+            texBuffers[tile.textureKey] = parts.size();
 
-            renderModel.m_parts.emplace_back();
+            parts.emplace_back();
 
             auto it = isWaterRoom() ? waterMaterials.at(tile.textureKey) : materials.at(tile.textureKey);
-            renderModel.m_parts.back().material = it;
+            parts.back().material = it;
         }
         const auto partId = texBuffers[tile.textureKey];
 
-        const auto firstVertex = vbufData.size();
         for(int i = 0; i < 3; ++i)
         {
-            RenderVertex iv;
-            iv.position = tri.vertices[i].from(vertices).position.toRenderSystem();
-            iv.color = tri.vertices[i].from(vertices).color;
-            uvCoordsData.push_back(tile.uvCoordinates[i].toGl());
+            WeldedVertex wv;
+            wv.uv = tile.uvCoordinates[i].toPackedGl();
+            if(animator.isAnimated(tri.tileId))
+                wv.animation = (uint32_t{tri.tileId.get()} << 2u) + i + 1;
+
+            RenderVertex& iv = wv.vertex;
+            iv.position = packPosition(tri.vertices[i].from(vertices).position.toRenderSystem());
+            iv.color = packColor(tri.vertices[i].from(vertices).color);
 
             static const int indices[3] = {0, 1, 2};
-            iv.normal = generateNormal(tri.vertices[indices[(i + 0) % 3]].from(vertices).position,
-                                       tri.vertices[indices[(i + 1) % 3]].from(vertices).position,
-                                       tri.vertices[indices[(i + 2) % 3]].from(vertices).position);
+            iv.normal = packNormal(generateNormal(tri.vertices[indices[(i + 0) % 3]].from(vertices).position,
+                                                  tri.vertices[indices[(i + 1) % 3]].from(vertices).position,
+                                                  tri.vertices[indices[(i + 2) % 3]].from(vertices).position));
 
-            vbufData.push_back(iv);
-        }
-
-        for(int i : {0, 1, 2})
-        {
-            animator.registerVertex(tri.tileId, uvCoords, i, firstVertex + i);
-            renderModel.m_parts[partId].indices.emplace_back(
-                gsl::narrow<MeshPart::IndexBuffer::value_type>(firstVertex + i));
+            const auto index = welder.add(wv);
+            animator.registerVertex(tri.tileId, uvCoords, i, baseVertex + index);
+            parts[partId].indices.emplace_back(index);
         }
     }
 
-    vbuf->setData(vbufData, ::gl::BufferUsageARB::StaticDraw);
-    uvCoords->setData(uvCoordsData, ::gl::BufferUsageARB::DynamicDraw);
+    std::vector<RenderVertex> vbufData;
+    std::vector<glm::u16vec2> uvCoordsData;
+    vbufData.reserve(welder.getVertices().size());
+    uvCoordsData.reserve(welder.getVertices().size());
+    for(const auto& wv : welder.getVertices())
+    {
+        vbufData.emplace_back(wv.vertex);
+        uvCoordsData.emplace_back(wv.uv);
+    }
 
-    auto resModel = renderModel.toModel(vbuf, uvCoords);
-    resModel->getRenderState().setCullFace(true);
-    resModel->getRenderState().setCullFaceSide(::gl::CullFaceMode::Back);
+    stats.vertices += vbufData.size();
+    stats.unpackedBytes += vbufData.size() * UnpackedVertexBytes;
+    for(auto& part : parts)
+    {
+        optimizeTriangleOrder(part.indices, vbufData.size());
+        stats.indices += part.indices.size();
+        stats.cacheMisses += countCacheMisses(part.indices);
+    }
 
     node = std::make_shared<render::scene::Node>("Room:" + std::to_string(roomId));
-    node->setDrawable(resModel);
+    roomBatch.addRoom(node, position.toRenderSystem(), vbufData, uvCoordsData, parts);
     node->addUniformSetter(
         "u_lightAmbient",
         [](const render::scene::Node& /*node*/, render::gl::ProgramUniform& uniform) { uniform.set(1.0f); });
+    node->setLocalMatrix(translate(glm::mat4{1.0f}, position.toRenderSystem()));
+
+    // placements are grouped by their geometry, so that each one is drawn once per room
+    std::map<size_t, std::vector<render::InstanceBatch::Instance>> staticMeshInstances;
+    std::map<size_t, std::vector<render::InstanceBatch::Instance>> spriteInstances;
+    boost::optional<render::scene::BoundingSphere> instancesSphere;
+    const auto enclose = [&instancesSphere](const render::scene::BoundingSphere& sphere) {
+        if(instancesSphere.is_initialized())
+            instancesSphere->enclose(sphere);
+        else
+            instancesSphere = sphere;
+    };
 
     for(const RoomStaticMesh& sm : staticMeshes)
     {
@@ -261,50 +238,54 @@ void Room::createSceneNode(
         if(idx < 0)
             continue;
 
-        auto subNode = std::make_shared<render::scene::Node>("staticMesh");
-        subNode->setDrawable(staticMeshModels.at(idx).get());
-        subNode->setLocalMatrix(translate(glm::mat4{1.0f}, (sm.position - position).toRenderSystem())
-                                * rotate(glm::mat4{1.0f}, toRad(sm.rotation), glm::vec3{0, -1, 0}));
-
-        subNode->addUniformSetter(
-            "u_lightAmbient",
-            [brightness = sm.getBrightness()](const render::scene::Node& /*node*/,
-                                              render::gl::ProgramUniform& uniform) { uniform.set(brightness); });
-        addChild(node, subNode);
+        const auto offset = (sm.position - position).toRenderSystem();
+        // the mesh rotates around the negative Y axis
+        staticMeshInstances[idx].emplace_back(
+            render::InstanceBatch::Instance{glm::vec4{offset, -toRad(sm.rotation)}, sm.getBrightness()});
+
+        const auto staticMesh = level.findStaticMeshById(sm.meshId);
+        BOOST_ASSERT(staticMesh != nullptr);
+        // cover all orientations, as the instances are only culled as a whole
+        const auto box = render::scene::BoundingSphere::fromBox(staticMesh->visibility_box.min.toRenderSystem(),
+                                                                staticMesh->visibility_box.max.toRenderSystem());
+        enclose(render::scene::BoundingSphere{offset, glm::length(box.center) + box.radius});
     }
-    node->setLocalMatrix(translate(glm::mat4{1.0f}, position.toRenderSystem()));
 
     for(const SpriteInstance& spriteInstance : sprites)
     {
         BOOST_ASSERT(spriteInstance.vertex.get() < vertices.size());
 
         const Sprite& sprite = level.m_sprites.at(spriteInstance.id.get());
-
-        const auto model = std::make_shared<render::scene::Sprite>(sprite.x0,
-                                                                   -sprite.y0,
-                                                                   sprite.x1,
-                                                                   -sprite.y1,
-                                                                   sprite.t0,
-                                                                   sprite.t1,
-                                                                   spriteMaterial,
-                                                                   render::scene::Sprite::Axis::Y);
-
-        auto spriteNode = std::make_shared<render::scene::Node>("sprite");
-        spriteNode->setDrawable(model);
         const RoomVertex& v = vertices.at(spriteInstance.vertex.get());
-        spriteNode->setLocalMatrix(translate(glm::mat4{1.0f}, v.position.toRenderSystem()));
-        spriteNode->addUniformSetter(
-            "u_diffuseTexture",
-            [texture = sprite.texture](const render::scene::Node& /*node*/, render::gl::ProgramUniform& uniform) {
-                uniform.set(*texture);
-            });
-        spriteNode->addUniformSetter(
-            "u_lightAmbient",
-            [brightness = v.getBrightness()](const render::scene::Node& /*node*/, render::gl::ProgramUniform& uniform) {
-                uniform.set(brightness);
-            });
-
-        addChild(node, spriteNode);
+        const auto offset = v.position.toRenderSystem();
+        spriteInstances[spriteInstance.id.get()].emplace_back(
+            render::InstanceBatch::Instance{glm::vec4{offset, 0.0f}, v.getBrightness()});
+        // the sprite rotates around its origin, so cover all orientations
+        enclose(render::scene::BoundingSphere{
+            offset,
+            glm::length(glm::vec2{std::max(std::abs(sprite.x0), std::abs(sprite.x1)),
+                                  std::max(std::abs(sprite.y0), std::abs(sprite.y1))})});
+    }
+
+    if(instancesSphere.is_initialized())
+    {
+        auto instancesNode = std::make_shared<render::scene::Node>("instances");
+        instancesNode->setBoundingSphere(instancesSphere);
+        for(const auto& instances : staticMeshInstances)
+        {
+            auto subNode = std::make_shared<render::scene::Node>("staticMeshes");
+            subNode->setDrawable(
+                instanceBatch.addInstances(staticMeshPrototypes.at(instances.first), instances.second).get());
+            addChild(instancesNode, subNode);
+        }
+        for(const auto& instances : spriteInstances)
+        {
+            auto subNode = std::make_shared<render::scene::Node>("sprites");
+            subNode->setDrawable(
+                instanceBatch.addInstances(spritePrototypes.at(instances.first), instances.second).get());
+            addChild(instancesNode, subNode);
+        }
+        addChild(node, instancesNode);
     }
     for(auto& portal : portals)
         portal.buildMesh(portalMaterial);
@@ -377,13 +358,25 @@ const Sector* findRealFloorSector(const core::TRVec& position, const gsl::not_nu
     // follow portals
     while(true)
     {
-        sector = (*room)->findFloorSectorWithClampedIndex((position.X - (*room)->position.X) / core::SectorSize,
-                                                          (position.Z - (*room)->position.Z) / core::SectorSize);
+        const auto localPos = position - (*room)->position;
+        const auto dx = localPos.X / core::SectorSize;
+        const auto dz = localPos.Z / core::SectorSize;
+        sector = (*room)->findFloorSectorWithClampedIndex(dx, dz);
         if(sector->portalTarget == nullptr)
         {
             break;
         }
 
+        // the cached portal chain is only valid if the position is within the sector's column, i.e. it wasn't
+        // clamped to the room's boundary
+        if(localPos.X >= 0_len && localPos.Z >= 0_len && dx < (*room)->sectorCountX && dz < (*room)->sectorCountZ
+           && sector == &(*room)->sectors[(*room)->sectorCountZ * dx + dz])
+        {
+            *room = sector->portalRoom;
+            sector = sector->portalSector;
+            break;
+        }
+
         *room = sector->portalTarget;
     }
 
@@ -412,5 +405,58 @@ const Sector* findRealFloorSector(const core::TRVec& position, const gsl::not_nu
 
     return sector;
 }
+
+void updateRoomCaches(std::vector<Room>& rooms)
+{
+    // the sectors above and below only depend on the horizontal position, so the sector centers can be used
+    for(Room& room : rooms)
+    {
+        for(int x = 0; x < room.sectorCountX; ++x)
+        {
+            for(int z = 0; z < room.sectorCountZ; ++z)
+            {
+                Sector& sector = room.sectors[room.sectorCountZ * x + z];
+                const auto center = room.position
+                                    + core::TRVec{core::SectorSize * x + core::SectorSize / 2,
+                                                  0_len,
+                                                  core::SectorSize * z + core::SectorSize / 2};
+
+                sector.floorSector = &sector;
+                while(sector.floorSector != nullptr && sector.floorSector->roomBelow != nullptr)
+                    sector.floorSector = sector.floorSector->roomBelow->getSectorByAbsolutePosition(center);
+
+                sector.ceilingSector = &sector;
+                while(sector.ceilingSector != nullptr && sector.ceilingSector->roomAbove != nullptr)
+                    sector.ceilingSector = sector.ceilingSector->roomAbove->getSectorByAbsolutePosition(center);
+
+                // rooms are aligned to the sector grid, so all positions within the column reach the same sector
+                sector.portalSector = nullptr;
+                sector.portalRoom = nullptr;
+                if(sector.portalTarget != nullptr)
+                {
+                    const Room* portalRoom = &room;
+                    const Sector* portalSector = &sector;
+                    while(portalSector->portalTarget != nullptr)
+                    {
+                        portalRoom = portalSector->portalTarget;
+                        portalSector = portalRoom->findFloorSectorWithClampedIndex(
+                            (center.X - portalRoom->position.X) / core::SectorSize,
+                            (center.Z - portalRoom->position.Z) / core::SectorSize);
+                    }
+                    sector.portalSector = portalSector;
+                    sector.portalRoom = portalRoom;
+                }
+            }
+        }
+
+        room.touchingRooms.clear();
+        room.touchingRooms.emplace_back(&room);
+        for(const Portal& portal : room.portals)
+            room.touchingRooms.emplace_back(&rooms.at(portal.adjoining_room.get()));
+        std::sort(room.touchingRooms.begin(), room.touchingRooms.end());
+        room.touchingRooms.erase(std::unique(room.touchingRooms.begin(), room.touchingRooms.end()),
+                                 room.touchingRooms.end());
+    }
+}
 } // namespace file
 } // namespace loader
@@ -7,11 +7,13 @@
 #include "core/id.h"
 #include "core/magic.h"
 #include "core/vec.h"
-#include "engine/floordata/types.h"
+#include "engine/floordata/floordata.h"
 #include "gsl-lite.hpp"
 #include "io/sdlreader.h"
 #include "meshes.h"
+#include "meshoptimizer.h"
 #include "primitives.h"
+#include "render/instancebatch.h"
 #include "render/scene/Node.h"
 #include "render/scene/mesh.h"
 #include "render/scene/model.h"
@@ -42,6 +44,11 @@ class ItemNode;
 }
 } // namespace engine
 
+namespace render
+{
+class RoomBatch;
+}
+
 namespace loader
 {
 namespace file
@@ -115,6 +122,8 @@ struct Sector
      */
     core::ContainerIndex<uint16_t, engine::floordata::FloorDataValue> floorDataIndex;
     const engine::floordata::FloorDataValue* floorData = nullptr;
+    //! @a floorData, decoded; shared with all sectors using the same floor data.
+    const engine::floordata::DecodedFloorData* decodedFloorData = nullptr;
     Room* portalTarget = nullptr;
 
     core::BoxId boxIndex{int16_t(-1)}; //!< Index into Boxes[]/Zones[] (-1 if none)
@@ -126,6 +135,14 @@ struct Sector
     Room* roomAbove = nullptr;
     core::Length ceilingHeight
         = -core::HeightLimit; //!< Absolute height of ceiling (multiply by 256 for world coordinates)
+    //! The bottom-most sector of this sector's column, following roomBelow.
+    const Sector* floorSector = nullptr;
+    //! The top-most sector of this sector's column, following roomAbove.
+    const Sector* ceilingSector = nullptr;
+    //! The sector reached by following all portals from this sector's column, or @c nullptr if there's no portal.
+    const Sector* portalSector = nullptr;
+    //! The room of @a portalSector.
+    const Room* portalRoom = nullptr;
 
     static Sector read(io::SDLReader& reader)
     {
@@ -143,6 +160,7 @@ struct Sector
     {
         floorDataIndex = 0;
         floorData = nullptr;
+        decodedFloorData = nullptr;
         portalTarget = nullptr; // cached from floordata
         boxIndex = int16_t(-1);
         box = nullptr;
@@ -152,6 +170,10 @@ struct Sector
         roomIndexAbove = uint8_t(-1);
         roomAbove = nullptr;
         ceilingHeight = -core::HeightLimit;
+        floorSector = nullptr;
+        ceilingSector = nullptr;
+        portalSector = nullptr;
+        portalRoom = nullptr;
     }
 };
 
@@ -574,6 +596,8 @@ struct Room
     std::vector<SpriteInstance> sprites;
 
     std::vector<Portal> portals;
+    //! This room and all rooms adjoining it through portals, sorted by address.
+    std::vector<gsl::not_null<const Room*>> touchingRooms;
 
     int sectorCountZ;            // "width" of sector list
     int sectorCountX;            // "height" of sector list
@@ -1120,10 +1144,13 @@ struct Room
         const level::Level& level,
         const std::map<TextureKey, gsl::not_null<std::shared_ptr<render::scene::Material>>>& materials,
         const std::map<TextureKey, gsl::not_null<std::shared_ptr<render::scene::Material>>>& waterMaterials,
-        const std::vector<gsl::not_null<std::shared_ptr<render::scene::Model>>>& staticMeshModels,
+        const std::map<size_t, render::InstanceBatch::Prototype>& staticMeshPrototypes,
+        const std::vector<render::InstanceBatch::Prototype>& spritePrototypes,
         render::TextureAnimator& animator,
-        const std::shared_ptr<render::scene::Material>& spriteMaterial,
-        const std::shared_ptr<render::scene::Material>& portalMaterial);
+        render::RoomBatch& roomBatch,
+        render::InstanceBatch& instanceBatch,
+        const std::shared_ptr<render::scene::Material>& portalMaterial,
+        MeshStats& stats);
 
     const Sector* getSectorByAbsolutePosition(const core::TRVec& worldPos) const
     {
@@ -1236,6 +1263,14 @@ inline const Sector* findRealFloorSector(core::RoomBoundPosition& rbs)
     return findRealFloorSector(rbs.position, &rbs.room);
 }
 
+/**
+ * @brief Updates the sectors' cached floor, ceiling and portal sectors, and the rooms' touching rooms.
+ *
+ * @details
+ * The sectors' @a roomAbove, @a roomBelow and @a portalTarget must already be set.
+ */
+extern void updateRoomCaches(std::vector<Room>& rooms);
+
 struct Sprite
 {
     core::TextureId texture_id{uint16_t(0)};
@@ -10,6 +10,7 @@
 #include "render/textureanimator.h"
 #include "util/md5.h"
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/range/adaptors.hpp>
@@ -295,7 +296,13 @@ void Level::updateRoomBasedCaches()
             {
                 sector.floorData = &sector.floorDataIndex.from(m_floorData);
 
-                const auto portalTarget = engine::floordata::getPortalTarget(sector.floorData);
+                // floor data never changes, so it only needs to be decoded once
+                auto it = m_decodedFloorData.find(sector.floorDataIndex.index);
+                if(it == m_decodedFloorData.end())
+                    it = m_decodedFloorData.emplace(sector.floorDataIndex.index, sector.floorData).first;
+                sector.decodedFloorData = &it->second;
+
+                const auto& portalTarget = sector.decodedFloorData->portalTarget;
                 if(portalTarget.is_initialized())
                 {
                     sector.portalTarget = &m_rooms.at(*portalTarget);
@@ -307,6 +314,8 @@ void Level::updateRoomBasedCaches()
             }
         }
     }
+
+    updateRoomCaches(m_rooms);
 }
 
 void Level::postProcessDataStructures()
@@ -116,6 +116,8 @@ public:
     std::string m_sfxPath = "MAIN.SFX";
 
     engine::floordata::FloorData m_floorData;
+    //! Decoded floor data, keyed by the index into m_floorData.
+    std::map<uint16_t, engine::floordata::DecodedFloorData> m_decodedFloorData;
     std::vector<Mesh> m_meshes;
     std::vector<StaticMesh> m_staticMeshes;
     std::vector<uint16_t> m_animatedTextures;
@@ -9,6 +9,7 @@
 #include "render/textureanimator.h"
 #include "util.h"
 
+#include <array>
 #include <utility>
 
 namespace loader
@@ -27,16 +28,21 @@ Mesh::ModelBuilder::ModelBuilder(
     , m_materials{materials}
     , m_colorMaterial{std::move(colorMaterial)}
     , m_palette{palette}
-    , m_vb{std::make_shared<render::gl::StructuredArrayBuffer<RenderVertex>>(RenderVertex::getFormat(), label)}
+    , m_vb{std::make_shared<render::gl::StructuredArrayBuffer<PackedVertex>>(PackedVertex::getFormat(), label)}
     , m_label{std::move(label)}
 {
 }
 
 Mesh::ModelBuilder::~ModelBuilder() = default;
 
-void Mesh::ModelBuilder::append(const RenderVertex& v)
+Mesh::ModelBuilder::MeshPart::IndexBuffer::value_type Mesh::ModelBuilder::append(const RenderVertex& v)
 {
-    m_vertices.emplace_back(v);
+    PackedVertex packed;
+    packed.position = packPosition(v.position);
+    packed.normal = packNormal(v.normal);
+    packed.color = packColor(glm::vec4{v.color, 1.0f});
+    packed.uv = glm::packUnorm<uint16_t>(v.uv);
+    return m_vertices.add(packed);
 }
 
 void Mesh::ModelBuilder::append(const Mesh& mesh)
@@ -65,7 +71,7 @@ void Mesh::ModelBuilder::append(const Mesh& mesh)
             }
         }
 
-        const auto firstVertex = m_vertices.size();
+        std::array<MeshPart::IndexBuffer::value_type, 4> corners{};
         for(int i = 0; i < 4; ++i)
         {
             RenderVertex iv{};
@@ -97,12 +103,12 @@ void Mesh::ModelBuilder::append(const Mesh& mesh)
 
             iv.position = quad.vertices[i].from(mesh.vertices).toRenderSystem();
             iv.uv = tile.uvCoordinates[i].toGl();
-            append(iv);
+            corners[i] = append(iv);
         }
 
         for(auto i : {0, 1, 2, 0, 2, 3})
         {
-            m_parts[partId].indices.emplace_back(gsl::narrow<MeshPart::IndexBuffer::value_type>(firstVertex + i));
+            m_parts[partId].indices.emplace_back(corners[i]);
         }
     }
     for(const QuadFace& quad : mesh.colored_rectangles)
@@ -125,7 +131,7 @@ void Mesh::ModelBuilder::append(const Mesh& mesh)
             }
         }
 
-        const auto firstVertex = m_vertices.size();
+        std::array<MeshPart::IndexBuffer::value_type, 4> corners{};
         for(int i = 0; i < 4; ++i)
         {
             RenderVertex iv{};
@@ -156,11 +162,11 @@ void Mesh::ModelBuilder::append(const Mesh& mesh)
                     iv.normal = defaultNormal;
             }
             iv.uv = tile.uvCoordinates[i].toGl();
-            append(iv);
+            corners[i] = append(iv);
         }
         for(auto i : {0, 1, 2, 0, 2, 3})
         {
-            m_parts[partId].indices.emplace_back(gsl::narrow<MeshPart::IndexBuffer::value_type>(firstVertex + i));
+            m_parts[partId].indices.emplace_back(corners[i]);
         }
     }
     for(const Triangle& tri : mesh.textured_triangles)
@@ -202,8 +208,7 @@ void Mesh::ModelBuilder::append(const Mesh& mesh)
                 if(iv.normal == glm::vec3{0.0f})
                     iv.normal = defaultNormal;
             }
-            m_parts[partId].indices.emplace_back(gsl::narrow<MeshPart::IndexBuffer::value_type>(m_vertices.size()));
-            append(iv);
+            m_parts[partId].indices.emplace_back(append(iv));
         }
     }
     for(const Triangle& tri : mesh.colored_triangles)
@@ -247,33 +252,39 @@ void Mesh::ModelBuilder::append(const Mesh& mesh)
                     iv.normal = defaultNormal;
             }
             iv.uv = tile.uvCoordinates[i].toGl();
-            m_parts[partId].indices.emplace_back(gsl::narrow<MeshPart::IndexBuffer::value_type>(m_vertices.size()));
-            append(iv);
+            m_parts[partId].indices.emplace_back(append(iv));
         }
     }
 }
 
-gsl::not_null<std::shared_ptr<render::scene::Model>> Mesh::ModelBuilder::finalize()
+gsl::not_null<std::shared_ptr<render::scene::Model>> Mesh::ModelBuilder::finalize(MeshStats& stats)
 {
-    m_vb->setData(m_vertices, ::gl::BufferUsageARB::StaticDraw);
+    const auto& vertices = m_vertices.getVertices();
+    m_vb->setData(vertices, ::gl::BufferUsageARB::StaticDraw);
+    stats.vertices += vertices.size();
+    stats.unpackedBytes += vertices.size() * sizeof(RenderVertex);
 
     auto model = std::make_shared<render::scene::Model>();
-    for(const MeshPart& localPart : m_parts)
+    for(MeshPart& localPart : m_parts)
     {
+        optimizeTriangleOrder(localPart.indices, vertices.size());
+        stats.indices += localPart.indices.size();
+        stats.cacheMisses += countCacheMisses(localPart.indices);
+
 #ifndef NDEBUG
         for(auto idx : localPart.indices)
         {
-            BOOST_ASSERT(idx < m_vertices.size());
+            BOOST_ASSERT(idx < vertices.size());
         }
 #endif
 
-        auto indexBuffer = std::make_shared<render::gl::ElementArrayBuffer<uint16_t>>();
-        indexBuffer->setData(localPart.indices, ::gl::BufferUsageARB::DynamicDraw);
+        localPart.indexBuffer = std::make_shared<render::gl::ElementArrayBuffer<uint16_t>>();
+        localPart.indexBuffer->setData(localPart.indices, ::gl::BufferUsageARB::DynamicDraw);
 
-        auto va = std::make_shared<render::gl::VertexArray<uint16_t, RenderVertex>>(
-            indexBuffer, m_vb, localPart.material->getShaderProgram()->getHandle(), m_label);
+        auto va = std::make_shared<render::gl::VertexArray<uint16_t, PackedVertex>>(
+            localPart.indexBuffer, m_vb, localPart.material->getShaderProgram()->getHandle(), m_label);
         auto mesh
-            = std::make_shared<render::scene::MeshImpl<uint16_t, RenderVertex>>(va, ::gl::PrimitiveType::Triangles);
+            = std::make_shared<render::scene::MeshImpl<uint16_t, PackedVertex>>(va, ::gl::PrimitiveType::Triangles);
         mesh->setMaterial(localPart.material);
 
         model->addMesh(mesh);
@@ -282,18 +293,31 @@ gsl::not_null<std::shared_ptr<render::scene::Model>> Mesh::ModelBuilder::finaliz
     return model;
 }
 
-std::shared_ptr<render::scene::Model>
-    Mesh::createModel(const std::vector<TextureTile>& textureTiles,
-                      const std::map<TextureKey, gsl::not_null<std::shared_ptr<render::scene::Material>>>& materials,
-                      const gsl::not_null<std::shared_ptr<render::scene::Material>>& colorMaterial,
-                      const Palette& palette,
-                      const std::string& label) const
+render::InstanceBatch::Prototype Mesh::ModelBuilder::createInstancePrototype(
+    const render::InstanceBatch& instances,
+    const std::map<TextureKey, gsl::not_null<std::shared_ptr<render::scene::Material>>>& materials,
+    const gsl::not_null<std::shared_ptr<render::scene::Material>>& colorMaterial) const
 {
-    ModelBuilder mb{!normals.empty(), textureTiles, materials, colorMaterial, palette, label};
+    using InstancedArray = render::gl::VertexArray<uint16_t, PackedVertex, render::InstanceBatch::Instance>;
 
-    mb.append(*this);
+    render::InstanceBatch::Prototype prototype;
+    for(const MeshPart& localPart : m_parts)
+    {
+        Expects(localPart.indexBuffer != nullptr);
+
+        const auto material = localPart.color.is_initialized() ? colorMaterial : materials.at(localPart.textureKey);
+        auto va = std::make_shared<InstancedArray>(InstancedArray::IndexBuffers{localPart.indexBuffer},
+                                                   InstancedArray::VertexBuffers{m_vb, instances.getInstanceBuffer()},
+                                                   material->getShaderProgram()->getHandle(),
+                                                   m_label);
+        prototype.emplace_back(render::InstanceBatch::Part{va,
+                                                           render::gl::TypeTraits<uint16_t>::DrawElementsType,
+                                                           localPart.indexBuffer->size(),
+                                                           0,
+                                                           material});
+    }
 
-    return mb.finalize();
+    return prototype;
 }
 } // namespace file
 } // namespace loader
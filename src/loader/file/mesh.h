@@ -3,7 +3,9 @@
 #include "color.h"
 #include "core/vec.h"
 #include "io/util.h"
+#include "meshoptimizer.h"
 #include "primitives.h"
+#include "render/instancebatch.h"
 #include "render/scene/mesh.h"
 #include "render/scene/names.h"
 #include "texture.h"
@@ -104,27 +106,39 @@ struct Mesh
             glm::vec3 normal;
             glm::vec3 color{1.0f};
             glm::vec2 uv;
+        };
+
+        //! The vertex buffer format of a RenderVertex; 20 bytes instead of 44.
+        struct PackedVertex
+        {
+            glm::i16vec3 position{0};
+            int16_t padding = 0;
+            render::gl::Snorm3x10 normal;
+            glm::u8vec4 color{255};
+            glm::u16vec2 uv{0};
 
-            static const render::gl::StructureLayout<RenderVertex>& getFormat()
+            static const render::gl::StructureLayout<PackedVertex>& getFormat()
             {
-                static const render::gl::StructureLayout<RenderVertex> attribs{
-                    {VERTEX_ATTRIBUTE_POSITION_NAME, &RenderVertex::position},
-                    {VERTEX_ATTRIBUTE_NORMAL_NAME, &RenderVertex::normal},
-                    {VERTEX_ATTRIBUTE_COLOR_NAME, &RenderVertex::color},
-                    {VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME, &RenderVertex::uv}};
+                static const render::gl::StructureLayout<PackedVertex> attribs{
+                    {VERTEX_ATTRIBUTE_POSITION_NAME, &PackedVertex::position},
+                    {VERTEX_ATTRIBUTE_NORMAL_NAME, {&PackedVertex::normal, true}},
+                    {VERTEX_ATTRIBUTE_COLOR_NAME, {&PackedVertex::color, true}},
+                    {VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME, {&PackedVertex::uv, true}}};
 
                 return attribs;
             }
         };
 
+        static_assert(sizeof(PackedVertex) == 20, "Model vertices should fit into 20 bytes");
+
         const bool m_hasNormals;
-        std::vector<RenderVertex> m_vertices;
+        VertexWelder<PackedVertex> m_vertices;
         const std::vector<TextureTile>& m_textureTiles;
         const std::map<TextureKey, gsl::not_null<std::shared_ptr<render::scene::Material>>>& m_materials;
         const gsl::not_null<std::shared_ptr<render::scene::Material>> m_colorMaterial;
         const Palette& m_palette;
         std::map<TextureKey, size_t> m_texBuffers;
-        std::shared_ptr<render::gl::StructuredArrayBuffer<RenderVertex>> m_vb;
+        std::shared_ptr<render::gl::StructuredArrayBuffer<PackedVertex>> m_vb;
         const std::string m_label;
 
         struct MeshPart
@@ -134,11 +148,15 @@ struct Mesh
             IndexBuffer indices;
             std::shared_ptr<render::scene::Material> material;
             boost::optional<glm::vec3> color;
+            TextureKey textureKey;
+            //! Created when finalizing.
+            std::shared_ptr<render::gl::ElementArrayBuffer<uint16_t>> indexBuffer;
         };
 
         std::vector<MeshPart> m_parts;
 
-        void append(const RenderVertex& v);
+        //! Returns the index of the (welded) vertex.
+        MeshPart::IndexBuffer::value_type append(const RenderVertex& v);
 
         size_t getPartForColor(const core::TextureTileId tileId)
         {
@@ -155,6 +173,7 @@ struct Mesh
                 m_parts.emplace_back();
                 m_parts.back().material = m_colorMaterial;
                 m_parts.back().color = color;
+                m_parts.back().textureKey = tk;
             }
 
             return m_texBuffers[tk];
@@ -167,6 +186,7 @@ struct Mesh
                 m_texBuffers[tile.textureKey] = m_parts.size();
                 m_parts.emplace_back();
                 m_parts.back().material = m_materials.at(tile.textureKey);
+                m_parts.back().textureKey = tile.textureKey;
             }
             return m_texBuffers[tile.textureKey];
         }
@@ -184,15 +204,20 @@ struct Mesh
 
         void append(const Mesh& mesh);
 
-        gsl::not_null<std::shared_ptr<render::scene::Model>> finalize();
+        gsl::not_null<std::shared_ptr<render::scene::Model>> finalize(MeshStats& stats);
+
+        /**
+         * @brief Creates vertex arrays for drawing the finalized geometry through @a instances.
+         *
+         * @details
+         * The geometry is shared with the model returned by #finalize; only the materials are replaced by the
+         * ones from @a materials and @a colorMaterial, which must be compiled for instancing.
+         */
+        render::InstanceBatch::Prototype createInstancePrototype(
+            const render::InstanceBatch& instances,
+            const std::map<TextureKey, gsl::not_null<std::shared_ptr<render::scene::Material>>>& materials,
+            const gsl::not_null<std::shared_ptr<render::scene::Material>>& colorMaterial) const;
     };
-
-    std::shared_ptr<render::scene::Model>
-        createModel(const std::vector<TextureTile>& textureTiles,
-                    const std::map<TextureKey, gsl::not_null<std::shared_ptr<render::scene::Material>>>& materials,
-                    const gsl::not_null<std::shared_ptr<render::scene::Material>>& colorMaterial,
-                    const Palette& palette,
-                    const std::string& label = {}) const;
 };
 } // namespace file
 } // namespace loader
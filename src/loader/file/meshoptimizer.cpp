@@ -0,0 +1,205 @@
+#include "meshoptimizer.h"
+
+#include <algorithm>
+#include <boost/assert.hpp>
+#include <cmath>
+
+namespace loader
+{
+namespace file
+{
+namespace
+{
+constexpr size_t CacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+float getVertexScore(const int cachePosition, const uint32_t remainingTriangles)
+{
+    if(remainingTriangles == 0)
+        return -1; // not used by any triangle that's still to be emitted
+
+    float score = 0;
+    if(cachePosition >= 0)
+    {
+        if(cachePosition < 3)
+        {
+            // the vertices of the triangle just emitted get a fixed score, so that the optimizer doesn't
+            // prefer strips over fans
+            score = LastTriangleScore;
+        }
+        else
+        {
+            const auto scaler = 1.0f / (CacheSize - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+        }
+    }
+
+    // prefer vertices with few remaining triangles, so that they can leave the cache for good
+    return score + ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+}
+} // namespace
+
+void optimizeTriangleOrder(std::vector<uint16_t>& indices, const size_t vertexCount)
+{
+    Expects(indices.size() % 3 == 0);
+
+    const auto triangleCount = indices.size() / 3;
+    if(triangleCount < 2)
+        return;
+
+    // a vertex used more than once by a degenerate triangle is only counted for its first use, here as well as
+    // when the triangle is emitted
+    const auto isRepeated = [&indices](const size_t i) {
+        const auto first = i - i % 3;
+        return std::find(indices.begin() + first, indices.begin() + i, indices[i]) != indices.begin() + i;
+    };
+
+    // triangles using each vertex; the first remainingTriangles[v] entries are the ones not emitted yet
+    std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+    for(size_t i = 0; i < indices.size(); ++i)
+    {
+        Expects(indices[i] < vertexCount);
+        if(!isRepeated(i))
+            ++remainingTriangles[indices[i]];
+    }
+
+    std::vector<size_t> firstTriangle(vertexCount + 1, 0);
+    for(size_t v = 0; v < vertexCount; ++v)
+        firstTriangle[v + 1] = firstTriangle[v] + remainingTriangles[v];
+
+    std::vector<uint32_t> vertexTriangles(firstTriangle.back());
+    {
+        std::vector<size_t> fill{firstTriangle.begin(), firstTriangle.end() - 1};
+        for(size_t i = 0; i < indices.size(); ++i)
+        {
+            if(!isRepeated(i))
+                vertexTriangles[fill[indices[i]]++] = gsl::narrow<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for(size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = getVertexScore(-1, remainingTriangles[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    size_t best = 0;
+    for(size_t t = 0; t < triangleCount; ++t)
+    {
+        triangleScore[t] = vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]]
+                           + vertexScore[indices[3 * t + 2]];
+        if(triangleScore[t] > triangleScore[best])
+            best = t;
+    }
+
+    std::vector<uint16_t> result;
+    result.reserve(indices.size());
+    std::vector<uint16_t> cache;
+    cache.reserve(CacheSize + 3);
+    std::vector<uint16_t> newCache;
+    newCache.reserve(CacheSize + 3);
+    size_t nextUnemitted = 0;
+
+    while(true)
+    {
+        emitted[best] = true;
+        newCache.clear();
+        for(size_t k = 0; k < 3; ++k)
+        {
+            const auto v = indices[3 * best + k];
+            result.emplace_back(v);
+
+            if(isRepeated(3 * best + k))
+                continue;
+
+            newCache.emplace_back(v);
+            const auto begin = vertexTriangles.begin() + firstTriangle[v];
+            const auto end = begin + remainingTriangles[v];
+            const auto it = std::find(begin, end, best);
+            BOOST_ASSERT(it != end);
+            std::iter_swap(it, end - 1);
+            --remainingTriangles[v];
+        }
+
+        if(result.size() == indices.size())
+            break;
+
+        for(const auto v : cache)
+        {
+            if(std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+                newCache.emplace_back(v);
+        }
+
+        // vertices pushed out of the cache need their scores updated, too
+        for(size_t i = 0; i < newCache.size(); ++i)
+        {
+            const auto v = newCache[i];
+            cachePosition[v] = i < CacheSize ? gsl::narrow<int>(i) : -1;
+            vertexScore[v] = getVertexScore(cachePosition[v], remainingTriangles[v]);
+        }
+
+        float bestScore = -1;
+        for(size_t i = 0; i < newCache.size(); ++i)
+        {
+            const auto v = newCache[i];
+            for(size_t j = 0; j < remainingTriangles[v]; ++j)
+            {
+                const auto t = vertexTriangles[firstTriangle[v] + j];
+                if(emitted[t])
+                    continue;
+
+                triangleScore[t] = vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]]
+                                   + vertexScore[indices[3 * t + 2]];
+                if(i < CacheSize && triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        if(newCache.size() > CacheSize)
+            newCache.resize(CacheSize);
+        std::swap(cache, newCache);
+
+        if(bestScore < 0)
+        {
+            // nothing left in the cache; instead of searching all triangles for the best one, which would make
+            // this quadratic, just continue with the next one in the input order
+            while(emitted[nextUnemitted])
+                ++nextUnemitted;
+            best = nextUnemitted;
+        }
+    }
+
+    indices = std::move(result);
+}
+
+size_t countCacheMisses(const std::vector<uint16_t>& indices, const size_t cacheSize)
+{
+    Expects(cacheSize > 0);
+
+    if(indices.empty())
+        return 0;
+
+    // a FIFO only changes on misses, so the number of misses at insertion time tells whether a vertex has been
+    // pushed out already
+    std::vector<size_t> insertedAt(*std::max_element(indices.begin(), indices.end()) + 1, 0);
+    size_t misses = 0;
+    for(const auto index : indices)
+    {
+        if(insertedAt[index] != 0 && misses - insertedAt[index] < cacheSize)
+            continue;
+
+        ++misses;
+        insertedAt[index] = misses;
+    }
+
+    return misses;
+}
+} // namespace file
+} // namespace loader
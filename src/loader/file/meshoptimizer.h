@@ -0,0 +1,113 @@
+#pragma once
+
+#include "gsl-lite.hpp"
+
+#include <boost/functional/hash.hpp>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace loader
+{
+namespace file
+{
+/**
+ * @brief Level geometry statistics, accumulated over the meshes of a level.
+ */
+struct MeshStats
+{
+    size_t vertices = 0;
+    size_t indices = 0;
+    //! Post-transform cache misses, see #countCacheMisses.
+    size_t cacheMisses = 0;
+    //! Vertex buffer bytes the vertices would take in the float layout they had before they were packed.
+    size_t unpackedBytes = 0;
+
+    //! Average cache miss ratio, i.e. transformed vertices per triangle; 0.5 is the optimum for regular grids.
+    float getAcmr() const
+    {
+        if(indices == 0)
+            return 0;
+
+        return static_cast<float>(cacheMisses) * 3 / indices;
+    }
+
+    MeshStats& operator+=(const MeshStats& rhs)
+    {
+        vertices += rhs.vertices;
+        indices += rhs.indices;
+        cacheMisses += rhs.cacheMisses;
+        unpackedBytes += rhs.unpackedBytes;
+        return *this;
+    }
+};
+
+/**
+ * @brief Deduplicates bytewise identical vertices.
+ *
+ * @details
+ * Vertices are compared by their object representation, so @a T must not contain any implicit padding.
+ */
+template<typename T>
+class VertexWelder final
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Vertices must be trivially copyable");
+
+public:
+    using Index = uint16_t;
+
+    //! Returns the index of an identical vertex added before, or appends @a vertex.
+    Index add(const T& vertex)
+    {
+        const auto it = m_indices.find(vertex);
+        if(it != m_indices.end())
+            return it->second;
+
+        const auto index = gsl::narrow<Index>(m_vertices.size());
+        m_vertices.emplace_back(vertex);
+        m_indices.emplace(vertex, index);
+        return index;
+    }
+
+    const std::vector<T>& getVertices() const noexcept
+    {
+        return m_vertices;
+    }
+
+private:
+    struct BytewiseHash
+    {
+        size_t operator()(const T& vertex) const
+        {
+            const auto data = reinterpret_cast<const uint8_t*>(&vertex);
+            return boost::hash_range(data, data + sizeof(T));
+        }
+    };
+
+    struct BytewiseEqual
+    {
+        bool operator()(const T& lhs, const T& rhs) const
+        {
+            return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+        }
+    };
+
+    std::vector<T> m_vertices;
+    std::unordered_map<T, Index, BytewiseHash, BytewiseEqual> m_indices;
+};
+
+/**
+ * @brief Reorders the triangles of an indexed triangle list for post-transform vertex cache locality.
+ *
+ * @details
+ * Greedy optimization as described by Tom Forsyth in "Linear-Speed Vertex Cache Optimisation", simulating an LRU
+ * cache of 32 entries.
+ */
+extern void optimizeTriangleOrder(std::vector<uint16_t>& indices, size_t vertexCount);
+
+//! Counts the vertices transformed for an indexed triangle list, assuming a FIFO post-transform cache.
+extern size_t countCacheMisses(const std::vector<uint16_t>& indices, size_t cacheSize = 32);
+} // namespace file
+} // namespace loader
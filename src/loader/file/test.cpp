@@ -0,0 +1,163 @@
+#define BOOST_TEST_MODULE loader_test
+
+#include "meshoptimizer.h"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+gsl_api void gsl::fail_fast_assert_handler(char const* const /*expression*/,
+                                           char const* const message,
+                                           char const* const /*file*/,
+                                           int /*line*/)
+{
+    throw gsl::fail_fast(message);
+}
+
+using namespace loader::file;
+
+namespace
+{
+struct TestVertex
+{
+    int16_t x;
+    int16_t y;
+};
+
+using Triangle = std::array<uint16_t, 3>;
+
+std::vector<Triangle> getSortedTriangles(const std::vector<uint16_t>& indices)
+{
+    BOOST_REQUIRE_EQUAL(indices.size() % 3, 0u);
+
+    std::vector<Triangle> triangles;
+    for(size_t i = 0; i < indices.size(); i += 3)
+        triangles.emplace_back(Triangle{indices[i], indices[i + 1], indices[i + 2]});
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+//! Optimizes @a indices and checks that the same triangles with the same winding come out, returning the result.
+std::vector<uint16_t> optimizeAndCheck(const std::vector<uint16_t>& indices, const size_t vertexCount)
+{
+    auto optimized = indices;
+    optimizeTriangleOrder(optimized, vertexCount);
+    BOOST_CHECK(getSortedTriangles(optimized) == getSortedTriangles(indices));
+    return optimized;
+}
+
+//! Indices of a grid of quads with @a size x @a size vertices, each quad split into two triangles.
+std::vector<uint16_t> makeGrid(const uint16_t size)
+{
+    std::vector<uint16_t> indices;
+    for(uint16_t y = 0; y + 1 < size; ++y)
+    {
+        for(uint16_t x = 0; x + 1 < size; ++x)
+        {
+            const auto v = gsl::narrow<uint16_t>(y * size + x);
+            for(const auto idx : {v, uint16_t(v + 1), uint16_t(v + size), uint16_t(v + 1), uint16_t(v + size + 1),
+                                  uint16_t(v + size)})
+            {
+                indices.emplace_back(idx);
+            }
+        }
+    }
+    return indices;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(mesh_optimizer_tests)
+
+BOOST_AUTO_TEST_CASE(test_welder_deduplicates_identical_vertices)
+{
+    VertexWelder<TestVertex> welder;
+    BOOST_CHECK_EQUAL(welder.add(TestVertex{1, 2}), 0);
+    BOOST_CHECK_EQUAL(welder.add(TestVertex{2, 1}), 1);
+    BOOST_CHECK_EQUAL(welder.add(TestVertex{1, 2}), 0);
+    BOOST_CHECK_EQUAL(welder.add(TestVertex{1, 3}), 2);
+    BOOST_CHECK_EQUAL(welder.add(TestVertex{2, 1}), 1);
+
+    BOOST_REQUIRE_EQUAL(welder.getVertices().size(), 3u);
+    BOOST_CHECK_EQUAL(welder.getVertices()[0].x, 1);
+    BOOST_CHECK_EQUAL(welder.getVertices()[0].y, 2);
+    BOOST_CHECK_EQUAL(welder.getVertices()[1].x, 2);
+    BOOST_CHECK_EQUAL(welder.getVertices()[1].y, 1);
+    BOOST_CHECK_EQUAL(welder.getVertices()[2].x, 1);
+    BOOST_CHECK_EQUAL(welder.getVertices()[2].y, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_optimizer_keeps_degenerate_triangles)
+{
+    optimizeAndCheck({4, 4, 5, 0, 1, 3, 1, 4, 3, 1, 2, 4, 3, 3, 6, 7, 8, 8}, 9);
+    optimizeAndCheck({0, 0, 0, 0, 1, 2, 2, 2, 2, 0, 0, 0, 1, 1, 2}, 3);
+    optimizeAndCheck({5, 5, 5, 5, 5, 5}, 6);
+
+    // a triangle using the same vertex twice must not steal the vertex's remaining triangles
+    std::vector<uint16_t> indices = makeGrid(6);
+    for(uint16_t v = 0; v < 36; v += 5)
+    {
+        for(const auto idx : {v, v, uint16_t((v + 7) % 36)})
+            indices.emplace_back(idx);
+    }
+    optimizeAndCheck(indices, 36);
+}
+
+BOOST_AUTO_TEST_CASE(test_optimizer_permutes_triangles)
+{
+    std::mt19937 rng{1234};
+    for(const uint16_t size : {2, 3, 8, 40})
+    {
+        auto indices = makeGrid(size);
+        optimizeAndCheck(indices, size * size);
+
+        // random triangles over few vertices, so that vertices are shared by many triangles
+        indices.clear();
+        std::uniform_int_distribution<uint16_t> vertex{0, gsl::narrow<uint16_t>(size * 2 - 1)};
+        for(int i = 0; i < size * size * 3; ++i)
+            indices.emplace_back(vertex(rng));
+        optimizeAndCheck(indices, size * 2);
+    }
+
+    std::vector<uint16_t> empty;
+    optimizeTriangleOrder(empty, 0);
+    BOOST_CHECK(empty.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_optimizer_reduces_cache_misses)
+{
+    auto indices = makeGrid(40);
+
+    // shuffle whole triangles
+    auto triangles = getSortedTriangles(indices);
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937{1234});
+    indices.clear();
+    for(const auto& triangle : triangles)
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+
+    const auto optimized = optimizeAndCheck(indices, 40 * 40);
+    const auto misses = countCacheMisses(optimized);
+    BOOST_CHECK_LT(misses, countCacheMisses(indices));
+    // every vertex has to be transformed at least once
+    BOOST_CHECK_GE(misses, 40u * 40u);
+    // a grid of this size is expected to get close to the optimum of 0.5 transformed vertices per triangle
+    BOOST_CHECK_LT(static_cast<float>(misses) / (triangles.size()), 0.8f);
+}
+
+BOOST_AUTO_TEST_CASE(test_cache_misses_of_fifo)
+{
+    BOOST_CHECK_EQUAL(countCacheMisses({}), 0u);
+    BOOST_CHECK_EQUAL(countCacheMisses({0, 1, 2, 0, 2, 3}), 4u);
+    BOOST_CHECK_EQUAL(countCacheMisses({0, 1, 2, 0, 2, 3}, 3), 4u);
+    BOOST_CHECK_EQUAL(countCacheMisses({0, 1, 2, 0, 2, 3}, 1), 6u);
+
+    // 3 pushes 0 out of a FIFO of 3 entries
+    BOOST_CHECK_EQUAL(countCacheMisses({0, 1, 2, 1, 2, 3, 0, 3, 2}, 3), 5u);
+    // a hit doesn't refresh an entry, unlike in an LRU cache
+    BOOST_CHECK_EQUAL(countCacheMisses({0, 1, 0, 2, 0}, 2), 4u);
+
+    BOOST_CHECK_THROW(countCacheMisses({0, 1, 2}, 0), gsl::fail_fast);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,8 @@
 
 #include <boost/filesystem/path.hpp>
 #include <boost/lexical_cast.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/type_precision.hpp>
 
 namespace loader
 {
@@ -173,6 +175,12 @@ struct UVCoordinates
         return glm::vec2{(xpixel + 0.5f) / 256.0f, (ypixel + 0.5f) / 256.0f};
     }
 
+    //! The coordinates of #toGl as normalized 16 bit values, as used in vertex buffers.
+    glm::u16vec2 toPackedGl() const
+    {
+        return glm::packUnorm<uint16_t>(toGl());
+    }
+
     UVCoordinates& operator=(const glm::vec2& v)
     {
         xpixel = gsl::narrow<uint8_t>(std::lround(v.x * 256));
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "core/vec.h"
+#include "render/gl/typetraits.h"
+
+#include <cmath>
 
 namespace loader
 {
@@ -15,5 +18,27 @@ inline glm::vec3 generateNormal(const core::TRVec& o, const core::TRVec& a, cons
 {
     return generateNormal(o.toRenderSystem(), a.toRenderSystem(), b.toRenderSystem());
 }
+
+//! Packs a render system position of level geometry, which always has integral coordinates.
+inline glm::i16vec3 packPosition(const glm::vec3& v)
+{
+    return glm::i16vec3{gsl::narrow<int16_t>(std::lround(v.x)),
+                        gsl::narrow<int16_t>(std::lround(v.y)),
+                        gsl::narrow<int16_t>(std::lround(v.z))};
+}
+
+//! Packs a normal of arbitrary length; the packed format can only hold unit vectors.
+inline render::gl::Snorm3x10 packNormal(const glm::vec3& n)
+{
+    if(n == glm::vec3{0.0f})
+        return render::gl::Snorm3x10{n};
+
+    return render::gl::Snorm3x10{glm::normalize(n)};
+}
+
+inline glm::u8vec4 packColor(const glm::vec4& color)
+{
+    return glm::packUnorm<uint8_t>(color);
+}
 } // namespace file
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "gsl-lite.hpp"
+
+#include <boost/optional.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+
+namespace render
+{
+/**
+ * @brief A Binary Space Partition Tree for 2D space.
+ */
+struct BSPTree
+{
+    std::unique_ptr<BSPTree> left;
+    std::unique_ptr<BSPTree> right;
+
+    //! If @c true, denotes that there is no more free space in this node or its children.
+    //! @note This is a pure caching mechanism to avoid unnecessary recursion.
+    bool isFilled = false;
+
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+
+    BSPTree() = default;
+
+    BSPTree(const int32_t x, const int32_t y, const int32_t w, const int32_t h)
+        : x{x}
+        , y{y}
+        , width{w}
+        , height{h}
+    {
+        Expects(x >= 0);
+        Expects(y >= 0);
+        Expects(w > 0);
+        Expects(h > 0);
+    }
+
+    bool isSplit() const
+    {
+        return left != nullptr && right != nullptr;
+    }
+
+    /**
+     * @brief Split this node along its Y axis (X is split).
+     * @param splitLocation Local X coordinate of the split point
+     */
+    void splitX(const int32_t splitLocation)
+    {
+        Expects(splitLocation < width);
+        left = std::make_unique<BSPTree>(x, y, splitLocation, height);
+        right = std::make_unique<BSPTree>(x + splitLocation, y, width - splitLocation, height);
+    }
+
+    /**
+     * @brief Split this node along its X axis (Y is split).
+     * @param splitLocation Local Y coordinate of the split point
+     */
+    void splitY(const int32_t splitLocation)
+    {
+        Expects(splitLocation < height);
+        left = std::make_unique<BSPTree>(x, y, width, splitLocation);
+        right = std::make_unique<BSPTree>(x, y + splitLocation, width, height - splitLocation);
+    }
+
+    bool fits(const int32_t w, const int32_t h) const noexcept
+    {
+        Expects(w > 0);
+        Expects(h > 0);
+        return !isFilled && w <= width && h <= height;
+    }
+
+    /**
+     * @brief Find a free space in this node or its children
+     */
+    boost::optional<glm::vec2> tryInsert(const int scale, const glm::vec2& uv)
+    {
+        const auto tmp = tryInsert(gsl::narrow_cast<int32_t>(scale * uv.x), gsl::narrow_cast<int32_t>(scale * uv.y));
+        if(!tmp.is_initialized())
+            return boost::none;
+
+        return glm::vec2{tmp->x / float(scale), tmp->y / float(scale)};
+    }
+
+    boost::optional<glm::ivec2> tryInsert(const int32_t width, const int32_t height)
+    {
+        // Could this possibly fit?
+        if(!fits(width, height))
+            return boost::none;
+
+        if(isSplit())
+        {
+            // This node is already split => Recurse!
+            boost::optional<glm::ivec2> found{};
+            if(width <= left->width && height <= left->height)
+            {
+                found = left->tryInsert(width, height);
+            }
+
+            if(!found.is_initialized() && width <= right->width && height <= right->height)
+            {
+                found = right->tryInsert(width, height);
+            }
+
+            // If both children are filled, mark this node as filled and discard the children.
+            if(left->isFilled && right->isFilled)
+            {
+                isFilled = true;
+                left.reset();
+                right.reset();
+            }
+
+            return found;
+        }
+
+        // We may split this node
+        if(this->height == height && this->width == width)
+        {
+            // Perfect match
+            isFilled = true;
+            return glm::ivec2{x, y};
+        }
+        else if(this->height == height)
+        {
+            // Split horizontally
+            splitX(width);
+
+            // height already fits, width fits too now, so this is the result
+            left->isFilled = true;
+            return glm::ivec2{x, y};
+        }
+        else
+        {
+            // In case of doubt do a vertical split
+            splitY(height);
+
+            // Recurse, because the width may not match
+            return left->tryInsert(width, height);
+        }
+    }
+};
+} // namespace render
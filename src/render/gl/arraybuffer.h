@@ -6,6 +6,21 @@ namespace render
 {
 namespace gl
 {
+namespace detail
+{
+inline size_t& arrayBufferUploadBytes()
+{
+    static size_t bytes = 0;
+    return bytes;
+}
+} // namespace detail
+
+//! Total number of bytes uploaded to array buffers so far; only meant for load statistics.
+inline size_t getArrayBufferUploadBytes()
+{
+    return detail::arrayBufferUploadBytes();
+}
+
 template<typename T>
 class ArrayBuffer : public Buffer
 {
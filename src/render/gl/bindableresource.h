@@ -56,7 +56,7 @@ protected:
 
         BOOST_ASSERT(m_handle != 0);
 
-        if(!label.empty())
+        if(!label.empty() && isDebugOutputEnabled())
         {
             // An object must be created (not only reserved) to be able to have a label assigned;
             // for certain types of resources, this may fail, e.g. programs which must be linked
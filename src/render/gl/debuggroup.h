@@ -11,7 +11,11 @@ class DebugGroup final
 {
 public:
     explicit DebugGroup(const std::string& message, const uint32_t id = 0)
+        : m_active{isDebugOutputEnabled()}
     {
+        if(!m_active)
+            return;
+
         GL_ASSERT(::gl::pushDebugGroup(::gl::DebugSource::DebugSourceApplication,
                                        id,
                                        gsl::narrow<::gl::core::SizeType>(message.length()),
@@ -28,8 +32,12 @@ public:
 
     ~DebugGroup()
     {
-        GL_ASSERT(::gl::popDebugGroup());
+        if(m_active)
+            GL_ASSERT(::gl::popDebugGroup());
     }
+
+private:
+    const bool m_active;
 };
 } // namespace gl
 } // namespace render
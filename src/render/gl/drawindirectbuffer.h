@@ -0,0 +1,50 @@
+#pragma once
+
+#include "buffer.h"
+#include "gsl-lite.hpp"
+
+#include <vector>
+
+namespace render
+{
+namespace gl
+{
+//! The command layout consumed by @c glMultiDrawElementsIndirect.
+struct DrawElementsIndirectCommand
+{
+    uint32_t count = 0;
+    uint32_t instanceCount = 0;
+    uint32_t firstIndex = 0;
+    int32_t baseVertex = 0;
+    uint32_t baseInstance = 0;
+};
+
+class DrawIndirectBuffer : public Buffer
+{
+public:
+    explicit DrawIndirectBuffer(const std::string& label = {})
+        : Buffer{::gl::BufferTargetARB::DrawIndirectBuffer, label}
+    {
+    }
+
+    void setData(const std::vector<DrawElementsIndirectCommand>& data, const ::gl::BufferUsageARB usage)
+    {
+        bind();
+
+        GL_ASSERT(::gl::bufferData(::gl::BufferTargetARB::DrawIndirectBuffer,
+                                   sizeof(DrawElementsIndirectCommand) * data.size(),
+                                   data.data(),
+                                   usage));
+        m_size = gsl::narrow<::gl::core::SizeType>(data.size());
+    }
+
+    ::gl::core::SizeType size() const noexcept
+    {
+        return m_size;
+    }
+
+private:
+    ::gl::core::SizeType m_size = 0;
+};
+} // namespace gl
+} // namespace render
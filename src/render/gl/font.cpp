@@ -1,11 +1,15 @@
 #include "font.h"
 
 #include "gsl-lite.hpp"
+#include "render/bsptree.h"
 #include "render/scene/names.h"
+#include "render/scene/quadbatch.h"
 #include "render/scene/renderer.h"
 #include "render/scene/uniformparameter.h"
 
+#include <algorithm>
 #include <boost/log/trivial.hpp>
+#include <numeric>
 #include <utility>
 
 #include FT_OUTLINE_H
@@ -103,6 +107,8 @@ Font::Font(std::string ttf, const int size)
     m_imgType.width = size;
     m_imgType.height = size;
     m_imgType.flags = FT_LOAD_DEFAULT | FT_LOAD_RENDER;
+
+    bakeGlyphs();
 }
 
 Font::~Font()
@@ -111,22 +117,19 @@ Font::~Font()
     m_cache = nullptr;
 }
 
-void Font::drawText(const char* text, const int x, const int y, const SRGBA8& color)
+void Font::bakeGlyphs()
 {
-    BOOST_ASSERT(text);
-
-    const int baseAlpha = color.a;
-    auto currentColor = color;
-
-    m_x0 = x;
-    m_y0 = y;
+    std::vector<Image<SRGBA8>> bitmaps;
+    bitmaps.reserve(m_glyphs.size());
 
-    while(const char chr = *text++)
+    for(char chr = FirstChar; chr <= LastChar; ++chr)
     {
+        bitmaps.emplace_back();
+
         const auto glyphIndex = FTC_CMapCache_Lookup(m_cmapCache, &_dummyFaceId, -1, chr);
         if(glyphIndex <= 0)
         {
-            BOOST_LOG_TRIVIAL(warning) << "Failed to load character '" << chr << "'";
+            BOOST_LOG_TRIVIAL(warning) << "Font " << m_filename << " does not contain character '" << chr << "'";
             continue;
         }
 
@@ -140,20 +143,130 @@ void Font::drawText(const char* text, const int x, const int y, const SRGBA8& co
             continue;
         }
 
-        for(int dy = 0, i = 0; dy < sbit->height; dy++)
+        auto& glyph = m_glyphs[chr - FirstChar];
+        glyph = Glyph{};
+        glyph->left = sbit->left;
+        glyph->top = sbit->top;
+        glyph->xadvance = sbit->xadvance;
+        glyph->yadvance = sbit->yadvance;
+
+        if(sbit->buffer != nullptr && sbit->width > 0 && sbit->height > 0)
         {
-            for(int dx = 0; dx < sbit->width; dx++, i++)
+            // white texels with the glyph's coverage as alpha, so that the glyph can be tinted when drawing
+            auto& bitmap = bitmaps.back();
+            bitmap = Image<SRGBA8>{sbit->width, sbit->height};
+            for(int dy = 0; dy < sbit->height; ++dy)
             {
-                currentColor.a = gsl::narrow<uint8_t>(sbit->buffer[i] * baseAlpha / 255);
+                for(int dx = 0; dx < sbit->width; ++dx)
+                {
+                    bitmap.set(dx, dy, SRGBA8{255, 255, 255, sbit->buffer[dy * sbit->pitch + dx]});
+                }
+            }
+            glyph->size = glm::ivec2{sbit->width, sbit->height};
+        }
+
+        FTC_Node_Unref(node, m_cache);
+    }
+
+    // pack the largest glyphs first, growing the atlas until everything fits
+    std::vector<size_t> order(bitmaps.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&bitmaps](const size_t a, const size_t b) {
+        return bitmaps[a].getHeight() > bitmaps[b].getHeight()
+               || (bitmaps[a].getHeight() == bitmaps[b].getHeight() && bitmaps[a].getWidth() > bitmaps[b].getWidth());
+    });
+
+    // the atlas is added to the target's atlas as a single image, which keeps a pixel of space next to it
+    static constexpr int32_t MaxAtlasSize = scene::QuadBatch::AtlasSize - 1;
+    for(int32_t atlasSize = 64;; atlasSize = std::min(atlasSize * 2, MaxAtlasSize))
+    {
+        BSPTree layout{0, 0, atlasSize, atlasSize};
+        bool fits = true;
+        for(const auto idx : order)
+        {
+            auto& glyph = m_glyphs[idx];
+            if(!glyph.is_initialized() || glyph->size.x == 0)
+                continue;
 
-                m_targetImage->set(m_x0 + dx + sbit->left, m_y0 + dy - sbit->top, currentColor, true);
+            // keep a pixel of space between glyphs, so that they don't bleed into each other
+            const auto pos = layout.tryInsert(glyph->size.x + 1, glyph->size.y + 1);
+            if(!pos.is_initialized())
+            {
+                fits = false;
+                break;
             }
+            glyph->atlasPos = *pos;
         }
 
-        m_x0 += sbit->xadvance;
-        m_y0 += sbit->yadvance;
+        if(!fits)
+        {
+            if(atlasSize == MaxAtlasSize)
+                BOOST_THROW_EXCEPTION(std::runtime_error("Font glyphs do not fit into the quad batch atlas"));
+            continue;
+        }
 
-        FTC_Node_Unref(node, m_cache);
+        m_atlas = Image<SRGBA8>{atlasSize, atlasSize};
+        for(size_t idx = 0; idx < m_glyphs.size(); ++idx)
+        {
+            const auto& glyph = m_glyphs[idx];
+            if(!glyph.is_initialized() || glyph->size.x == 0)
+                continue;
+
+            for(int dy = 0; dy < glyph->size.y; ++dy)
+                for(int dx = 0; dx < glyph->size.x; ++dx)
+                    m_atlas.set(glyph->atlasPos.x + dx, glyph->atlasPos.y + dy, bitmaps[idx].at(dx, dy));
+        }
+
+        BOOST_LOG_TRIVIAL(debug) << "Baked glyphs of font " << m_filename << " into a " << atlasSize << "x"
+                                 << atlasSize << " atlas";
+        return;
+    }
+}
+
+void Font::setTarget(const std::shared_ptr<scene::QuadBatch>& target)
+{
+    if(target == m_target)
+        return;
+
+    m_target = target;
+    for(auto& glyph : m_glyphs)
+    {
+        if(glyph.is_initialized())
+            glyph->tile.reset();
+    }
+
+    if(m_target == nullptr)
+        return;
+
+    const auto atlasTile = m_target->addImage(m_atlas);
+    for(auto& glyph : m_glyphs)
+    {
+        if(!glyph.is_initialized() || glyph->size.x == 0)
+            continue;
+
+        glyph->tile = m_target->addSubTile(atlasTile, glyph->atlasPos, glyph->size);
+    }
+}
+
+void Font::drawText(const char* text, int x, int y, const SRGBA8& color)
+{
+    BOOST_ASSERT(text);
+    Expects(m_target != nullptr);
+
+    while(const char chr = *text++)
+    {
+        if(chr < FirstChar || chr > LastChar)
+            continue;
+
+        const auto& glyph = m_glyphs[chr - FirstChar];
+        if(!glyph.is_initialized())
+            continue;
+
+        if(glyph->tile.is_initialized())
+            m_target->draw(*glyph->tile, x + glyph->left, y - glyph->top, color);
+
+        x += glyph->xadvance;
+        y += glyph->yadvance;
     }
 }
 
@@ -3,16 +3,35 @@
 #include "image.h"
 #include "pixel.h"
 
+#include <array>
+#include <boost/optional.hpp>
 #include <ft2build.h>
+#include <glm/glm.hpp>
 #include FT_CACHE_H
 
 namespace render
 {
+namespace scene
+{
+class QuadBatch;
+}
+
 namespace gl
 {
+/**
+ * @brief Draws text using a TrueType font into a scene::QuadBatch.
+ *
+ * @details
+ * The printable ASCII range is rasterized into a packed glyph atlas with per-glyph metrics when the font is
+ * created, and the atlas is uploaded to the target batch once it's set.  Drawing is a table lookup and a quad per
+ * character; characters outside the range or missing in the font are skipped.
+ */
 class Font
 {
 public:
+    static constexpr char FirstChar = ' ';
+    static constexpr char LastChar = '~';
+
     Font(const Font&) = delete;
 
     Font(Font&&) noexcept = delete;
@@ -29,17 +48,29 @@ public:
 
     ~Font();
 
-    void setTarget(const std::shared_ptr<Image<SRGBA8>>& img)
-    {
-        m_targetImage = img;
-    }
+    void setTarget(const std::shared_ptr<scene::QuadBatch>& target);
 
-    const std::shared_ptr<Image<SRGBA8>>& getTarget() const
+    const std::shared_ptr<scene::QuadBatch>& getTarget() const
     {
-        return m_targetImage;
+        return m_target;
     }
 
 private:
+    struct Glyph
+    {
+        glm::ivec2 atlasPos{0};
+        //! Size of the glyph's bitmap, zero for glyphs without any pixels.
+        glm::ivec2 size{0};
+        int left = 0;
+        int top = 0;
+        int xadvance = 0;
+        int yadvance = 0;
+        //! Tile of the glyph in the target's atlas.
+        boost::optional<size_t> tile;
+    };
+
+    void bakeGlyphs();
+
     FTC_Manager m_cache = nullptr;
 
     FTC_CMapCache m_cmapCache = nullptr;
@@ -48,11 +79,11 @@ private:
 
     FTC_ImageTypeRec m_imgType;
 
-    std::shared_ptr<Image<SRGBA8>> m_targetImage = nullptr;
+    std::shared_ptr<scene::QuadBatch> m_target = nullptr;
 
-    int m_x0 = 0;
+    std::array<boost::optional<Glyph>, LastChar - FirstChar + 1> m_glyphs;
 
-    int m_y0 = 0;
+    Image<SRGBA8> m_atlas;
 
     const std::string m_filename;
 };
@@ -2,6 +2,8 @@
 
 #include "api/gl_api_provider.hpp"
 
+size_t render::gl::detail::glCallCount = 0;
+
 #ifndef NDEBUG
 void render::gl::checkGlError(const char* code)
 {
@@ -20,20 +20,35 @@ inline void checkGlError(const char* code)
 
 namespace detail
 {
+//! Number of GL calls issued through GL_ASSERT/GL_ASSERT_FN; the GL is only used from the main thread.
+extern size_t glCallCount;
+
 template<typename F>
 inline auto glAssertFn(F code, const char* codeStr) -> decltype(code())
 {
+    ++glCallCount;
     const auto result = code();
     checkGlError(codeStr);
     return result;
 }
 } // namespace detail
+
+inline size_t getCallCount()
+{
+    return detail::glCallCount;
+}
+
+inline void resetCallCount()
+{
+    detail::glCallCount = 0;
+}
 } // namespace gl
 } // namespace render
 
 #define GL_ASSERT(gl_code)                    \
     do                                        \
     {                                         \
+        ++::render::gl::detail::glCallCount;  \
         gl_code;                              \
         ::render::gl::checkGlError(#gl_code); \
     } while(false)
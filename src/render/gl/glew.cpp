@@ -72,7 +72,9 @@ void SOGLB_API debugCallback(::gl::DebugSource source,
 }
 } // namespace
 
-void render::gl::initializeGl()
+bool render::gl::detail::debugOutputEnabled = false;
+
+void render::gl::initializeGl(const bool debugOutput)
 {
     glewExperimental = GL_TRUE; // Let GLEW ignore "GL_INVALID_ENUM in glGetString(GL_EXTENSIONS)"
     const auto err = glewInit();
@@ -84,12 +86,14 @@ void render::gl::initializeGl()
 
     glGetError(); // clear the error flag
 
-#ifndef NDEBUG
-    GL_ASSERT(::gl::enable(::gl::EnableCap::DebugOutput));
-    GL_ASSERT(::gl::enable(::gl::EnableCap::DebugOutputSynchronous));
+    detail::debugOutputEnabled = debugOutput;
+    if(debugOutput)
+    {
+        GL_ASSERT(::gl::enable(::gl::EnableCap::DebugOutput));
+        GL_ASSERT(::gl::enable(::gl::EnableCap::DebugOutputSynchronous));
 
-    GL_ASSERT(::gl::debugMessageCallback(&debugCallback, nullptr));
-#endif
+        GL_ASSERT(::gl::debugMessageCallback(&debugCallback, nullptr));
+    }
 
     RenderState::initDefaults();
 
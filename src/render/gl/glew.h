@@ -6,6 +6,20 @@ namespace render
 {
 namespace gl
 {
-extern void initializeGl();
+namespace detail
+{
+extern bool debugOutputEnabled;
+}
+
+/**
+ * @param[in] debugOutput Whether to register the debug message callback, and to emit debug groups and object
+ *            labels; requires a context created with @c GLFW_OPENGL_DEBUG_CONTEXT to be useful.
+ */
+extern void initializeGl(bool debugOutput);
+
+inline bool isDebugOutputEnabled()
+{
+    return detail::debugOutputEnabled;
+}
 }
 } // namespace render
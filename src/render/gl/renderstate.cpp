@@ -98,6 +98,15 @@ void RenderState::apply(const bool force) const
     }
 }
 
+bool RenderState::operator!=(const RenderState& rhs) const
+{
+    return m_cullFaceEnabled != rhs.m_cullFaceEnabled || m_depthTestEnabled != rhs.m_depthTestEnabled
+           || m_depthWriteEnabled != rhs.m_depthWriteEnabled || m_depthFunction != rhs.m_depthFunction
+           || m_blendEnabled != rhs.m_blendEnabled || m_blendSrc != rhs.m_blendSrc || m_blendDst != rhs.m_blendDst
+           || m_cullFaceSide != rhs.m_cullFaceSide || m_frontFace != rhs.m_frontFace
+           || m_lineWidth != rhs.m_lineWidth || m_lineSmooth != rhs.m_lineSmooth;
+}
+
 void RenderState::enableDepthWrite()
 {
     // Internal method used by Game::clear() to restore depth writing before a
@@ -166,20 +175,27 @@ void RenderState::setLineSmooth(bool enabled)
 
 void RenderState::initDefaults()
 {
-    getCurrentState().m_cullFaceEnabled.setDefault();
-    getCurrentState().m_depthTestEnabled.setDefault();
-    getCurrentState().m_depthWriteEnabled.setDefault();
-    getCurrentState().m_depthFunction.setDefault();
-    getCurrentState().m_blendEnabled.setDefault();
-    getCurrentState().m_blendSrc.setDefault();
-    getCurrentState().m_blendDst.setDefault();
-    getCurrentState().m_cullFaceSide.setDefault();
-    getCurrentState().m_frontFace.setDefault();
-    getCurrentState().m_lineWidth.setDefault();
-    getCurrentState().m_lineSmooth.setDefault();
+    getCurrentState() = getDefaults();
     getCurrentState().apply(true);
 }
 
+RenderState RenderState::getDefaults()
+{
+    RenderState state;
+    state.m_cullFaceEnabled.setDefault();
+    state.m_depthTestEnabled.setDefault();
+    state.m_depthWriteEnabled.setDefault();
+    state.m_depthFunction.setDefault();
+    state.m_blendEnabled.setDefault();
+    state.m_blendSrc.setDefault();
+    state.m_blendDst.setDefault();
+    state.m_cullFaceSide.setDefault();
+    state.m_frontFace.setDefault();
+    state.m_lineWidth.setDefault();
+    state.m_lineSmooth.setDefault();
+    return state;
+}
+
 void RenderState::merge(const RenderState& other)
 {
 #define MERGE_OPT(n) n.merge(other.n)
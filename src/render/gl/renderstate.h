@@ -47,12 +47,23 @@ public:
 
     void setLineSmooth(bool enabled);
 
+    bool isDepthWriteEnabled() const
+    {
+        return m_depthWriteEnabled.get();
+    }
+
     static void initDefaults();
 
+    //! A state with all values explicitly set to their defaults.
+    static RenderState getDefaults();
+
     static void enableDepthWrite();
 
     void merge(const RenderState& other);
 
+    //! Whether any explicitly set value differs, or is only set in one of the states.
+    bool operator!=(const RenderState& rhs) const;
+
 private:
     template<typename T, const T DefaultValue>
     struct DefaultedOptional final
@@ -36,10 +36,11 @@ public:
     {
     }
 
-    void bindVertexAttribute(const uint32_t index) const
+    void bindVertexAttribute(const uint32_t index, const uint32_t divisor = 0) const
     {
         GL_ASSERT(::gl::vertexAttribPointer(index, m_size, m_type, m_normalized, sizeof(T), m_pointer));
         GL_ASSERT(::gl::enableVertexAttribArray(index));
+        GL_ASSERT(::gl::vertexAttribDivisor(index, divisor));
     }
 
     std::uintptr_t getOffset() const noexcept
@@ -64,9 +65,15 @@ template<typename T>
 class StructuredArrayBuffer : public ArrayBuffer<T>
 {
 public:
-    explicit StructuredArrayBuffer(const StructureLayout<T>& layout, const std::string& label = {})
+    /**
+     * @param[in] divisor Number of instances to draw before advancing to the next element; 0 for per-vertex data.
+     */
+    explicit StructuredArrayBuffer(const StructureLayout<T>& layout,
+                                   const std::string& label = {},
+                                   const uint32_t divisor = 0)
         : ArrayBuffer{label}
         , m_structureLayout{layout}
+        , m_divisor{divisor}
     {
         BOOST_ASSERT(!layout.empty());
     }
@@ -81,7 +88,7 @@ public:
             if(it == m_structureLayout.end())
                 continue;
 
-            it->second.bindVertexAttribute(input.getLocation());
+            it->second.bindVertexAttribute(input.getLocation(), m_divisor);
         }
     }
 
@@ -105,6 +112,7 @@ public:
             m_size = gsl::narrow<::gl::core::SizeType>(count);
 
         GL_ASSERT(::gl::bufferData(::gl::BufferTargetARB::ArrayBuffer, sizeof(T) * size(), data, access));
+        detail::arrayBufferUploadBytes() += sizeof(T) * size();
     }
 
     void setDataRaw(const gsl::not_null<const T*>& data, const size_t count, const ::gl::BufferUsageARB access)
@@ -115,6 +123,7 @@ public:
             m_size = count;
 
         GL_ASSERT(::gl::bufferData(::gl::BufferTargetARB::ArrayBuffer, sizeof(T) * size(), data, access));
+        detail::arrayBufferUploadBytes() += sizeof(T) * size();
     }
 
     void setData(const std::vector<T>& data, const ::gl::BufferUsageARB access)
@@ -136,6 +145,7 @@ public:
 
 private:
     const StructureLayout<T> m_structureLayout;
+    const uint32_t m_divisor;
 };
 } // namespace gl
 } // namespace render
@@ -163,6 +163,20 @@ public:
         return *this;
     }
 
+    Texture2D<PixelT>& subImage(
+        const int32_t x, const int32_t y, const int32_t width, const int32_t height, const PixelT* data)
+    {
+        BOOST_ASSERT(x >= 0 && y >= 0 && width > 0 && height > 0);
+        BOOST_ASSERT(x + width <= m_width && y + height <= m_height);
+
+        bind();
+
+        GL_ASSERT(
+            ::gl::texSubImage2D(getType(), 0, x, y, width, height, PixelT::PixelFormat, PixelT::PixelType, data));
+
+        return *this;
+    }
+
     Texture2D<PixelT>& copyImageSubData(const Texture2D& src)
     {
         GL_ASSERT(::gl::copyImageSubData(
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "glassert.h"
+#include "gsl-lite.hpp"
+#include "util/profiler.h"
+
+#include <array>
+
+namespace render
+{
+namespace gl
+{
+/**
+ * @brief Measures GPU time of a (non-nested) range of commands and reports it to the util::Profiler.
+ *
+ * @details
+ * Uses a small ring of @c GL_TIME_ELAPSED queries; results are fetched without stalling the
+ * pipeline a few frames later, when the query slot is about to be reused.
+ */
+class GpuTimer final
+{
+public:
+    explicit GpuTimer(const char* name)
+        : m_name{name}
+    {
+        GL_ASSERT(::gl::genQuerie(gsl::narrow<::gl::core::SizeType>(m_queries.size()), m_queries.data()));
+    }
+
+    GpuTimer(const GpuTimer&) = delete;
+
+    GpuTimer(GpuTimer&&) = delete;
+
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    GpuTimer& operator=(GpuTimer&&) = delete;
+
+    ~GpuTimer()
+    {
+        GL_ASSERT(::gl::deleteQuerie(gsl::narrow<::gl::core::SizeType>(m_queries.size()), m_queries.data()));
+    }
+
+    void begin()
+    {
+        m_active = util::Profiler::isEnabled();
+        if(!m_active)
+            return;
+
+        collect(m_current);
+        m_issuedAt[m_current] = util::Profiler::instance().now();
+        GL_ASSERT(::gl::beginQuery(::gl::QueryTarget::TimeElapsed, m_queries[m_current]));
+    }
+
+    void end()
+    {
+        if(!m_active)
+            return;
+
+        GL_ASSERT(::gl::endQuery(::gl::QueryTarget::TimeElapsed));
+        m_pending[m_current] = true;
+        m_current = (m_current + 1) % m_queries.size();
+    }
+
+private:
+    void collect(const size_t idx)
+    {
+        if(!m_pending[idx])
+            return;
+
+        int32_t available = 0;
+        GL_ASSERT(
+            ::gl::getQueryObject(m_queries[idx], ::gl::QueryObjectParameterName::QueryResultAvailable, &available));
+        m_pending[idx] = false;
+        if(available == 0)
+            return; // drop this sample rather than stalling the pipeline
+
+        uint64_t elapsed = 0;
+        GL_ASSERT(::gl::getQueryObject(m_queries[idx], ::gl::QueryObjectParameterName::QueryResult, &elapsed));
+        util::Profiler::instance().addGpuZone(m_name, m_issuedAt[idx], elapsed);
+    }
+
+    const char* const m_name;
+    std::array<uint32_t, 4> m_queries{};
+    std::array<uint64_t, 4> m_issuedAt{};
+    std::array<bool, 4> m_pending{};
+    size_t m_current = 0;
+    bool m_active = false;
+};
+
+class GpuTimerScope final
+{
+public:
+    explicit GpuTimerScope(GpuTimer& timer)
+        : m_timer{timer}
+    {
+        m_timer.begin();
+    }
+
+    GpuTimerScope(const GpuTimerScope&) = delete;
+
+    GpuTimerScope(GpuTimerScope&&) = delete;
+
+    GpuTimerScope& operator=(const GpuTimerScope&) = delete;
+
+    GpuTimerScope& operator=(GpuTimerScope&&) = delete;
+
+    ~GpuTimerScope()
+    {
+        m_timer.end();
+    }
+
+private:
+    GpuTimer& m_timer;
+};
+} // namespace gl
+} // namespace render
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/packing.hpp>
+#include <glm/gtc/type_precision.hpp>
 
 namespace render
 {
@@ -91,14 +92,41 @@ struct TypeTraits<float>
     static const constexpr ::gl::InternalFormat RSizedInternalFormat = ::gl::InternalFormat::R32f;
 };
 
-template<int N>
-struct TypeTraits<glm::vec<N, float, glm::defaultp>>
+template<int N, typename T>
+struct TypeTraits<glm::vec<N, T, glm::defaultp>>
 {
-    static const constexpr ::gl::VertexAttribPointerType VertexAttribPointerType = ::gl::VertexAttribPointerType::Float;
-    static const constexpr ::gl::PixelType PixelType = ::gl::PixelType::Float;
+    static const constexpr ::gl::VertexAttribPointerType VertexAttribPointerType
+        = TypeTraits<T>::VertexAttribPointerType;
+    static const constexpr ::gl::PixelType PixelType = TypeTraits<T>::PixelType;
     static const constexpr ::gl::core::SizeType ElementCount = N;
 };
 
+/**
+ * @brief A unit vector packed into a single @c GL_INT_2_10_10_10_REV word.
+ *
+ * @details
+ * Bind it as a normalized attribute; the shader sees a @c vec4 with the unused 2 bit @c w component being zero.
+ */
+struct Snorm3x10
+{
+    uint32_t value = 0;
+
+    Snorm3x10() = default;
+
+    explicit Snorm3x10(const glm::vec3& v)
+        : value{glm::packSnorm3x10_1x2(glm::vec4{v, 0.0f})}
+    {
+    }
+};
+
+template<>
+struct TypeTraits<Snorm3x10>
+{
+    static const constexpr ::gl::VertexAttribPointerType VertexAttribPointerType
+        = ::gl::VertexAttribPointerType::Int2101010Rev;
+    static const constexpr ::gl::core::SizeType ElementCount = 4;
+};
+
 template<>
 struct TypeTraits<::gl::core::Half>
 {
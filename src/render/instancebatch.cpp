@@ -0,0 +1,120 @@
+#include "instancebatch.h"
+
+#include "render/gl/vertexarray.h"
+#include "render/scene/Material.h"
+#include "render/scene/mesh.h"
+#include "render/scene/model.h"
+#include "render/scene/names.h"
+
+namespace render
+{
+const gl::StructureLayout<InstanceBatch::Instance>& InstanceBatch::Instance::getLayout()
+{
+    static const gl::StructureLayout<Instance> layout{
+        {VERTEX_ATTRIBUTE_INSTANCE_TRANSFORM_NAME, &Instance::transform},
+        {VERTEX_ATTRIBUTE_INSTANCE_BRIGHTNESS_NAME, &Instance::brightness}};
+
+    return layout;
+}
+
+const gl::StructureLayout<InstanceBatch::BillboardVertex>& InstanceBatch::BillboardVertex::getLayout()
+{
+    static const gl::StructureLayout<BillboardVertex> layout{
+        {VERTEX_ATTRIBUTE_POSITION_NAME, &BillboardVertex::position},
+        {VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME, &BillboardVertex::uv},
+        {VERTEX_ATTRIBUTE_COLOR_NAME, &BillboardVertex::color}};
+
+    return layout;
+}
+
+InstanceBatch::InstanceBatch(const std::string& label)
+    : m_label{label}
+    , m_instanceBuffer{std::make_shared<gl::StructuredArrayBuffer<Instance>>(Instance::getLayout(), label, 1)}
+    , m_billboardBuffer{std::make_shared<gl::StructuredArrayBuffer<BillboardVertex>>(BillboardVertex::getLayout(),
+                                                                                      label + "-billboards")}
+    , m_billboardIndices{std::make_shared<gl::ElementArrayBuffer<uint16_t>>(label + "-billboards")}
+{
+}
+
+InstanceBatch::~InstanceBatch() = default;
+
+InstanceBatch::Prototype InstanceBatch::addBillboard(const float x0,
+                                                     const float y0,
+                                                     const float x1,
+                                                     const float y1,
+                                                     const glm::vec2& t0,
+                                                     const glm::vec2& t1,
+                                                     const std::shared_ptr<scene::Material>& material)
+{
+    Expects(!m_finalized);
+    Expects(material != nullptr);
+
+    if(m_billboardVao == nullptr)
+    {
+        // the buffers are filled when finalizing, which doesn't affect the attribute bindings
+        using BillboardArray = gl::VertexArray<uint16_t, BillboardVertex, Instance>;
+        m_billboardProgram = material->getShaderProgram();
+        m_billboardVao
+            = std::make_shared<BillboardArray>(BillboardArray::IndexBuffers{m_billboardIndices},
+                                               BillboardArray::VertexBuffers{m_billboardBuffer, m_instanceBuffer},
+                                               m_billboardProgram->getHandle(),
+                                               m_label + "-billboards");
+    }
+    Expects(material->getShaderProgram().get() == m_billboardProgram);
+
+    const auto baseVertex = gsl::narrow<int32_t>(m_billboardVertices.size());
+    m_billboardVertices.emplace_back(BillboardVertex{{x0, y0, 0}, {t0.x, t0.y}});
+    m_billboardVertices.emplace_back(BillboardVertex{{x1, y0, 0}, {t1.x, t0.y}});
+    m_billboardVertices.emplace_back(BillboardVertex{{x1, y1, 0}, {t1.x, t1.y}});
+    m_billboardVertices.emplace_back(BillboardVertex{{x0, y1, 0}, {t0.x, t1.y}});
+
+    return Prototype{Part{m_billboardVao, gl::TypeTraits<uint16_t>::DrawElementsType, 6, baseVertex, material}};
+}
+
+gsl::not_null<std::shared_ptr<scene::Model>> InstanceBatch::addInstances(const Prototype& prototype,
+                                                                         const std::vector<Instance>& instances)
+{
+    Expects(!m_finalized);
+    Expects(!instances.empty());
+
+    const auto baseInstance = gsl::narrow<uint32_t>(m_instances.size());
+    m_instances.insert(m_instances.end(), instances.begin(), instances.end());
+
+    auto model = std::make_shared<scene::Model>();
+    for(const auto& part : prototype)
+    {
+        auto mesh = std::make_shared<scene::InstancedMesh>(part.vao,
+                                                           part.indexType,
+                                                           part.indexCount,
+                                                           part.baseVertex,
+                                                           baseInstance,
+                                                           gsl::narrow<::gl::core::SizeType>(instances.size()));
+        mesh->setMaterial(part.material);
+        model->addMesh(mesh);
+    }
+
+    m_stats.instances += instances.size();
+    m_stats.meshes += instances.size() * prototype.size();
+    m_stats.draws += prototype.size();
+
+    return model;
+}
+
+void InstanceBatch::finalize()
+{
+    Expects(!m_finalized);
+    m_finalized = true;
+
+    m_instanceBuffer->setData(m_instances, ::gl::BufferUsageARB::StaticDraw);
+    m_instances = {};
+
+    if(m_billboardVertices.empty())
+        return;
+
+    m_billboardBuffer->setData(m_billboardVertices, ::gl::BufferUsageARB::StaticDraw);
+    m_billboardVertices = {};
+
+    static const std::vector<uint16_t> indices{0, 1, 2, 0, 2, 3};
+    m_billboardIndices->setData(indices, ::gl::BufferUsageARB::StaticDraw);
+}
+} // namespace render
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "render/gl/elementarraybuffer.h"
+#include "render/gl/structuredarraybuffer.h"
+
+#include <memory>
+#include <vector>
+
+namespace render
+{
+namespace gl
+{
+class BindableResource;
+}
+
+namespace scene
+{
+class Material;
+class Model;
+class ShaderProgram;
+} // namespace scene
+
+/**
+ * @brief Holds the placements of static meshes and sprites of a level in a single instance buffer.
+ *
+ * @details
+ * Geometry which is placed multiple times is described by a Prototype, whose vertex arrays include the instance
+ * buffer.  Each call to #addInstances appends a contiguous range of instances and returns a model drawing exactly
+ * these instances, issuing one instanced draw per part of the prototype.  The per-instance transform and brightness
+ * replace the model matrix and @c u_lightAmbient of a dedicated node per placement, so the shaders need to be
+ * compiled with @c INSTANCED.
+ */
+class InstanceBatch final
+{
+public:
+    struct Instance
+    {
+        //! The position relative to the node the instances are drawn from, and the rotation around the Y axis.
+        glm::vec4 transform{0.0f};
+        float brightness = 1.0f;
+
+        static const gl::StructureLayout<Instance>& getLayout();
+    };
+
+    //! A mesh drawn for each instance of a prototype.
+    struct Part
+    {
+        std::shared_ptr<gl::BindableResource> vao;
+        ::gl::DrawElementsType indexType;
+        ::gl::core::SizeType indexCount;
+        int32_t baseVertex;
+        std::shared_ptr<scene::Material> material;
+    };
+
+    using Prototype = std::vector<Part>;
+
+    struct Stats
+    {
+        //! Placements, i.e. the number of nodes needed without instancing.
+        size_t instances = 0;
+        //! Draws needed without instancing.
+        size_t meshes = 0;
+        //! Instanced draws.
+        size_t draws = 0;
+    };
+
+    explicit InstanceBatch(const std::string& label);
+
+    ~InstanceBatch();
+
+    InstanceBatch(const InstanceBatch&) = delete;
+
+    InstanceBatch(InstanceBatch&&) = delete;
+
+    InstanceBatch& operator=(const InstanceBatch&) = delete;
+
+    InstanceBatch& operator=(InstanceBatch&&) = delete;
+
+    const std::shared_ptr<gl::StructuredArrayBuffer<Instance>>& getInstanceBuffer() const noexcept
+    {
+        return m_instanceBuffer;
+    }
+
+    /**
+     * @brief Creates the prototype of a quad facing the camera, only rotating around its Y axis.
+     *
+     * @details
+     * All billboards share a single vertex buffer and vertex array, so their materials must share their
+     * shader program, which must be compiled with @c BILLBOARD.
+     */
+    Prototype addBillboard(float x0,
+                           float y0,
+                           float x1,
+                           float y1,
+                           const glm::vec2& t0,
+                           const glm::vec2& t1,
+                           const std::shared_ptr<scene::Material>& material);
+
+    //! Appends @a instances of @a prototype, and returns a model drawing them.
+    gsl::not_null<std::shared_ptr<scene::Model>> addInstances(const Prototype& prototype,
+                                                              const std::vector<Instance>& instances);
+
+    //! Uploads all instances and billboards; no instances may be added afterwards.
+    void finalize();
+
+    const Stats& getStats() const noexcept
+    {
+        return m_stats;
+    }
+
+private:
+    struct BillboardVertex
+    {
+        glm::vec3 position;
+        glm::vec2 uv;
+        glm::vec3 color{1.0f};
+
+        static const gl::StructureLayout<BillboardVertex>& getLayout();
+    };
+
+    const std::string m_label;
+    bool m_finalized = false;
+    std::vector<Instance> m_instances;
+    std::vector<BillboardVertex> m_billboardVertices;
+    Stats m_stats;
+
+    std::shared_ptr<gl::StructuredArrayBuffer<Instance>> m_instanceBuffer;
+    std::shared_ptr<gl::StructuredArrayBuffer<BillboardVertex>> m_billboardBuffer;
+    std::shared_ptr<gl::ElementArrayBuffer<uint16_t>> m_billboardIndices;
+    std::shared_ptr<gl::BindableResource> m_billboardVao;
+    std::shared_ptr<scene::ShaderProgram> m_billboardProgram;
+};
+} // namespace render
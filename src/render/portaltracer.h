@@ -2,6 +2,8 @@
 
 #include "engine/engine.h"
 #include "loader/file/datatypes.h"
+#include "render/scene/cullbox.h"
+#include "util/profiler.h"
 
 #include <boost/range/adaptor/transformed.hpp>
 
@@ -9,21 +11,13 @@ namespace render
 {
 struct PortalTracer
 {
-    struct CullBox
-    {
-        glm::vec2 min;
-        glm::vec2 max;
-
-        CullBox(const float minX, const float minY, const float maxX, const float maxY)
-            : min{minX, minY}
-            , max{maxX, maxY}
-        {
-        }
-    };
+    using CullBox = scene::CullBox;
 
     static std::unordered_set<const loader::file::Portal*> trace(const loader::file::Room& startRoom,
                                                                  const engine::Engine& engine)
     {
+        util::ProfileZone zone{"portal-tracer"};
+
         std::vector<const loader::file::Room*> seenRooms;
         seenRooms.reserve(32);
         std::unordered_set<const loader::file::Portal*> waterSurfacePortals;
@@ -50,6 +44,17 @@ struct PortalTracer
             return false;
         seenRooms.emplace_back(&room);
 
+        // a room may be seen through multiple portals
+        if(room.node->isVisible() && room.node->getCullBox().is_initialized())
+        {
+            auto cullBox = *room.node->getCullBox();
+            cullBox.unite(roomCullBox);
+            room.node->setCullBox(cullBox);
+        }
+        else
+        {
+            room.node->setCullBox(roomCullBox);
+        }
         room.node->setVisible(true);
         for(const auto& portal : room.portals)
         {
@@ -3,16 +3,27 @@
 #include "gl/debuggroup.h"
 #include "gl/framebuffer.h"
 #include "gl/texture.h"
+#include "gl/timerquery.h"
 #include "scene/Dimension.h"
 #include "scene/Material.h"
 #include "scene/model.h"
 #include "scene/rendercontext.h"
 
+#include <boost/log/trivial.hpp>
 #include <memory>
 #include <random>
 
 namespace render
 {
+enum class SsaoQuality
+{
+    Off,
+    Low,    //!< Half resolution, 8 samples
+    Medium, //!< Half resolution, 16 samples
+    High,   //!< Half resolution, 32 samples
+    Full    //!< Full resolution, 64 samples
+};
+
 class RenderPipeline
 {
     const std::shared_ptr<scene::ShaderProgram> m_fxaaShader
@@ -43,10 +54,9 @@ class RenderPipeline
         = std::make_shared<gl::TextureDepth>("geometry-depth");
     const std::shared_ptr<gl::Texture2D<gl::SRGBA8>> m_geometryColorBuffer
         = std::make_shared<gl::Texture2D<gl::SRGBA8>>("geometry-color");
-    const std::shared_ptr<gl::Texture2D<gl::RGB32F>> m_geometryPositionBuffer
-        = std::make_shared<gl::Texture2D<gl::RGB32F>>("geometry-position");
-    const std::shared_ptr<gl::Texture2D<gl::RGB16F>> m_geometryNormalBuffer
-        = std::make_shared<gl::Texture2D<gl::RGB16F>>("geometry-normal");
+    //! View space normals, octahedral encoded; positions are reconstructed from the depth buffer.
+    const std::shared_ptr<gl::Texture2D<gl::RG16F>> m_geometryNormalBuffer
+        = std::make_shared<gl::Texture2D<gl::RG16F>>("geometry-normal");
     std::shared_ptr<gl::Framebuffer> m_geometryFb;
 
     const std::shared_ptr<gl::Texture2D<gl::RGB32F>> m_ssaoNoiseTexture
@@ -63,6 +73,14 @@ class RenderPipeline
         = std::make_shared<gl::Texture2D<gl::SRGBA8>>("fxaa-color");
     std::shared_ptr<gl::Framebuffer> m_fxaaFb;
 
+    SsaoQuality m_ssaoQuality;
+    scene::Dimension2<size_t> m_viewport{};
+    scene::Dimension2<size_t> m_ssaoViewport{};
+
+    gl::GpuTimer m_ssaoTimer{"ssao-pass"};
+    gl::GpuTimer m_fxaaTimer{"fxaa-pass"};
+    gl::GpuTimer m_postprocessTimer{"postprocess-pass"};
+
 public:
     void bindGeometryFrameBuffer()
     {
@@ -78,23 +96,31 @@ public:
 
     void finalPass(const bool water)
     {
+        if(m_ssaoQuality != SsaoQuality::Off)
         {
+            util::ProfileZone zone{"ssao-pass"};
             gl::DebugGroup dbg{"ssao-pass"};
+            gl::GpuTimerScope gpuTimer{m_ssaoTimer};
             m_ssaoFb->bind();
             scene::RenderContext context{};
             scene::Node dummyNode{""};
             context.setCurrentNode(&dummyNode);
 
+            setViewport(m_ssaoViewport);
             m_fbModel->getMeshes()[0]->setMaterial(m_ssaoMaterial);
             m_fbModel->render(context);
+            setViewport(m_viewport);
 
+            // the blur upsamples the AO to full resolution
             m_ssaoBlurFb->bind();
             m_fbModel->getMeshes()[0]->setMaterial(m_ssaoBlurMaterial);
             m_fbModel->render(context);
         }
 
         {
+            util::ProfileZone zone{"fxaa-pass"};
             gl::DebugGroup dbg{"fxaa-pass"};
+            gl::GpuTimerScope gpuTimer{m_fxaaTimer};
             m_fxaaFb->bind();
             scene::RenderContext context{};
             scene::Node dummyNode{""};
@@ -105,7 +131,9 @@ public:
         }
 
         {
+            util::ProfileZone zone{"postprocess-pass"};
             gl::DebugGroup dbg{"postprocess-pass"};
+            gl::GpuTimerScope gpuTimer{m_postprocessTimer};
             gl::Framebuffer::unbindAll();
             if(water)
                 m_fbModel->getMeshes()[0]->setMaterial(m_fxWaterDarknessMaterial);
@@ -118,7 +146,9 @@ public:
         }
     }
 
-    explicit RenderPipeline(const scene::Dimension2<size_t>& viewport)
+    explicit RenderPipeline(const scene::Dimension2<size_t>& viewport,
+                            const SsaoQuality ssaoQuality = SsaoQuality::Full)
+        : m_ssaoQuality{ssaoQuality}
     {
         resize(viewport);
         /*
@@ -127,7 +157,7 @@ public:
          *                           `         `---------------------------------------------------------------------´
          *                           `-- color --> fxaa.glsl --> fxaaFB ---------------------------------------------´
          *                           `-- normals ---> ssao.glsl --> ssaoFB --> ssaoBlur.glsl --> ssaoBlurFB --> AO --´
-         *                           `-- position --´
+         *                           `-- depth -----´
          */
         // === geometryFB setup ===
         m_geometryColorBuffer->set(::gl::TextureParameterName::TextureWrapS, ::gl::TextureWrapMode::ClampToEdge)
@@ -142,19 +172,13 @@ public:
             .set(::gl::TextureMagFilter::Nearest);
         m_ssaoMaterial->getUniform("u_normals")->set(m_geometryNormalBuffer);
 
-        m_geometryPositionBuffer->set(::gl::TextureParameterName::TextureWrapS, ::gl::TextureWrapMode::ClampToEdge)
-            .set(::gl::TextureParameterName::TextureWrapT, ::gl::TextureWrapMode::ClampToEdge)
-            .set(::gl::TextureMinFilter::Nearest)
-            .set(::gl::TextureMagFilter::Nearest);
-        m_ssaoMaterial->getUniform("u_position")->set(m_geometryPositionBuffer);
-
+        m_ssaoMaterial->getUniform("u_depth")->set(m_geometryDepthBuffer);
         m_fxDarknessMaterial->getUniform("u_depth")->set(m_geometryDepthBuffer);
         m_fxWaterDarknessMaterial->getUniform("u_depth")->set(m_geometryDepthBuffer);
 
         m_geometryFb = gl::FrameBufferBuilder()
                            .texture(::gl::FramebufferAttachment::ColorAttachment0, m_geometryColorBuffer)
                            .texture(::gl::FramebufferAttachment::ColorAttachment1, m_geometryNormalBuffer)
-                           .texture(::gl::FramebufferAttachment::ColorAttachment2, m_geometryPositionBuffer)
                            .texture(::gl::FramebufferAttachment::DepthAttachment, m_geometryDepthBuffer)
                            .build();
 
@@ -187,6 +211,7 @@ public:
             .set(::gl::TextureMinFilter::Linear)
             .set(::gl::TextureMagFilter::Linear);
         m_ssaoBlurMaterial->getUniform("u_ao")->set(m_ssaoAOBuffer);
+        m_ssaoBlurMaterial->getUniform("u_depth")->set(m_geometryDepthBuffer);
 
         m_ssaoFb
             = gl::FrameBufferBuilder().texture(::gl::FramebufferAttachment::ColorAttachment0, m_ssaoAOBuffer).build();
@@ -204,31 +229,9 @@ public:
                            .build();
 
         // === ssao.glsl setup ===
-        // generate sample kernel
+        // the sample kernel depends on the quality, and is set up in resize()
         std::uniform_real_distribution<float> randomFloats(0, 1);
         std::default_random_engine generator{}; // NOLINT(cert-msc32-c)
-        std::vector<glm::vec3> ssaoSamples;
-        while(ssaoSamples.size() < 64)
-        {
-#define SSAO_UNIFORM_VOLUME_SAMPLING
-#ifdef SSAO_SAMPLE_CONTRACTION
-            glm::vec3 sample{randomFloats(generator) * 2 - 1, randomFloats(generator) * 2 - 1, randomFloats(generator)};
-            sample = glm::normalize(sample) * randomFloats(generator);
-            // scale samples s.t. they're more aligned to center of kernel
-            const float scale = float(i) / 64;
-            ssaoSamples.emplace_back(sample * glm::mix(0.1f, 1.0f, scale * scale));
-#elif defined(SSAO_UNIFORM_VOLUME_SAMPLING)
-            glm::vec3 sample{randomFloats(generator) * 2 - 1, randomFloats(generator) * 2 - 1, randomFloats(generator)};
-            if(glm::length(sample) > 1)
-                continue;
-            ssaoSamples.emplace_back(sample);
-#else
-            glm::vec3 sample{randomFloats(generator) * 2 - 1, randomFloats(generator) * 2 - 1, randomFloats(generator)};
-            sample = glm::normalize(sample) * randomFloats(generator);
-            ssaoSamples.emplace_back(sample);
-#endif
-        }
-        m_ssaoMaterial->getUniform("u_samples[0]")->set(ssaoSamples);
 
         // generate noise texture
         std::vector<gl::RGB32F> ssaoNoise;
@@ -266,26 +269,46 @@ public:
         m_fxDarknessMaterial->getUniform("u_camProjection")->set(camera.getProjectionMatrix());
         m_fxWaterDarknessMaterial->getUniform("u_camProjection")->set(camera.getProjectionMatrix());
         m_ssaoMaterial->getUniform("u_camProjection")->set(camera.getProjectionMatrix());
+        m_ssaoMaterial->getUniform("u_inverseCamProjection")->set(glm::inverse(camera.getProjectionMatrix()));
+        m_ssaoBlurMaterial->getUniform("u_inverseCamProjection")->set(glm::inverse(camera.getProjectionMatrix()));
+    }
+
+    SsaoQuality getSsaoQuality() const noexcept
+    {
+        return m_ssaoQuality;
+    }
+
+    void setSsaoQuality(const SsaoQuality quality)
+    {
+        if(quality == m_ssaoQuality)
+            return;
+
+        m_ssaoQuality = quality;
+        resize(m_viewport);
     }
 
     void resize(const scene::Dimension2<size_t>& viewport)
     {
+        // depth values must not be interpolated, as positions are reconstructed from them
         m_portalDepthBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height))
-            .set(::gl::TextureMinFilter::Linear)
-            .set(::gl::TextureMagFilter::Linear);
+            .set(::gl::TextureMinFilter::Nearest)
+            .set(::gl::TextureMagFilter::Nearest);
         m_portalPerturbBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height))
             .set(::gl::TextureMinFilter::Linear)
             .set(::gl::TextureMagFilter::Linear);
         m_geometryDepthBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height))
-            .set(::gl::TextureMinFilter::Linear)
-            .set(::gl::TextureMagFilter::Linear);
+            .set(::gl::TextureMinFilter::Nearest)
+            .set(::gl::TextureMagFilter::Nearest);
         m_geometryColorBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height));
-        m_geometryPositionBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height));
         m_geometryNormalBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height));
-        m_ssaoAOBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height));
-        m_ssaoBlurAOBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height));
+        resizeSsao(viewport);
         m_fxaaColorBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height));
 
+        const auto geometryBytes
+            = viewport.width * viewport.height * (sizeof(gl::SRGBA8) + sizeof(gl::RG16F) + sizeof(float));
+        BOOST_LOG_TRIVIAL(debug) << "Geometry buffers at " << viewport.width << "x" << viewport.height << " use "
+                                 << geometryBytes / 1024 << " kB";
+
         const auto proj = glm::ortho(
             0.0f, gsl::narrow<float>(viewport.width), gsl::narrow<float>(viewport.height), 0.0f, 0.0f, 1.0f);
 
@@ -302,5 +325,75 @@ public:
         m_fbModel->getMeshes().clear();
         m_fbModel->addMesh(fxaaMesh);
     }
+
+private:
+    static void setViewport(const scene::Dimension2<size_t>& viewport)
+    {
+        GL_ASSERT(::gl::viewport(0,
+                                 0,
+                                 gsl::narrow<::gl::core::SizeType>(viewport.width),
+                                 gsl::narrow<::gl::core::SizeType>(viewport.height)));
+    }
+
+    static size_t getSsaoSampleCount(const SsaoQuality quality)
+    {
+        switch(quality)
+        {
+        case SsaoQuality::Off: return 0;
+        case SsaoQuality::Low: return 8;
+        case SsaoQuality::Medium: return 16;
+        case SsaoQuality::High: return 32;
+        case SsaoQuality::Full: return 64;
+        }
+        return 0;
+    }
+
+    void resizeSsao(const scene::Dimension2<size_t>& viewport)
+    {
+        m_viewport = viewport;
+
+        if(m_ssaoQuality == SsaoQuality::Off)
+        {
+            // a single fully lit texel, so that the post-processing doesn't need to care
+            m_ssaoViewport = {1, 1};
+            m_ssaoBlurAOBuffer->image(1, 1, std::vector<gl::Scalar32F>{gl::Scalar32F{1.0f}});
+            return;
+        }
+
+        if(m_ssaoQuality == SsaoQuality::Full)
+            m_ssaoViewport = viewport;
+        else
+            m_ssaoViewport = {std::max<size_t>(viewport.width / 2, 1), std::max<size_t>(viewport.height / 2, 1)};
+
+        m_ssaoAOBuffer->image(gsl::narrow<int32_t>(m_ssaoViewport.width), gsl::narrow<int32_t>(m_ssaoViewport.height));
+        m_ssaoBlurAOBuffer->image(gsl::narrow<int32_t>(viewport.width), gsl::narrow<int32_t>(viewport.height));
+
+        // generate sample kernel; lower qualities use a prefix of the same sequence
+        std::uniform_real_distribution<float> randomFloats(0, 1);
+        std::default_random_engine generator{}; // NOLINT(cert-msc32-c)
+        std::vector<glm::vec3> ssaoSamples;
+        while(ssaoSamples.size() < getSsaoSampleCount(m_ssaoQuality))
+        {
+#define SSAO_UNIFORM_VOLUME_SAMPLING
+#ifdef SSAO_SAMPLE_CONTRACTION
+            glm::vec3 sample{randomFloats(generator) * 2 - 1, randomFloats(generator) * 2 - 1, randomFloats(generator)};
+            sample = glm::normalize(sample) * randomFloats(generator);
+            // scale samples s.t. they're more aligned to center of kernel
+            const float scale = float(ssaoSamples.size()) / getSsaoSampleCount(m_ssaoQuality);
+            ssaoSamples.emplace_back(sample * glm::mix(0.1f, 1.0f, scale * scale));
+#elif defined(SSAO_UNIFORM_VOLUME_SAMPLING)
+            glm::vec3 sample{randomFloats(generator) * 2 - 1, randomFloats(generator) * 2 - 1, randomFloats(generator)};
+            if(glm::length(sample) > 1)
+                continue;
+            ssaoSamples.emplace_back(sample);
+#else
+            glm::vec3 sample{randomFloats(generator) * 2 - 1, randomFloats(generator) * 2 - 1, randomFloats(generator)};
+            sample = glm::normalize(sample) * randomFloats(generator);
+            ssaoSamples.emplace_back(sample);
+#endif
+        }
+        m_ssaoMaterial->getUniform("u_samples[0]")->set(ssaoSamples);
+        m_ssaoMaterial->getUniform("u_sampleCount")->set(gsl::narrow<int32_t>(ssaoSamples.size()));
+    }
 };
 } // namespace render
@@ -0,0 +1,196 @@
+#include "roombatch.h"
+
+#include "render/gl/vertexarray.h"
+#include "render/scene/Material.h"
+#include "render/scene/Node.h"
+#include "render/scene/mesh.h"
+#include "render/scene/names.h"
+#include "render/scene/rendercontext.h"
+#include "util/profiler.h"
+
+namespace render
+{
+class RoomBatch::MultiDrawMesh final : public scene::Mesh
+{
+public:
+    using VertexArray = gl::VertexArray<uint16_t, Vertex, glm::u16vec2, glm::vec3>;
+
+    explicit MultiDrawMesh(std::shared_ptr<VertexArray> vao, std::shared_ptr<gl::DrawIndirectBuffer> commands)
+        : Mesh{::gl::PrimitiveType::Triangles}
+        , m_vao{std::move(vao)}
+        , m_commands{std::move(commands)}
+    {
+    }
+
+    //! Selects the range of the command buffer to be drawn.
+    void setCommands(const size_t first, const size_t count)
+    {
+        m_first = first;
+        m_count = count;
+    }
+
+    size_t getCommandCount() const noexcept
+    {
+        return m_count;
+    }
+
+private:
+    const std::shared_ptr<VertexArray> m_vao;
+    const std::shared_ptr<gl::DrawIndirectBuffer> m_commands;
+    size_t m_first = 0;
+    size_t m_count = 0;
+
+    void drawIndexBuffers(const ::gl::PrimitiveType primitiveType) override
+    {
+        BOOST_ASSERT(m_first + m_count <= static_cast<size_t>(m_commands->size()));
+
+        m_vao->bind();
+        m_commands->bind();
+        GL_ASSERT(::gl::multiDrawElementsIndirect(
+            primitiveType,
+            gl::TypeTraits<uint16_t>::DrawElementsType,
+            reinterpret_cast<const void*>(m_first * sizeof(gl::DrawElementsIndirectCommand)),
+            gsl::narrow<::gl::core::SizeType>(m_count),
+            0));
+        m_vao->unbind();
+    }
+};
+
+const gl::StructureLayout<RoomBatch::Vertex>& RoomBatch::Vertex::getLayout()
+{
+    static const gl::StructureLayout<Vertex> layout{{VERTEX_ATTRIBUTE_POSITION_NAME, &Vertex::position},
+                                                    {VERTEX_ATTRIBUTE_NORMAL_NAME, {&Vertex::normal, true}},
+                                                    {VERTEX_ATTRIBUTE_COLOR_NAME, {&Vertex::color, true}}};
+
+    return layout;
+}
+
+RoomBatch::RoomBatch(const std::string& label)
+    : m_label{label}
+    , m_commandBuffer{std::make_shared<gl::DrawIndirectBuffer>(label + "-commands")}
+{
+    static const gl::StructureLayout<glm::u16vec2> uvLayout{
+        {VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME, {gl::StructureMember<glm::u16vec2>::Trivial{}, true}}};
+    m_uvBuffer = std::make_shared<gl::StructuredArrayBuffer<glm::u16vec2>>(uvLayout, label + "-uv");
+
+    getRenderState().setCullFace(true);
+    getRenderState().setCullFaceSide(::gl::CullFaceMode::Back);
+}
+
+RoomBatch::~RoomBatch() = default;
+
+void RoomBatch::addRoom(const std::shared_ptr<scene::Node>& node,
+                        const glm::vec3& offset,
+                        const std::vector<Vertex>& vertices,
+                        const std::vector<glm::u16vec2>& uvs,
+                        const std::vector<Part>& parts)
+{
+    Expects(!m_finalized);
+    Expects(node != nullptr);
+    Expects(vertices.size() == uvs.size());
+
+    const auto roomIndex = gsl::narrow<uint32_t>(m_rooms.size());
+    m_rooms.emplace_back(Room{node, gsl::narrow<int32_t>(m_vertices.size())});
+    m_offsets.emplace_back(offset);
+    m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
+    m_uvs.insert(m_uvs.end(), uvs.begin(), uvs.end());
+
+    for(const auto& part : parts)
+    {
+        if(part.indices.empty())
+            continue;
+
+        Expects(part.material != nullptr);
+        auto it = m_batchByMaterial.find(part.material.get());
+        if(it == m_batchByMaterial.end())
+        {
+            it = m_batchByMaterial.emplace(part.material.get(), m_batches.size()).first;
+            m_batches.emplace_back(Batch{part.material, {}, nullptr});
+        }
+
+        m_batches[it->second].ranges.emplace_back(Range{
+            roomIndex, gsl::narrow<uint32_t>(m_indices.size()), gsl::narrow<uint32_t>(part.indices.size())});
+        m_indices.insert(m_indices.end(), part.indices.begin(), part.indices.end());
+    }
+}
+
+void RoomBatch::finalize()
+{
+    Expects(!m_finalized);
+    m_finalized = true;
+
+    if(m_indices.empty())
+        return;
+
+    auto vertexBuffer = std::make_shared<gl::StructuredArrayBuffer<Vertex>>(Vertex::getLayout(), m_label);
+    vertexBuffer->setData(m_vertices, ::gl::BufferUsageARB::StaticDraw);
+    m_uvBuffer->setData(m_uvs, ::gl::BufferUsageARB::DynamicDraw);
+
+    static const gl::StructureLayout<glm::vec3> offsetLayout{
+        {VERTEX_ATTRIBUTE_ROOM_OFFSET_NAME, gl::StructureMember<glm::vec3>::Trivial{}}};
+    auto offsetBuffer
+        = std::make_shared<gl::StructuredArrayBuffer<glm::vec3>>(offsetLayout, m_label + "-offsets", 1);
+    offsetBuffer->setData(m_offsets, ::gl::BufferUsageARB::StaticDraw);
+
+    auto indexBuffer = std::make_shared<gl::ElementArrayBuffer<uint16_t>>(m_label + "-indices");
+    indexBuffer->setData(m_indices, ::gl::BufferUsageARB::StaticDraw);
+
+    for(auto& batch : m_batches)
+    {
+        auto vao = std::make_shared<MultiDrawMesh::VertexArray>(
+            MultiDrawMesh::VertexArray::IndexBuffers{indexBuffer},
+            MultiDrawMesh::VertexArray::VertexBuffers{vertexBuffer, m_uvBuffer, offsetBuffer},
+            batch.material->getShaderProgram()->getHandle(),
+            m_label);
+        batch.mesh = std::make_shared<MultiDrawMesh>(vao, m_commandBuffer);
+        batch.mesh->setMaterial(batch.material);
+    }
+
+    // the geometry is only needed by the GPU from now on
+    m_vertices = {};
+    m_uvs = {};
+    m_offsets = {};
+    m_indices = {};
+}
+
+void RoomBatch::render(scene::RenderContext& context)
+{
+    util::ProfileZone zone{"room-batch"};
+
+    BOOST_ASSERT(m_finalized);
+
+    m_stats = Stats{};
+    m_commands.clear();
+    for(const auto& batch : m_batches)
+    {
+        const auto first = m_commands.size();
+        for(const auto& range : batch.ranges)
+        {
+            const auto& room = m_rooms[range.room];
+            if(!room.node->isVisible())
+                continue;
+
+            m_commands.emplace_back(
+                gl::DrawElementsIndirectCommand{range.count, 1, range.firstIndex, room.baseVertex, range.room});
+        }
+        batch.mesh->setCommands(first, m_commands.size() - first);
+    }
+
+    if(m_commands.empty())
+        return;
+
+    m_commandBuffer->setData(m_commands, ::gl::BufferUsageARB::StreamDraw);
+    m_stats.commands = m_commands.size();
+
+    context.pushState(getRenderState());
+    for(const auto& batch : m_batches)
+    {
+        if(batch.mesh->getCommandCount() == 0)
+            continue;
+
+        batch.mesh->render(context);
+        ++m_stats.draws;
+    }
+    context.popState();
+}
+} // namespace render
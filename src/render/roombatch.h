@@ -0,0 +1,145 @@
+#pragma once
+
+#include "render/gl/drawindirectbuffer.h"
+#include "render/gl/elementarraybuffer.h"
+#include "render/gl/structuredarraybuffer.h"
+#include "render/scene/renderable.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace render
+{
+namespace scene
+{
+class Material;
+class Node;
+} // namespace scene
+
+/**
+ * @brief Holds the static geometry of all rooms of a level in a single vertex and index arena.
+ *
+ * @details
+ * Rooms only register their geometry here instead of owning meshes.  When rendered, the batch collects the
+ * ranges of all rooms whose nodes are visible, i.e. which were reached by the PortalTracer, and draws them with a
+ * single @c glMultiDrawElementsIndirect per material.  Room vertices are stored relative to their room, so the
+ * room offsets are provided by an instanced attribute, which is selected through the base instance of each
+ * command.  The batch must be drawn from a node with an identity model matrix, which is visited after all room
+ * nodes.
+ */
+class RoomBatch final : public scene::Renderable
+{
+public:
+    struct Vertex
+    {
+        glm::i16vec3 position{0};
+        int16_t padding = 0;
+        gl::Snorm3x10 normal;
+        glm::u8vec4 color{255};
+
+        static const gl::StructureLayout<Vertex>& getLayout();
+    };
+
+    struct Part
+    {
+        std::vector<uint16_t> indices;
+        std::shared_ptr<scene::Material> material;
+    };
+
+    struct Stats
+    {
+        //! Visible room parts, i.e. the number of draws without batching.
+        size_t commands = 0;
+        //! Multi-draw calls issued.
+        size_t draws = 0;
+    };
+
+    explicit RoomBatch(const std::string& label);
+
+    ~RoomBatch() override;
+
+    RoomBatch(const RoomBatch&) = delete;
+
+    RoomBatch(RoomBatch&&) = delete;
+
+    RoomBatch& operator=(const RoomBatch&) = delete;
+
+    RoomBatch& operator=(RoomBatch&&) = delete;
+
+    //! The index of the first vertex of the next room to be added.
+    size_t getVertexCount() const noexcept
+    {
+        return m_vertices.size();
+    }
+
+    //! The texture coordinates of all rooms, which are kept separately so that they can be animated.
+    const std::shared_ptr<gl::StructuredArrayBuffer<glm::u16vec2>>& getUvBuffer() const noexcept
+    {
+        return m_uvBuffer;
+    }
+
+    /**
+     * @brief Appends the geometry of a room.
+     * @param node The room's node, which decides about the room's visibility.
+     * @param offset The position of the room.
+     * @param vertices The room's vertices, relative to @a offset.
+     * @param uvs The texture coordinates of @a vertices.
+     * @param parts Triangle lists indexing into @a vertices.
+     */
+    void addRoom(const std::shared_ptr<scene::Node>& node,
+                 const glm::vec3& offset,
+                 const std::vector<Vertex>& vertices,
+                 const std::vector<glm::u16vec2>& uvs,
+                 const std::vector<Part>& parts);
+
+    //! Uploads the geometry of all rooms; no rooms may be added afterwards.
+    void finalize();
+
+    void render(scene::RenderContext& context) override;
+
+    //! Statistics of the last rendering.
+    const Stats& getStats() const noexcept
+    {
+        return m_stats;
+    }
+
+private:
+    class MultiDrawMesh;
+
+    struct Room
+    {
+        std::shared_ptr<scene::Node> node;
+        int32_t baseVertex;
+    };
+
+    struct Range
+    {
+        uint32_t room;
+        uint32_t firstIndex;
+        uint32_t count;
+    };
+
+    struct Batch
+    {
+        std::shared_ptr<scene::Material> material;
+        std::vector<Range> ranges;
+        std::shared_ptr<MultiDrawMesh> mesh;
+    };
+
+    const std::string m_label;
+    bool m_finalized = false;
+    std::vector<Room> m_rooms;
+    std::vector<Vertex> m_vertices;
+    std::vector<glm::u16vec2> m_uvs;
+    std::vector<glm::vec3> m_offsets;
+    std::vector<uint16_t> m_indices;
+    std::vector<Batch> m_batches;
+    std::map<const scene::Material*, size_t> m_batchByMaterial;
+    std::vector<gl::DrawElementsIndirectCommand> m_commands;
+    Stats m_stats;
+
+    std::shared_ptr<gl::StructuredArrayBuffer<glm::u16vec2>> m_uvBuffer;
+    std::shared_ptr<gl::DrawIndirectBuffer> m_commandBuffer;
+};
+} // namespace render
@@ -29,7 +29,7 @@ Material::Material(const std::string& vshPath, const std::string& fshPath, const
 {
 }
 
-void Material::bind(const Node& node) const
+void Material::bind(const Node& node, const bool bindProgram) const
 {
     for(const auto& param : m_uniforms)
     {
@@ -53,7 +53,8 @@ void Material::bind(const Node& node) const
 #endif
     }
 
-    m_shaderProgram->bind();
+    if(bindProgram)
+        m_shaderProgram->bind();
 }
 
 gsl::not_null<std::shared_ptr<UniformParameter>> Material::getUniform(const std::string& name) const
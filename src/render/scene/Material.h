@@ -37,7 +37,8 @@ public:
         return m_shaderProgram;
     }
 
-    void bind(const Node& node) const;
+    //! Sets the uniforms for @a node; binding the program may be skipped if the caller knows it's already bound.
+    void bind(const Node& node, bool bindProgram = true) const;
 
     gsl::not_null<std::shared_ptr<UniformParameter>> getUniform(const std::string& name) const;
     gsl::not_null<std::shared_ptr<BufferParameter>> getBuffer(const std::string& name) const;
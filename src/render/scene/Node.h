@@ -2,10 +2,12 @@
 
 #include "Visitor.h"
 #include "bufferparameter.h"
+#include "cullbox.h"
 #include "model.h"
 #include "uniformparameter.h"
 
 #include <boost/container/flat_map.hpp>
+#include <boost/optional.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace render
@@ -45,6 +47,28 @@ public:
 
     bool isVisible() const;
 
+    //! Restricts the visible area of this node's children, e.g. to the portal window a room is seen through.
+    void setCullBox(const boost::optional<CullBox>& cullBox)
+    {
+        m_cullBox = cullBox;
+    }
+
+    const boost::optional<CullBox>& getCullBox() const
+    {
+        return m_cullBox;
+    }
+
+    //! Encloses this node and its children; nodes without a bounding sphere are never culled.
+    void setBoundingSphere(const boost::optional<BoundingSphere>& sphere)
+    {
+        m_boundingSphere = sphere;
+    }
+
+    const boost::optional<BoundingSphere>& getBoundingSphere() const
+    {
+        return m_boundingSphere;
+    }
+
     virtual const glm::mat4& getModelMatrix() const;
 
     glm::mat4 getModelViewMatrix() const;
@@ -157,6 +181,10 @@ private:
 
     bool m_visible = true;
 
+    boost::optional<CullBox> m_cullBox;
+
+    boost::optional<BoundingSphere> m_boundingSphere;
+
     std::shared_ptr<Renderable> m_drawable = nullptr;
 
     glm::mat4 m_localMatrix{1.0f};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cullbox.h"
 #include "gsl-lite.hpp"
 #include "mesh.h"
 #include "renderable.h"
@@ -29,6 +30,10 @@ public:
                     const gsl::not_null<std::shared_ptr<Material>>& material,
                     const Axis pole)
         : m_mesh{createMesh(x0, y0, x1, y1, t0, t1, material, pole)}
+        // the sprite rotates around its origin, so cover all orientations
+        , m_boundingSphere{
+              glm::vec3{0.0f},
+              glm::length(glm::vec2{std::max(std::abs(x0), std::abs(x1)), std::max(std::abs(y0), std::abs(y1))})}
     {
     }
 
@@ -44,6 +49,11 @@ public:
 
     void render(RenderContext& context) override;
 
+    const BoundingSphere& getBoundingSphere() const noexcept
+    {
+        return m_boundingSphere;
+    }
+
 private:
     static gsl::not_null<std::shared_ptr<Mesh>> createMesh(float x0,
                                                            float y0,
@@ -55,6 +65,7 @@ private:
                                                            Axis pole);
 
     gsl::not_null<std::shared_ptr<Mesh>> m_mesh;
+    const BoundingSphere m_boundingSphere;
 };
 } // namespace scene
 } // namespace render
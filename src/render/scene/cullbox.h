@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace render
+{
+namespace scene
+{
+//! A rectangle in normalized device coordinates.
+struct CullBox
+{
+    glm::vec2 min;
+    glm::vec2 max;
+
+    CullBox(const float minX, const float minY, const float maxX, const float maxY)
+        : min{minX, minY}
+        , max{maxX, maxY}
+    {
+    }
+
+    void unite(const CullBox& other)
+    {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    bool intersects(const CullBox& other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y;
+    }
+};
+
+//! A sphere in a node's local coordinates.
+struct BoundingSphere
+{
+    glm::vec3 center;
+    float radius;
+
+    static BoundingSphere fromBox(const glm::vec3& a, const glm::vec3& b)
+    {
+        return BoundingSphere{(a + b) / 2.0f, glm::length(b - a) / 2};
+    }
+
+    //! Grows this sphere as little as possible so that it also encloses @a other.
+    void enclose(const BoundingSphere& other)
+    {
+        const auto distance = glm::length(other.center - center);
+        if(distance + other.radius <= radius)
+            return;
+        if(distance + radius <= other.radius)
+        {
+            *this = other;
+            return;
+        }
+
+        const auto newRadius = (distance + radius + other.radius) / 2;
+        center += (other.center - center) * ((newRadius - radius) / distance);
+        radius = newRadius;
+    }
+};
+} // namespace scene
+} // namespace render
@@ -2,6 +2,7 @@
 
 #include "Material.h"
 #include "names.h"
+#include "renderqueue.h"
 
 #include <utility>
 
@@ -49,19 +50,30 @@ void Mesh::render(RenderContext& context)
     BOOST_ASSERT(context.getCurrentNode() != nullptr);
 
     context.pushState(getRenderState());
-
-    for(const auto& setter : m_materialUniformSetters)
-        setter(*context.getCurrentNode(), *m_material);
-
     context.pushState(m_material->getRenderState());
-    context.bindState();
-
-    m_material->bind(*context.getCurrentNode());
 
-    drawIndexBuffers(m_primitiveType);
+    if(const auto queue = context.getRenderQueue())
+    {
+        queue->add(*this, *context.getCurrentNode(), context.getCurrentState());
+    }
+    else
+    {
+        context.bindState();
+        draw(*context.getCurrentNode(), true);
+    }
 
     context.popState();
     context.popState();
 }
+
+void Mesh::draw(const Node& node, const bool bindProgram)
+{
+    for(const auto& setter : m_materialUniformSetters)
+        setter(node, *m_material);
+
+    m_material->bind(node, bindProgram);
+
+    drawIndexBuffers(m_primitiveType);
+}
 } // namespace scene
 } // namespace render
@@ -10,6 +10,7 @@ namespace render
 namespace scene
 {
 class Material;
+class RenderQueue;
 
 class Mesh : public Renderable
 {
@@ -49,6 +50,11 @@ public:
     }
 
 private:
+    friend RenderQueue;
+
+    //! Binds the material for @a node, and issues the draw; the render state must already be applied.
+    void draw(const Node& node, bool bindProgram);
+
     std::shared_ptr<Material> m_material;
 
     std::vector<std::function<MaterialUniformSetter>> m_materialUniformSetters;
@@ -101,6 +107,59 @@ private:
     }
 };
 
+/**
+ * @brief Draws a range of instances of indexed geometry.
+ *
+ * @details
+ * The per-instance data is expected in instanced vertex attributes of @a vao; the instances to be drawn are
+ * selected through the base instance, so that meshes can share their vertex array.
+ */
+class InstancedMesh final : public Mesh
+{
+public:
+    explicit InstancedMesh(std::shared_ptr<gl::BindableResource> vao,
+                           const ::gl::DrawElementsType indexType,
+                           const ::gl::core::SizeType indexCount,
+                           const int32_t baseVertex,
+                           const uint32_t baseInstance,
+                           const ::gl::core::SizeType instanceCount)
+        : Mesh{::gl::PrimitiveType::Triangles}
+        , m_vao{std::move(vao)}
+        , m_indexType{indexType}
+        , m_indexCount{indexCount}
+        , m_baseVertex{baseVertex}
+        , m_baseInstance{baseInstance}
+        , m_instanceCount{instanceCount}
+    {
+    }
+
+    ~InstancedMesh() override = default;
+
+    InstancedMesh(const InstancedMesh&) = delete;
+
+    InstancedMesh(InstancedMesh&&) = delete;
+
+    InstancedMesh& operator=(InstancedMesh&&) = delete;
+
+    InstancedMesh& operator=(const InstancedMesh&) = delete;
+
+private:
+    gsl::not_null<std::shared_ptr<gl::BindableResource>> m_vao;
+    const ::gl::DrawElementsType m_indexType;
+    const ::gl::core::SizeType m_indexCount;
+    const int32_t m_baseVertex;
+    const uint32_t m_baseInstance;
+    const ::gl::core::SizeType m_instanceCount;
+
+    void drawIndexBuffers(const ::gl::PrimitiveType primitiveType) override
+    {
+        m_vao->bind();
+        GL_ASSERT(::gl::drawElementsInstancedBaseVertexBaseInstance(
+            primitiveType, m_indexCount, m_indexType, nullptr, m_instanceCount, m_baseVertex, m_baseInstance));
+        m_vao->unbind();
+    }
+};
+
 extern gsl::not_null<std::shared_ptr<Mesh>>
     createQuadFullscreen(float width, float height, const gl::Program& program, bool invertY = false);
 } // namespace scene
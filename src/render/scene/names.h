@@ -4,3 +4,6 @@
 #define VERTEX_ATTRIBUTE_NORMAL_NAME "a_normal"
 #define VERTEX_ATTRIBUTE_COLOR_NAME "a_color"
 #define VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME "a_texCoord"
+#define VERTEX_ATTRIBUTE_ROOM_OFFSET_NAME "a_roomOffset"
+#define VERTEX_ATTRIBUTE_INSTANCE_TRANSFORM_NAME "a_instanceTransform"
+#define VERTEX_ATTRIBUTE_INSTANCE_BRIGHTNESS_NAME "a_instanceBrightness"
@@ -0,0 +1,173 @@
+#include "quadbatch.h"
+
+#include "Material.h"
+#include "mesh.h"
+#include "uniformparameter.h"
+
+#include <array>
+#include <boost/log/trivial.hpp>
+#include <functional>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace render
+{
+namespace scene
+{
+namespace
+{
+class InstancedQuadMesh final : public Mesh
+{
+public:
+    template<typename T>
+    explicit InstancedQuadMesh(std::shared_ptr<gl::VertexArray<uint16_t, T>> vao,
+                               std::function<::gl::core::SizeType()> instanceCount)
+        : Mesh{::gl::PrimitiveType::TriangleStrip}
+        , m_vao{std::move(vao)}
+        , m_instanceCount{std::move(instanceCount)}
+    {
+    }
+
+private:
+    const std::shared_ptr<gl::BindableResource> m_vao;
+    const std::function<::gl::core::SizeType()> m_instanceCount;
+
+    void drawIndexBuffers(const ::gl::PrimitiveType primitiveType) override
+    {
+        m_vao->bind();
+        // the quad corners are derived from gl_VertexID, so there are no per-vertex attributes
+        GL_ASSERT(::gl::drawArraysInstancedBaseInstance(primitiveType, 0, 4, m_instanceCount(), 0));
+        m_vao->unbind();
+    }
+};
+} // namespace
+
+QuadBatch::QuadBatch(const Dimension2<size_t>& viewport)
+{
+    m_atlas->image(AtlasSize, AtlasSize)
+        .set(::gl::TextureMinFilter::Nearest)
+        .set(::gl::TextureMagFilter::Nearest)
+        .set(::gl::TextureParameterName::TextureWrapS, ::gl::TextureWrapMode::ClampToEdge)
+        .set(::gl::TextureParameterName::TextureWrapT, ::gl::TextureWrapMode::ClampToEdge);
+
+    static const std::array<gl::SRGBA8, 4> white{
+        gl::SRGBA8{255, 255, 255, 255}, {255, 255, 255, 255}, {255, 255, 255, 255}, {255, 255, 255, 255}};
+    m_whiteTile = addImage(2, 2, white.data());
+    // sample the center of the white tile only
+    auto& whiteUv = m_tiles[m_whiteTile].uvRect;
+    const glm::vec2 whiteCenter{(whiteUv.x + whiteUv.z) / 2, (whiteUv.y + whiteUv.w) / 2};
+    whiteUv = glm::vec4{whiteCenter, whiteCenter};
+
+    const auto program = ShaderProgram::createFromFile("shaders/quadbatch.vert", "shaders/quadbatch.frag", {});
+
+    static const gl::StructureLayout<Quad> layout{
+        {"a_rect", &Quad::rect}, {"a_uvRect", &Quad::uvRect}, {"a_color", &Quad::color}};
+    m_instances = std::make_shared<gl::StructuredArrayBuffer<Quad>>(layout, "quad-batch-instances", 1);
+
+    auto vao = std::make_shared<gl::VertexArray<uint16_t, Quad>>(
+        gl::VertexArray<uint16_t, Quad>::IndexBuffers{},
+        gl::VertexArray<uint16_t, Quad>::VertexBuffers{m_instances},
+        program->getHandle(),
+        "quad-batch");
+
+    m_mesh = std::make_shared<InstancedQuadMesh>(
+        vao, [this]() { return gsl::narrow<::gl::core::SizeType>(m_quads.size()); });
+    m_mesh->setMaterial(std::make_shared<Material>(program));
+    m_mesh->getMaterial()->getUniform("u_texture")->set(m_atlas.get());
+
+    getRenderState().setCullFace(false);
+    getRenderState().setDepthWrite(false);
+    getRenderState().setDepthTest(false);
+
+    setViewport(viewport);
+}
+
+QuadBatch::~QuadBatch() = default;
+
+void QuadBatch::setViewport(const Dimension2<size_t>& viewport)
+{
+    if(viewport.width <= 0 || viewport.height <= 0)
+    {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Cannot create quad batch because the viewport is empty"));
+    }
+
+    m_width = gsl::narrow<int32_t>(viewport.width);
+    m_height = gsl::narrow<int32_t>(viewport.height);
+
+    m_mesh->getMaterial()
+        ->getUniform("u_projection")
+        ->set(glm::ortho(0.0f, gsl::narrow<float>(m_width), gsl::narrow<float>(m_height), 0.0f, 0.0f, 1.0f));
+}
+
+QuadBatch::TileId QuadBatch::addImage(const int32_t width, const int32_t height, const gl::SRGBA8* data)
+{
+    Expects(width > 0 && height > 0);
+
+    // keep a pixel of space between tiles, so that they don't bleed into each other
+    const auto pos = m_layout.tryInsert(width + 1, height + 1);
+    if(!pos.is_initialized())
+    {
+        BOOST_LOG_TRIVIAL(error) << "No space left in quad batch atlas for an image of size " << width << "x"
+                                 << height;
+        BOOST_THROW_EXCEPTION(std::runtime_error("Quad batch atlas is full"));
+    }
+
+    m_atlas->subImage(pos->x, pos->y, width, height, data);
+
+    const glm::vec2 uv0{*pos};
+    const glm::vec2 uv1{*pos + glm::ivec2{width, height}};
+    m_tiles.emplace_back(Tile{glm::vec4{uv0, uv1} / gsl::narrow<float>(AtlasSize), glm::ivec2{width, height}});
+    return m_tiles.size() - 1;
+}
+
+QuadBatch::TileId QuadBatch::addSubTile(const TileId tile, const glm::ivec2& offset, const glm::ivec2& size)
+{
+    const auto& parent = m_tiles.at(tile);
+    Expects(offset.x >= 0 && offset.y >= 0 && size.x > 0 && size.y > 0);
+    Expects(offset.x + size.x <= parent.size.x && offset.y + size.y <= parent.size.y);
+
+    const auto uv0 = glm::vec2{parent.uvRect.x, parent.uvRect.y} + glm::vec2{offset} / gsl::narrow<float>(AtlasSize);
+    const auto uv1 = uv0 + glm::vec2{size} / gsl::narrow<float>(AtlasSize);
+    m_tiles.emplace_back(Tile{glm::vec4{uv0, uv1}, size});
+    return m_tiles.size() - 1;
+}
+
+void QuadBatch::addQuad(const glm::vec4& rect, const glm::vec4& uvRect, const gl::SRGBA8& color)
+{
+    m_quads.emplace_back(Quad{rect, uvRect, glm::vec4{color.r, color.g, color.b, color.a} / 255.0f});
+}
+
+void QuadBatch::draw(const TileId tile, const int32_t x, const int32_t y, const gl::SRGBA8& color)
+{
+    const auto& t = m_tiles.at(tile);
+    addQuad(glm::vec4{x, y, t.size.x, t.size.y}, t.uvRect, color);
+}
+
+void QuadBatch::fill(
+    const int32_t x, const int32_t y, const int32_t width, const int32_t height, const gl::SRGBA8& color)
+{
+    if(width <= 0 || height <= 0)
+        return;
+
+    addQuad(glm::vec4{x, y, width, height}, m_tiles[m_whiteTile].uvRect, color);
+}
+
+void QuadBatch::line(const int32_t x0, const int32_t y0, const int32_t x1, const int32_t y1, const gl::SRGBA8& color)
+{
+    Expects(x0 == x1 || y0 == y1);
+
+    fill(std::min(x0, x1), std::min(y0, y1), std::abs(x1 - x0) + 1, std::abs(y1 - y0) + 1, color);
+}
+
+void QuadBatch::render(RenderContext& context)
+{
+    if(m_quads.empty())
+        return;
+
+    m_instances->setData(m_quads, ::gl::BufferUsageARB::StreamDraw);
+
+    context.pushState(getRenderState());
+    m_mesh->render(context);
+    context.popState();
+}
+} // namespace scene
+} // namespace render
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Dimension.h"
+#include "render/bsptree.h"
+#include "render/gl/image.h"
+#include "render/gl/structuredarraybuffer.h"
+#include "render/gl/texture.h"
+#include "renderable.h"
+
+#include <memory>
+#include <vector>
+
+namespace render
+{
+namespace scene
+{
+class Mesh;
+
+/**
+ * @brief Draws screen-space quads, like the HUD and text, with a single instanced draw call.
+ *
+ * @details
+ * Images drawn through the batch are packed into a texture atlas once when they are added, so drawing only appends
+ * a few floats of per-quad instance data, which are uploaded in one go in #render.  Solid rectangles use a white
+ * tile of the atlas, so they don't break the batch.
+ */
+class QuadBatch final : public Renderable
+{
+public:
+    using TileId = size_t;
+
+    static constexpr int32_t AtlasSize = 1024;
+
+    QuadBatch(const QuadBatch&) = delete;
+
+    QuadBatch(QuadBatch&&) = delete;
+
+    QuadBatch& operator=(QuadBatch&&) = delete;
+
+    QuadBatch& operator=(const QuadBatch&) = delete;
+
+    explicit QuadBatch(const Dimension2<size_t>& viewport);
+
+    ~QuadBatch() override;
+
+    void setViewport(const Dimension2<size_t>& viewport);
+
+    int32_t getWidth() const noexcept
+    {
+        return m_width;
+    }
+
+    int32_t getHeight() const noexcept
+    {
+        return m_height;
+    }
+
+    //! Packs an image into the atlas; throws if there's no space left.
+    TileId addImage(int32_t width, int32_t height, const gl::SRGBA8* data);
+
+    TileId addImage(const gl::Image<gl::SRGBA8>& image)
+    {
+        return addImage(image.getWidth(), image.getHeight(), image.getData().data());
+    }
+
+    //! Creates a tile referring to a region of an existing tile, e.g. a glyph within a pre-packed font atlas.
+    TileId addSubTile(TileId tile, const glm::ivec2& offset, const glm::ivec2& size);
+
+    const glm::ivec2& getTileSize(const TileId tile) const
+    {
+        return m_tiles.at(tile).size;
+    }
+
+    //! Removes all quads drawn so far; the atlas is kept.
+    void clear()
+    {
+        m_quads.clear();
+    }
+
+    //! Draws a tile at its native size, with its texels multiplied by @a color.
+    void draw(TileId tile, int32_t x, int32_t y, const gl::SRGBA8& color = {255, 255, 255, 255});
+
+    void fill(int32_t x, int32_t y, int32_t width, int32_t height, const gl::SRGBA8& color);
+
+    //! Draws a horizontal or vertical line, including both end points.
+    void line(int32_t x0, int32_t y0, int32_t x1, int32_t y1, const gl::SRGBA8& color);
+
+    size_t getQuadCount() const noexcept
+    {
+        return m_quads.size();
+    }
+
+    void render(RenderContext& context) override;
+
+private:
+    struct Quad
+    {
+        glm::vec4 rect;   //!< x, y, width, height in pixels
+        glm::vec4 uvRect; //!< top left and bottom right texture coordinates
+        glm::vec4 color;
+    };
+
+    struct Tile
+    {
+        glm::vec4 uvRect;
+        glm::ivec2 size;
+    };
+
+    void addQuad(const glm::vec4& rect, const glm::vec4& uvRect, const gl::SRGBA8& color);
+
+    int32_t m_width = 0;
+    int32_t m_height = 0;
+    BSPTree m_layout{0, 0, AtlasSize, AtlasSize};
+    std::vector<Tile> m_tiles;
+    TileId m_whiteTile = 0;
+    std::vector<Quad> m_quads;
+    gsl::not_null<std::shared_ptr<gl::Texture2D<gl::SRGBA8>>> m_atlas{
+        std::make_shared<gl::Texture2D<gl::SRGBA8>>("quad-batch-atlas")};
+    std::shared_ptr<gl::StructuredArrayBuffer<Quad>> m_instances;
+    std::shared_ptr<Mesh> m_mesh;
+};
+} // namespace scene
+} // namespace render
@@ -10,6 +10,7 @@ namespace render
 namespace scene
 {
 class Node;
+class RenderQueue;
 
 class RenderContext final
 {
@@ -29,6 +30,23 @@ public:
         m_currentNode = n;
     }
 
+    //! If set, meshes record their draws into the queue instead of drawing immediately.
+    RenderQueue* getRenderQueue() const noexcept
+    {
+        return m_renderQueue;
+    }
+
+    void setRenderQueue(RenderQueue* queue) noexcept
+    {
+        m_renderQueue = queue;
+    }
+
+    const render::gl::RenderState& getCurrentState() const
+    {
+        Expects(!m_renderStates.empty());
+        return m_renderStates.top();
+    }
+
     void pushState(const render::gl::RenderState& state)
     {
         auto tmp = m_renderStates.top();
@@ -49,6 +67,7 @@ public:
 
 private:
     Node* m_currentNode = nullptr;
+    RenderQueue* m_renderQueue = nullptr;
     std::stack<render::gl::RenderState> m_renderStates{};
 };
 } // namespace scene
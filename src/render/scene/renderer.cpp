@@ -4,6 +4,7 @@
 #include "names.h"
 #include "render/gl/debuggroup.h"
 #include "rendercontext.h"
+#include "renderqueue.h"
 
 namespace render
 {
@@ -11,6 +12,7 @@ namespace scene
 {
 Renderer::Renderer()
     : m_scene{std::make_shared<Scene>()}
+    , m_renderQueue{std::make_unique<RenderQueue>()}
 {
 }
 
@@ -21,8 +23,9 @@ namespace
 class RenderVisitor : public Visitor
 {
 public:
-    explicit RenderVisitor(RenderContext& context)
+    explicit RenderVisitor(RenderContext& context, Renderer::CullingStats& stats)
         : Visitor{context}
+        , m_stats{stats}
     {
     }
 
@@ -33,6 +36,16 @@ public:
             return;
         }
 
+        if(node.getBoundingSphere().is_initialized())
+        {
+            ++m_stats.tested;
+            if(!isInView(node, *node.getBoundingSphere()))
+            {
+                ++m_stats.culled;
+                return;
+            }
+        }
+
         gl::DebugGroup debugGroup{node.getId()};
 
         getContext().setCurrentNode(&node);
@@ -42,7 +55,43 @@ public:
             dr->render(getContext());
         }
 
+        const auto parentCullBox = m_cullBox;
+        if(node.getCullBox().is_initialized())
+            m_cullBox = *node.getCullBox();
         Visitor::visit(node);
+        m_cullBox = parentCullBox;
+    }
+
+private:
+    Renderer::CullingStats& m_stats;
+    //! The screen area the children of the current node are restricted to.
+    CullBox m_cullBox{-1, -1, 1, 1};
+
+    bool isInView(const Node& node, const BoundingSphere& sphere) const
+    {
+        const auto& projection = node.getProjectionMatrix();
+        // extract the clip planes from the perspective projection
+        const auto nearPlane = projection[3][2] / (projection[2][2] - 1);
+        const auto farPlane = projection[3][2] / (projection[2][2] + 1);
+
+        const glm::vec3 center{node.getModelViewMatrix() * glm::vec4{sphere.center, 1.0f}};
+        const auto r = sphere.radius;
+        const auto depth = -center.z;
+        if(depth + r < nearPlane || depth - r > farPlane)
+            return false;
+        if(depth - r <= nearPlane)
+            return true; // intersects the near plane, so it can't be projected reliably
+
+        // project the view space box around the sphere, using the depth which extends each bound the most
+        const auto projectMin
+            = [depth, r](const float v, const float scale) { return scale * v / (v >= 0 ? depth + r : depth - r); };
+        const auto projectMax
+            = [depth, r](const float v, const float scale) { return scale * v / (v >= 0 ? depth - r : depth + r); };
+        const CullBox screen{projectMin(center.x - r, projection[0][0]),
+                             projectMin(center.y - r, projection[1][1]),
+                             projectMax(center.x + r, projection[0][0]),
+                             projectMax(center.y + r, projection[1][1])};
+        return screen.intersects(m_cullBox);
     }
 };
 } // namespace
@@ -53,8 +102,11 @@ void Renderer::render()
     clear(::gl::ClearBufferMask::ColorBufferBit | ::gl::ClearBufferMask::DepthBufferBit, {0, 0, 0, 0}, 1);
 
     RenderContext context{};
-    RenderVisitor visitor{context};
+    context.setRenderQueue(m_renderQueue.get());
+    m_cullingStats = CullingStats{};
+    RenderVisitor visitor{context, m_cullingStats};
     m_scene->accept(visitor);
+    m_renderQueue->submit();
 
     // Update FPS.
     ++m_frameCount;
@@ -5,6 +5,7 @@
 #include "render/gl/renderstate.h"
 
 #include <chrono>
+#include <memory>
 
 namespace render
 {
@@ -14,9 +15,17 @@ class Scene;
 
 class RenderContext;
 
+class RenderQueue;
+
 class Renderer final
 {
 public:
+    struct CullingStats
+    {
+        size_t tested = 0; //!< Nodes with a bounding sphere
+        size_t culled = 0;
+    };
+
     Renderer(const Renderer&) = delete;
 
     Renderer(Renderer&&) = delete;
@@ -50,6 +59,17 @@ public:
         return m_scene;
     }
 
+    const RenderQueue& getRenderQueue() const
+    {
+        return *m_renderQueue;
+    }
+
+    //! Statistics of the last frame.
+    const CullingStats& getCullingStats() const noexcept
+    {
+        return m_cullingStats;
+    }
+
 private:
     const std::chrono::high_resolution_clock::time_point m_constructionTime{std::chrono::high_resolution_clock::now()};
 
@@ -60,6 +80,8 @@ private:
     float m_clearDepth = 1;  // The clear depth value last used for clearing the depth buffer.
 
     std::shared_ptr<Scene> m_scene;
+    std::unique_ptr<RenderQueue> m_renderQueue;
+    CullingStats m_cullingStats;
 };
 } // namespace scene
 } // namespace render
@@ -0,0 +1,115 @@
+#include "renderqueue.h"
+
+#include "Material.h"
+#include "Node.h"
+#include "mesh.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace render
+{
+namespace scene
+{
+namespace
+{
+//! Maps a non-negative depth to 31 bits which keep the ordering of the values.
+uint64_t getDepthBits(const float depth)
+{
+    const float clamped = std::max(depth, 0.0f);
+    uint32_t bits;
+    static_assert(sizeof(bits) == sizeof(clamped), "Unexpected float size");
+    std::memcpy(&bits, &clamped, sizeof(bits));
+    return bits & 0x7fffffffu;
+}
+} // namespace
+
+RenderQueue::~RenderQueue() = default;
+
+uint16_t RenderQueue::getMaterialId(const Material* material)
+{
+    // ids are dense per submission, so that they fit into the sort key
+    const auto it = m_materialIds.find(material);
+    if(it != m_materialIds.end())
+        return it->second;
+
+    const auto id = gsl::narrow_cast<uint16_t>(m_materialIds.size());
+    m_materialIds.emplace(material, id);
+    return id;
+}
+
+void RenderQueue::add(Mesh& mesh, Node& node, const gl::RenderState& state)
+{
+    const auto& material = mesh.getMaterial();
+    Expects(material != nullptr);
+
+    const uint64_t program = material->getShaderProgram()->getHandle().getHandle() & 0xffffu;
+    const uint64_t materialId = getMaterialId(material.get());
+    const uint64_t depth = getDepthBits(-node.getModelViewMatrix()[3].z);
+
+    uint64_t key;
+    if(state.isDepthWriteEnabled())
+    {
+        // opaque: group by state, then front to back
+        key = (program << 47u) | (materialId << 31u) | depth;
+    }
+    else
+    {
+        // translucent: back to front, then by state
+        key = (uint64_t{1} << 63u) | ((~depth & 0x7fffffffu) << 32u) | (program << 16u) | materialId;
+    }
+
+    // the draws are reordered, so they can't rely on state left over from a previous draw
+    auto fullState = gl::RenderState::getDefaults();
+    fullState.merge(state);
+    m_packets.emplace_back(Packet{key, &mesh, &node, fullState});
+}
+
+RenderQueue::Changes RenderQueue::countChanges(const std::vector<const Packet*>& packets)
+{
+    Changes changes;
+    const Packet* previous = nullptr;
+    for(const auto* packet : packets)
+    {
+        const auto& material = packet->mesh->getMaterial();
+        if(previous == nullptr || material != previous->mesh->getMaterial())
+            ++changes.materials;
+        if(previous == nullptr
+           || material->getShaderProgram().get() != previous->mesh->getMaterial()->getShaderProgram().get())
+            ++changes.programs;
+        if(previous == nullptr || packet->state != previous->state)
+            ++changes.states;
+        previous = packet;
+    }
+    return changes;
+}
+
+void RenderQueue::submit()
+{
+    m_stats = Stats{};
+    m_sorted.clear();
+    m_sorted.reserve(m_packets.size());
+    for(const auto& packet : m_packets)
+        m_sorted.emplace_back(&packet);
+    m_stats.recorded = countChanges(m_sorted);
+
+    std::stable_sort(
+        m_sorted.begin(), m_sorted.end(), [](const Packet* a, const Packet* b) { return a->key < b->key; });
+    m_stats.sorted = countChanges(m_sorted);
+
+    const ShaderProgram* currentProgram = nullptr;
+    for(const auto* packet : m_sorted)
+    {
+        packet->state.apply();
+
+        const auto program = packet->mesh->getMaterial()->getShaderProgram().get().get();
+        packet->mesh->draw(*packet->node, program != currentProgram);
+        currentProgram = program;
+    }
+    m_stats.draws = m_sorted.size();
+
+    m_packets.clear();
+    m_materialIds.clear();
+}
+} // namespace scene
+} // namespace render
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "render/gl/renderstate.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace render
+{
+namespace scene
+{
+class Material;
+class Mesh;
+class Node;
+
+/**
+ * @brief Collects the draws of a scene traversal, and submits them sorted by their state.
+ *
+ * @details
+ * While a queue is attached to a RenderContext, meshes only record a draw packet instead of drawing immediately.
+ * #submit sorts the packets by a 64 bit key over depth writing, shader program, material and view depth, so that
+ * draws sharing a program and a material are issued back to back, and the program is only bound when it changes.
+ * Draws which don't write depth are issued last, from back to front.
+ *
+ * Per-draw uniforms are still provided by the node's and the mesh's uniform setters, which are evaluated when the
+ * packet is submitted.
+ */
+class RenderQueue final
+{
+public:
+    //! Counts of the changes between consecutive draws.
+    struct Changes
+    {
+        size_t programs = 0;
+        size_t materials = 0;
+        //! Draws whose render state differs from the previous draw's.
+        size_t states = 0;
+    };
+
+    struct Stats
+    {
+        size_t draws = 0;
+        //! The changes of the sorted submission.
+        Changes sorted;
+        //! The changes the draws would have needed when issued in the order they were recorded.
+        Changes recorded;
+    };
+
+    explicit RenderQueue() = default;
+
+    RenderQueue(const RenderQueue&) = delete;
+
+    RenderQueue(RenderQueue&&) = delete;
+
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    RenderQueue& operator=(RenderQueue&&) = delete;
+
+    ~RenderQueue();
+
+    //! Records a draw of @a mesh for @a node, with @a state being the fully merged render state.
+    void add(Mesh& mesh, Node& node, const gl::RenderState& state);
+
+    //! Sorts and issues all recorded draws, and clears the queue.
+    void submit();
+
+    //! Statistics of the last submission.
+    const Stats& getStats() const noexcept
+    {
+        return m_stats;
+    }
+
+private:
+    struct Packet
+    {
+        uint64_t key;
+        Mesh* mesh;
+        Node* node;
+        gl::RenderState state;
+    };
+
+    uint16_t getMaterialId(const Material* material);
+
+    static Changes countChanges(const std::vector<const Packet*>& packets);
+
+    std::vector<Packet> m_packets;
+    std::vector<const Packet*> m_sorted;
+    std::unordered_map<const Material*, uint16_t> m_materialIds;
+    Stats m_stats;
+};
+} // namespace scene
+} // namespace render
@@ -16,7 +16,7 @@ void glErrorCallback(const int err, const char* msg)
 }
 } // namespace
 
-Window::Window(bool fullscreen, const Dimension2<int>& resolution)
+Window::Window(bool fullscreen, const Dimension2<int>& resolution, const bool debugContext)
 {
     glfwSetErrorCallback(&glErrorCallback);
 
@@ -39,9 +39,7 @@ Window::Window(bool fullscreen, const Dimension2<int>& resolution)
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-#ifndef NDEBUG
-    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
-#endif
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, debugContext ? GLFW_TRUE : GLFW_FALSE);
 
     // Create the windows
     m_window = glfwCreateWindow(
@@ -62,7 +60,7 @@ Window::Window(bool fullscreen, const Dimension2<int>& resolution)
 
     glfwMakeContextCurrent(m_window);
 
-    render::gl::initializeGl();
+    render::gl::initializeGl(debugContext);
 
     updateWindowSize();
 
@@ -10,7 +10,9 @@ namespace scene
 class Window final
 {
 public:
-    explicit Window(bool fullscreen = false, const Dimension2<int>& resolution = {1280, 800});
+    explicit Window(bool fullscreen = false,
+                    const Dimension2<int>& resolution = {1280, 800},
+                    bool debugContext = false);
 
     bool isVsync() const;
 
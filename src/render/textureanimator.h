@@ -40,7 +40,7 @@ class TextureAnimator
         };
 
         std::vector<core::TextureTileId> tileIds;
-        std::map<std::shared_ptr<render::gl::StructuredArrayBuffer<glm::vec2>>, std::set<VertexReference>>
+        std::map<std::shared_ptr<render::gl::StructuredArrayBuffer<glm::u16vec2>>, std::set<VertexReference>>
             affectedVertices;
 
         void rotate()
@@ -51,7 +51,7 @@ class TextureAnimator
             tileIds.emplace_back(first);
         }
 
-        void registerVertex(const std::shared_ptr<render::gl::StructuredArrayBuffer<glm::vec2>>& buffer,
+        void registerVertex(const std::shared_ptr<render::gl::StructuredArrayBuffer<glm::u16vec2>>& buffer,
                             VertexReference vertex,
                             const core::TextureTileId tileId)
         {
@@ -67,7 +67,7 @@ class TextureAnimator
 
             for(const auto& partAndVertices : affectedVertices)
             {
-                const std::shared_ptr<render::gl::StructuredArrayBuffer<glm::vec2>>& buffer = partAndVertices.first;
+                const std::shared_ptr<render::gl::StructuredArrayBuffer<glm::u16vec2>>& buffer = partAndVertices.first;
                 auto* uvArray = buffer->map(::gl::BufferAccessARB::ReadWrite);
 
                 const std::set<VertexReference>& vertices = partAndVertices.second;
@@ -78,7 +78,7 @@ class TextureAnimator
                     BOOST_ASSERT(vref.queueOffset < tileIds.size());
                     const loader::file::TextureTile& tile = tiles[tileIds[vref.queueOffset].get()];
 
-                    uvArray[vref.bufferIndex] = tile.uvCoordinates[vref.sourceIndex].toGl();
+                    uvArray[vref.bufferIndex] = tile.uvCoordinates[vref.sourceIndex].toPackedGl();
                 }
 
                 buffer->unmap();
@@ -95,8 +95,13 @@ public:
                              std::vector<loader::file::DWordTexture>& textures,
                              bool linear);
 
+    bool isAnimated(const core::TextureTileId tileId) const
+    {
+        return m_sequenceByTileId.find(tileId) != m_sequenceByTileId.end();
+    }
+
     void registerVertex(const core::TextureTileId tileId,
-                        const std::shared_ptr<render::gl::StructuredArrayBuffer<glm::vec2>>& buffer,
+                        const std::shared_ptr<render::gl::StructuredArrayBuffer<glm::u16vec2>>& buffer,
                         const int sourceIndex,
                         const size_t bufferIndex)
     {
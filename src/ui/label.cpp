@@ -18,17 +18,17 @@ const std::array<const uint8_t, 98> charToSprite{
     17, 18, 19, 20, 21, 22, 23, 24, 25, 80, 76, 81, 97, 98, 77, 26, 27,  28,  29,  30, 31, 32, 33, 34, 35,
     36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 100, 101, 102, 67, 0,  0,  0};
 
-void drawLine(render::gl::Image<render::gl::SRGBA8>& img,
+void drawLine(render::scene::QuadBatch& batch,
               const int x0,
               const int y0,
               const int width,
               const int height,
               const loader::file::ByteColor& color)
 {
-    img.line(x0, y0, x0 + width, y0 + height, color.toTextureColor());
+    batch.line(x0, y0, x0 + width, y0 + height, color.toTextureColor());
 }
 
-void drawOutline(render::gl::Image<render::gl::SRGBA8>& img,
+void drawOutline(render::scene::QuadBatch& batch,
                  const int x,
                  const int y,
                  const int width,
@@ -36,17 +36,17 @@ void drawOutline(render::gl::Image<render::gl::SRGBA8>& img,
                  const loader::file::Palette& palette)
 {
     // top
-    drawLine(img, x, y - 1, width + 1, 0, palette.colors[15]);
-    drawLine(img, x, y, width, 0, palette.colors[31]);
+    drawLine(batch, x, y - 1, width + 1, 0, palette.colors[15]);
+    drawLine(batch, x, y, width, 0, palette.colors[31]);
     //right
-    drawLine(img, x + width, y - 1, 0, height + 1, palette.colors[15]);
-    drawLine(img, x + width + 1, y - 1, 0, height + 2, palette.colors[31]);
+    drawLine(batch, x + width, y - 1, 0, height + 1, palette.colors[15]);
+    drawLine(batch, x + width + 1, y - 1, 0, height + 2, palette.colors[31]);
     // bottom
-    drawLine(img, x + width, y + height, -width, 0, palette.colors[15]);
-    drawLine(img, x + width, y + height + 1, -width - 1, 0, palette.colors[31]);
+    drawLine(batch, x + width, y + height, -width, 0, palette.colors[15]);
+    drawLine(batch, x + width, y + height + 1, -width - 1, 0, palette.colors[31]);
     // left
-    drawLine(img, x - 1, y + height, 0, -height - 1, palette.colors[15]);
-    drawLine(img, x, y + height, 0, -height, palette.colors[31]);
+    drawLine(batch, x - 1, y + height, 0, -height - 1, palette.colors[15]);
+    drawLine(batch, x, y + height, 0, -height, palette.colors[31]);
 }
 } // namespace
 
@@ -83,8 +83,8 @@ int Label::calcWidth() const
     return width;
 }
 
-void Label::draw(CachedFont& font,
-                 render::gl::Image<render::gl::SRGBA8>& img,
+void Label::draw(const CachedFont& font,
+                 render::scene::QuadBatch& batch,
                  const loader::file::Palette& palette) const
 {
     Expects(font.getScaleX() == scaleX);
@@ -109,20 +109,20 @@ void Label::draw(CachedFont& font,
 
     if(alignX == Alignment::Center)
     {
-        x += (img.getWidth() - textWidth) / 2;
+        x += (batch.getWidth() - textWidth) / 2;
     }
     else if(alignX == Alignment::Right)
     {
-        x += img.getWidth() - textWidth;
+        x += batch.getWidth() - textWidth;
     }
 
     if(alignY == Alignment::Center)
     {
-        y += img.getHeight() / 2;
+        y += batch.getHeight() / 2;
     }
     else if(alignY == Alignment::Bottom)
     {
-        y += img.getHeight();
+        y += batch.getHeight();
     }
 
     auto bgndX = bgndOffX + x - 2;
@@ -154,8 +154,7 @@ void Label::draw(CachedFont& font,
 
     if(fillBackground)
     {
-        for(int dy = 0; dy < bgndHeight; ++dy)
-            img.line(bgndX, bgndY + dy, bgndX + bgndWidth - 1, bgndY + dy, {0, 0, 0, 192}, true);
+        batch.fill(bgndX, bgndY, bgndWidth, bgndHeight, {0, 0, 0, 192});
     }
 
     for(uint8_t chr : text)
@@ -177,7 +176,7 @@ void Label::draw(CachedFont& font,
         else
             chr = charToSprite[chr - ' '];
 
-        font.draw(chr, x, y, img);
+        font.draw(chr, x, y, batch);
 
         if(origChar == '(' || origChar == ')' || origChar == '$' || origChar == '~')
             continue;
@@ -187,7 +186,7 @@ void Label::draw(CachedFont& font,
 
     if(outline)
     {
-        drawOutline(img, bgndX, bgndY, bgndWidth, bgndHeight, palette);
+        drawOutline(batch, bgndX, bgndY, bgndWidth, bgndHeight, palette);
     }
 }
 } // namespace ui
@@ -1,5 +1,6 @@
 #include "loader/file/color.h"
 #include "loader/file/datatypes.h"
+#include "render/scene/quadbatch.h"
 #include "util/cimgwrapper.h"
 
 #include <cstdint>
@@ -20,13 +21,18 @@ namespace
 constexpr const int FontBaseScale = 0x10000;
 }
 
+/**
+ * @brief The glyphs of a sprite font, packed into the atlas of a render::scene::QuadBatch.
+ */
 class CachedFont
 {
-    std::vector<util::CImgWrapper> m_images;
+    gsl::not_null<render::scene::QuadBatch*> m_batch;
+    std::vector<render::scene::QuadBatch::TileId> m_tiles;
     const int m_scaleX;
     const int m_scaleY;
 
-    static util::CImgWrapper extractChar(const loader::file::Sprite& sprite, const int scaleX, const int scaleY)
+    static render::gl::Image<render::gl::SRGBA8>
+        extractChar(const loader::file::Sprite& sprite, const int scaleX, const int scaleY)
     {
         BOOST_ASSERT(sprite.image != nullptr);
 
@@ -43,38 +49,37 @@ class CachedFont
                  gsl::narrow_cast<int>(sprite.t1.y * sprite.image->getHeight() - 1));
         src.resize(dstW, dstH);
 
-        return src;
+        render::gl::Image<render::gl::SRGBA8> result{src.width(), src.height()};
+        for(int dy = 0; dy < src.height(); ++dy)
+        {
+            for(int dx = 0; dx < src.width(); ++dx)
+            {
+                result.set(dx, dy, src(dx, dy));
+            }
+        }
+
+        return result;
     }
 
 public:
     explicit CachedFont(const loader::file::SpriteSequence& sequence,
+                        render::scene::QuadBatch& batch,
                         const int scaleX = FontBaseScale,
                         const int scaleY = FontBaseScale)
-        : m_scaleX{scaleX}
+        : m_batch{&batch}
+        , m_scaleX{scaleX}
         , m_scaleY{scaleY}
     {
         for(const auto& spr : sequence.sprites)
         {
-            m_images.emplace_back(extractChar(spr, scaleX, scaleY));
+            m_tiles.emplace_back(batch.addImage(extractChar(spr, scaleX, scaleY)));
         }
     }
 
-    const util::CImgWrapper& get(size_t n) const
+    void draw(size_t n, const int x, const int y, render::scene::QuadBatch& batch) const
     {
-        return m_images.at(n);
-    }
-
-    void draw(size_t n, const int x, const int y, render::gl::Image<render::gl::SRGBA8>& img)
-    {
-        auto& src = m_images.at(n);
-
-        for(int dy = 0; dy < src.height(); ++dy)
-        {
-            for(int dx = 0; dx < src.width(); ++dx)
-            {
-                img.set(x + dx, y + dy, src(dx, dy), true);
-            }
-        }
+        Expects(&batch == m_batch.get());
+        batch.draw(m_tiles.at(n), x, y);
     }
 
     int getScaleX() const noexcept
@@ -126,7 +131,7 @@ struct Label
     {
     }
 
-    void draw(CachedFont& font, render::gl::Image<render::gl::SRGBA8>& img, const loader::file::Palette& palette) const;
+    void draw(const CachedFont& font, render::scene::QuadBatch& batch, const loader::file::Palette& palette) const;
 
     int calcWidth() const;
 
@@ -0,0 +1,216 @@
+#include "jobsystem.h"
+
+#include "gsl-lite.hpp"
+
+#include <utility>
+
+namespace util
+{
+namespace
+{
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local size_t currentQueueIndex = 0;
+} // namespace
+
+TaskGraph::TaskId TaskGraph::add(std::function<void()> fn, const std::initializer_list<TaskId> dependencies)
+{
+    const auto id = m_tasks.size();
+    for(const auto dependency : dependencies)
+    {
+        Expects(dependency < id);
+        m_tasks[dependency].successors.emplace_back(id);
+    }
+
+    m_tasks.emplace_back(Task{std::move(fn), {}, dependencies.size()});
+    return id;
+}
+
+JobSystem::JobSystem(const size_t threadCount)
+{
+    Expects(threadCount > 0);
+
+    m_queues.reserve(threadCount);
+    for(size_t i = 0; i < threadCount; ++i)
+        m_queues.emplace_back(std::make_unique<Queue>());
+
+    m_workers.reserve(threadCount - 1);
+    for(size_t i = 1; i < threadCount; ++i)
+        m_workers.emplace_back(&JobSystem::workerMain, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_sleepMutex};
+        m_shutdown = true;
+    }
+    m_jobsAvailable.notify_all();
+
+    for(auto& worker : m_workers)
+        worker.join();
+}
+
+void JobSystem::submit(WaitGroup& group, std::function<void()> job)
+{
+    ++group.m_pending;
+
+    {
+        // taking the lock ensures that a worker about to sleep sees the new job; the counter is incremented before
+        // the job is queued so that taking the job can never make it drop below zero
+        std::lock_guard<std::mutex> lock{m_sleepMutex};
+        ++m_queuedJobs;
+    }
+
+    auto& queue = *m_queues[getQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.jobs.emplace_back(Job{std::move(job), &group});
+    }
+    m_jobsAvailable.notify_one();
+}
+
+void JobSystem::wait(WaitGroup& group)
+{
+    const auto queueIndex = getQueueIndex();
+    while(group.m_pending.load() != 0)
+    {
+        Job job;
+        if(tryTakeJob(queueIndex, job))
+            execute(job);
+        else
+            std::this_thread::yield();
+    }
+
+    if(group.m_failed.load())
+    {
+        std::lock_guard<std::mutex> lock{group.m_exceptionMutex};
+        group.m_failed = false;
+        std::rethrow_exception(std::exchange(group.m_exception, nullptr));
+    }
+}
+
+void JobSystem::parallelFor(const size_t count, const std::function<void(size_t)>& fn, const size_t grainSize)
+{
+    Expects(grainSize > 0);
+
+    WaitGroup group;
+    for(size_t begin = 0; begin < count; begin += grainSize)
+    {
+        const auto end = std::min(begin + grainSize, count);
+        submit(group, [&fn, &group, begin, end]() {
+            // skip the remaining indices after a failure
+            if(group.m_failed.load())
+                return;
+
+            for(auto i = begin; i < end; ++i)
+                fn(i);
+        });
+    }
+    wait(group);
+}
+
+void JobSystem::run(const TaskGraph& graph)
+{
+    const auto& tasks = graph.m_tasks;
+    std::vector<std::atomic<size_t>> remainingDependencies(tasks.size());
+    for(size_t i = 0; i < tasks.size(); ++i)
+        remainingDependencies[i] = tasks[i].dependencyCount;
+
+    WaitGroup group;
+    std::function<void(TaskGraph::TaskId)> start = [this, &tasks, &remainingDependencies, &group, &start](
+                                                       const TaskGraph::TaskId id) {
+        submit(group, [&tasks, &remainingDependencies, &group, &start, id]() {
+            // tasks depending on a failed one are skipped, but still released to let the graph finish
+            if(!group.m_failed.load())
+                tasks[id].fn();
+
+            for(const auto successor : tasks[id].successors)
+            {
+                if(--remainingDependencies[successor] == 0)
+                    start(successor);
+            }
+        });
+    };
+
+    for(size_t i = 0; i < tasks.size(); ++i)
+    {
+        if(tasks[i].dependencyCount == 0)
+            start(i);
+    }
+    wait(group);
+}
+
+size_t JobSystem::getQueueIndex() const noexcept
+{
+    return currentSystem == this ? currentQueueIndex : 0;
+}
+
+bool JobSystem::tryTakeJob(const size_t queueIndex, Job& job)
+{
+    {
+        auto& own = *m_queues[queueIndex];
+        std::lock_guard<std::mutex> lock{own.mutex};
+        if(!own.jobs.empty())
+        {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            --m_queuedJobs;
+            return true;
+        }
+    }
+
+    for(size_t i = 1; i < m_queues.size(); ++i)
+    {
+        auto& victim = *m_queues[(queueIndex + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock{victim.mutex};
+        if(!victim.jobs.empty())
+        {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            --m_queuedJobs;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::execute(Job& job)
+{
+    auto& group = *job.group;
+    try
+    {
+        job.fn();
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock{group.m_exceptionMutex};
+        if(!group.m_failed.exchange(true))
+            group.m_exception = std::current_exception();
+    }
+
+    // the group may be destroyed as soon as the last job has finished
+    --group.m_pending;
+}
+
+void JobSystem::workerMain(const size_t queueIndex)
+{
+    currentSystem = this;
+    currentQueueIndex = queueIndex;
+
+    while(true)
+    {
+        Job job;
+        if(tryTakeJob(queueIndex, job))
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{m_sleepMutex};
+        m_jobsAvailable.wait(lock, [this]() { return m_shutdown || m_queuedJobs.load() > 0; });
+        if(m_shutdown)
+            return;
+    }
+}
+} // namespace util
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+class JobSystem;
+
+/**
+ * @brief A set of jobs with dependencies, executed by JobSystem::run.
+ *
+ * @details
+ * Dependencies can only refer to tasks added before, so the graph is acyclic by construction.  A graph can be run
+ * multiple times.
+ */
+class TaskGraph final
+{
+public:
+    using TaskId = size_t;
+
+    //! Adds a task, which is started as soon as all @a dependencies have finished.
+    TaskId add(std::function<void()> fn, std::initializer_list<TaskId> dependencies = {});
+
+    size_t size() const noexcept
+    {
+        return m_tasks.size();
+    }
+
+private:
+    friend class JobSystem;
+
+    struct Task
+    {
+        std::function<void()> fn;
+        std::vector<TaskId> successors;
+        size_t dependencyCount = 0;
+    };
+
+    std::vector<Task> m_tasks;
+};
+
+/**
+ * @brief A fork/join job system with a fixed pool of worker threads.
+ *
+ * @details
+ * Each thread owns a deque of jobs; it pushes and pops its own jobs at the back, while idle threads steal from the
+ * front of other threads' deques.  Threads that are not part of the pool, i.e. usually the main thread, share an
+ * additional deque.  Waiting for jobs never blocks the waiting thread: it executes pending jobs until the awaited
+ * ones have finished, so jobs may submit and wait for further jobs themselves.
+ *
+ * Jobs are executed in an unspecified order on unspecified threads, so callers needing deterministic results must
+ * make their jobs independent of each other.
+ */
+class JobSystem final
+{
+public:
+    //! Tracks the completion of jobs, and the first exception thrown by them.
+    class WaitGroup final
+    {
+    public:
+        WaitGroup() = default;
+
+        WaitGroup(const WaitGroup&) = delete;
+
+        WaitGroup(WaitGroup&&) = delete;
+
+        WaitGroup& operator=(const WaitGroup&) = delete;
+
+        WaitGroup& operator=(WaitGroup&&) = delete;
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<size_t> m_pending{0};
+        std::atomic<bool> m_failed{false};
+        std::mutex m_exceptionMutex;
+        std::exception_ptr m_exception;
+    };
+
+    //! Creates a pool with @a threadCount threads in total, including the thread waiting for jobs.
+    explicit JobSystem(size_t threadCount);
+
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+
+    JobSystem(JobSystem&&) = delete;
+
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    size_t getThreadCount() const noexcept
+    {
+        return m_workers.size() + 1;
+    }
+
+    void submit(WaitGroup& group, std::function<void()> job);
+
+    /**
+     * @brief Executes jobs until all jobs of @a group have finished.
+     *
+     * @details
+     * Rethrows the first exception thrown by a job of @a group.
+     */
+    void wait(WaitGroup& group);
+
+    /**
+     * @brief Calls @a fn for each index in <tt>[0, count)</tt>, and returns when all calls have finished.
+     * @param count The number of indices.
+     * @param fn The function to call.
+     * @param grainSize The number of consecutive indices processed by a single job.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn, size_t grainSize = 1);
+
+    //! Executes all tasks of @a graph, and returns when all of them have finished.
+    void run(const TaskGraph& graph);
+
+private:
+    struct Job
+    {
+        std::function<void()> fn;
+        WaitGroup* group = nullptr;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    //! Index 0 is shared by all threads outside of the pool.
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::atomic<size_t> m_queuedJobs{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_jobsAvailable;
+    bool m_shutdown = false;
+
+    size_t getQueueIndex() const noexcept;
+
+    bool tryTakeJob(size_t queueIndex, Job& job);
+
+    void execute(Job& job);
+
+    void workerMain(size_t queueIndex);
+};
+} // namespace util
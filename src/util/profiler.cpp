@@ -0,0 +1,159 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+namespace util
+{
+std::atomic<bool> Profiler::s_enabled{false};
+
+thread_local uint16_t ProfileZone::s_depth = 0;
+
+namespace
+{
+void writeJsonString(std::ostream& stream, const char* str)
+{
+    stream << '"';
+    for(; *str != '\0'; ++str)
+    {
+        switch(*str)
+        {
+        case '"': stream << "\\\""; break;
+        case '\\': stream << "\\\\"; break;
+        default:
+            if(static_cast<unsigned char>(*str) >= 0x20)
+                stream << *str;
+            break;
+        }
+    }
+    stream << '"';
+}
+} // namespace
+
+Profiler::Profiler()
+{
+    // the thread creating the profiler is considered to be the main thread
+    m_mainBuffer = &getThreadBuffer();
+}
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+    static thread_local ThreadBuffer* buffer = nullptr;
+    if(buffer != nullptr)
+        return *buffer;
+
+    std::lock_guard<std::mutex> lock{m_buffersMutex};
+    m_buffers.emplace_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(m_buffers.size() + 1)));
+    buffer = m_buffers.back().get();
+    return *buffer;
+}
+
+void Profiler::beginFrame()
+{
+    const auto t = now();
+    m_lastFrameStart = std::exchange(m_frameStart, t);
+    m_lastFrameEnd = t;
+}
+
+void Profiler::addZone(const char* name, const uint64_t start, const uint64_t end, const uint16_t depth)
+{
+    getThreadBuffer().push(Event{name, start, end, depth});
+}
+
+void Profiler::addGpuZone(const char* name, const uint64_t start, const uint64_t duration)
+{
+    m_gpuBuffer.push(Event{name, start, start + duration, 0});
+
+    std::lock_guard<std::mutex> lock{m_latestGpuZonesMutex};
+    auto it = std::find_if(m_latestGpuZones.begin(), m_latestGpuZones.end(), [name](const ZoneSummary& summary) {
+        return summary.name == name;
+    });
+    if(it == m_latestGpuZones.end())
+        it = m_latestGpuZones.insert(m_latestGpuZones.end(), ZoneSummary{name, 0, 0, 0});
+
+    it->calls = 1;
+    it->total = duration;
+}
+
+std::vector<Profiler::ZoneSummary> Profiler::getLastFrameSummary() const
+{
+    std::vector<ZoneSummary> result;
+
+    const auto collect = [this, &result](const Event& event) {
+        if(event.start < m_lastFrameStart || event.start >= m_lastFrameEnd)
+            return;
+
+        auto it = std::find_if(result.begin(), result.end(), [&event](const ZoneSummary& summary) {
+            return summary.name == event.name && summary.depth == event.depth;
+        });
+        if(it == result.end())
+            it = result.insert(result.end(), ZoneSummary{event.name, event.depth, 0, 0});
+
+        ++it->calls;
+        it->total += event.end - event.start;
+    };
+
+    m_mainBuffer->forEach(collect);
+
+    // GPU zones are read back a few frames late, so they would rarely start within the last frame
+    std::lock_guard<std::mutex> lock{m_latestGpuZonesMutex};
+    result.insert(result.end(), m_latestGpuZones.begin(), m_latestGpuZones.end());
+
+    return result;
+}
+
+void Profiler::writeChromeTrace(std::ostream& stream) const
+{
+    bool first = true;
+    const auto writeEvent = [&stream, &first](const Event& event, const uint32_t threadId, const char* category) {
+        if(!std::exchange(first, false))
+            stream << ",\n";
+
+        stream << "{\"name\":";
+        writeJsonString(stream, event.name);
+        stream << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId
+               << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+    };
+
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"traceEvents\":[\n";
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << GpuThreadId
+           << ",\"args\":{\"name\":\"GPU\"}}";
+    first = false;
+
+    {
+        std::lock_guard<std::mutex> lock{m_buffersMutex};
+        for(const auto& buffer : m_buffers)
+        {
+            const auto threadId = buffer->threadId;
+            buffer->forEach([&writeEvent, threadId](const Event& event) { writeEvent(event, threadId, "cpu"); });
+        }
+    }
+
+    m_gpuBuffer.forEach([&writeEvent](const Event& event) { writeEvent(event, GpuThreadId, "gpu"); });
+
+    stream << "\n],\n\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void Profiler::writeChromeTrace(const std::string& filename) const
+{
+    std::ofstream file{filename, std::ios::out | std::ios::trunc};
+    if(!file.is_open())
+    {
+        BOOST_LOG_TRIVIAL(error) << "Failed to open profiler trace file " << filename;
+        return;
+    }
+
+    writeChromeTrace(file);
+    BOOST_LOG_TRIVIAL(info) << "Wrote profiler trace to " << filename;
+}
+} // namespace util
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace util
+{
+/**
+ * @brief A lightweight, thread-aware hierarchical zone profiler.
+ *
+ * @details
+ * Each thread records completed zones into its own fixed-size ring buffer, so recording
+ * never allocates and only contends with an ongoing trace export.  Zone names must be string literals
+ * (or otherwise outlive the profiler), as only the pointers are stored.
+ *
+ * GPU timings can be recorded on a separate track through #addGpuZone.  As GPU results arrive a few frames after
+ * the work was issued, the summary reports the most recent duration of each GPU zone instead.
+ */
+class Profiler final
+{
+public:
+    using Clock = std::chrono::high_resolution_clock;
+
+    struct Event
+    {
+        const char* name = nullptr;
+        uint64_t start = 0; //!< Nanoseconds since profiler construction.
+        uint64_t end = 0;
+        uint16_t depth = 0;
+    };
+
+    struct ZoneSummary
+    {
+        const char* name = nullptr;
+        uint16_t depth = 0;
+        uint32_t calls = 0;
+        uint64_t total = 0; //!< Nanoseconds.
+    };
+
+    static constexpr size_t EventsPerThread = 1u << 16u;
+    //! Thread id used for GPU events.
+    static constexpr uint32_t GpuThreadId = 0;
+
+    static Profiler& instance();
+
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool enabled)
+    {
+        s_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    uint64_t now() const
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_epoch).count());
+    }
+
+    //! Marks the start of a new frame; the summary covers the zones of the previous frame.
+    void beginFrame();
+
+    void addZone(const char* name, uint64_t start, uint64_t end, uint16_t depth);
+
+    //! Records a GPU zone issued at @a start; the zone may be added during a later frame.
+    void addGpuZone(const char* name, uint64_t start, uint64_t duration);
+
+    /**
+     * @brief Aggregated zones of the main thread within the last completed frame, in first-seen order.
+     *
+     * @details
+     * The zones are followed by the most recent duration of each GPU zone.
+     */
+    std::vector<ZoneSummary> getLastFrameSummary() const;
+
+    uint64_t getLastFrameDuration() const
+    {
+        return m_lastFrameEnd - m_lastFrameStart;
+    }
+
+    //! Writes all buffered events in the Chrome trace event format (chrome://tracing, Perfetto).
+    void writeChromeTrace(std::ostream& stream) const;
+
+    void writeChromeTrace(const std::string& filename) const;
+
+private:
+    struct ThreadBuffer
+    {
+        explicit ThreadBuffer(uint32_t threadId)
+            : threadId{threadId}
+            , events(EventsPerThread)
+        {
+        }
+
+        const uint32_t threadId;
+        mutable std::mutex mutex;
+        std::vector<Event> events;
+        size_t next = 0;
+        size_t count = 0;
+
+        void push(const Event& event)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            events[next] = event;
+            next = (next + 1) % events.size();
+            count = std::min(count + 1, events.size());
+        }
+
+        template<typename F>
+        void forEach(const F& f) const
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            const auto first = (next + events.size() - count) % events.size();
+            for(size_t i = 0; i < count; ++i)
+                f(events[(first + i) % events.size()]);
+        }
+    };
+
+    Profiler();
+
+    ThreadBuffer& getThreadBuffer();
+
+    static std::atomic<bool> s_enabled;
+
+    const Clock::time_point m_epoch = Clock::now();
+    mutable std::mutex m_buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    ThreadBuffer* m_mainBuffer = nullptr;
+    ThreadBuffer m_gpuBuffer{GpuThreadId};
+    mutable std::mutex m_latestGpuZonesMutex;
+    std::vector<ZoneSummary> m_latestGpuZones;
+    uint64_t m_frameStart = 0;
+    uint64_t m_lastFrameStart = 0;
+    uint64_t m_lastFrameEnd = 0;
+};
+
+/**
+ * @brief Records the lifetime of this object as a named zone of the current thread.
+ */
+class ProfileZone final
+{
+public:
+    explicit ProfileZone(const char* name)
+        : m_name{name}
+    {
+        if(!Profiler::isEnabled())
+            return;
+
+        m_active = true;
+        m_depth = s_depth++;
+        m_start = Profiler::instance().now();
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+
+    ProfileZone(ProfileZone&&) = delete;
+
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+    ProfileZone& operator=(ProfileZone&&) = delete;
+
+    ~ProfileZone()
+    {
+        if(!m_active)
+            return;
+
+        --s_depth;
+        auto& profiler = Profiler::instance();
+        profiler.addZone(m_name, m_start, profiler.now(), m_depth);
+    }
+
+private:
+    const char* const m_name;
+    bool m_active = false;
+    uint64_t m_start = 0;
+    uint16_t m_depth = 0;
+
+    static thread_local uint16_t s_depth;
+};
+} // namespace util
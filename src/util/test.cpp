@@ -0,0 +1,231 @@
+#define BOOST_TEST_MODULE util_test
+
+#include "gsl-lite.hpp"
+#include "jobsystem.h"
+#include "profiler.h"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+gsl_api void gsl::fail_fast_assert_handler(char const* const /*expression*/,
+                                           char const* const message,
+                                           char const* const /*file*/,
+                                           int /*line*/)
+{
+    throw gsl::fail_fast(message);
+}
+
+using namespace util;
+
+BOOST_AUTO_TEST_SUITE(jobsystem_tests)
+
+BOOST_AUTO_TEST_CASE(test_parallel_for_visits_each_index_once)
+{
+    for(const size_t threads : {1u, 2u, 4u})
+    {
+        JobSystem jobSystem{threads};
+        BOOST_CHECK_EQUAL(jobSystem.getThreadCount(), threads);
+
+        for(const size_t grainSize : {1u, 3u, 64u})
+        {
+            std::vector<std::atomic<int>> visits(1000);
+            for(auto& visit : visits)
+                visit = 0;
+
+            jobSystem.parallelFor(
+                visits.size(), [&visits](const size_t i) { ++visits[i]; }, grainSize);
+
+            for(const auto& visit : visits)
+                BOOST_REQUIRE_EQUAL(visit.load(), 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_for_empty_range)
+{
+    JobSystem jobSystem{2};
+    bool called = false;
+    jobSystem.parallelFor(0, [&called](size_t) { called = true; });
+    BOOST_CHECK(!called);
+}
+
+BOOST_AUTO_TEST_CASE(test_nested_parallel_for)
+{
+    JobSystem jobSystem{4};
+    std::atomic<size_t> sum{0};
+    jobSystem.parallelFor(16, [&jobSystem, &sum](const size_t i) {
+        jobSystem.parallelFor(16, [&sum, i](const size_t j) { sum += i * 16 + j; });
+    });
+    BOOST_CHECK_EQUAL(sum.load(), 256u * 255u / 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_wait_group)
+{
+    JobSystem jobSystem{3};
+    JobSystem::WaitGroup group;
+    std::atomic<int> done{0};
+    for(int i = 0; i < 100; ++i)
+        jobSystem.submit(group, [&done]() { ++done; });
+    jobSystem.wait(group);
+    BOOST_CHECK_EQUAL(done.load(), 100);
+
+    // a group can be reused after waiting for it
+    jobSystem.submit(group, [&done]() { ++done; });
+    jobSystem.wait(group);
+    BOOST_CHECK_EQUAL(done.load(), 101);
+}
+
+BOOST_AUTO_TEST_CASE(test_exception_is_rethrown)
+{
+    JobSystem jobSystem{4};
+    BOOST_CHECK_THROW(jobSystem.parallelFor(100,
+                                            [](const size_t i) {
+                                                if(i == 42)
+                                                    throw std::runtime_error("failed");
+                                            }),
+                      std::runtime_error);
+
+    // the system stays usable after a failure
+    std::atomic<int> done{0};
+    jobSystem.parallelFor(10, [&done](size_t) { ++done; });
+    BOOST_CHECK_EQUAL(done.load(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_task_graph_order)
+{
+    JobSystem jobSystem{4};
+
+    // a diamond followed by a chain: a -> {b, c} -> d -> e
+    std::atomic<int> clock{0};
+    std::vector<int> finished(5, -1);
+    TaskGraph graph;
+    const auto task = [&clock, &finished](const size_t index) {
+        return [&clock, &finished, index]() { finished[index] = clock++; };
+    };
+    const auto a = graph.add(task(0));
+    const auto b = graph.add(task(1), {a});
+    const auto c = graph.add(task(2), {a});
+    const auto d = graph.add(task(3), {b, c});
+    graph.add(task(4), {d});
+    BOOST_CHECK_EQUAL(graph.size(), 5u);
+
+    for(int run = 0; run < 10; ++run)
+    {
+        clock = 0;
+        jobSystem.run(graph);
+        BOOST_CHECK_EQUAL(finished[0], 0);
+        BOOST_CHECK_LT(finished[0], finished[1]);
+        BOOST_CHECK_LT(finished[0], finished[2]);
+        BOOST_CHECK_LT(finished[1], finished[3]);
+        BOOST_CHECK_LT(finished[2], finished[3]);
+        BOOST_CHECK_EQUAL(finished[4], 4);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_task_graph_skips_dependents_of_failed_task)
+{
+    JobSystem jobSystem{2};
+    bool dependentRan = false;
+    TaskGraph graph;
+    const auto failing = graph.add([]() { throw std::runtime_error("failed"); });
+    graph.add([&dependentRan]() { dependentRan = true; }, {failing});
+    graph.add([]() {});
+
+    BOOST_CHECK_THROW(jobSystem.run(graph), std::runtime_error);
+    BOOST_CHECK(!dependentRan);
+}
+
+BOOST_AUTO_TEST_CASE(test_throughput)
+{
+    // no timing is asserted as it depends on the machine; the numbers are only reported
+    static constexpr size_t JobCount = 100000;
+
+    for(const size_t threads : {1u, 4u})
+    {
+        JobSystem jobSystem{threads};
+        for(const size_t grainSize : {1u, 256u})
+        {
+            std::atomic<size_t> sum{0};
+
+            const auto start = std::chrono::high_resolution_clock::now();
+            jobSystem.parallelFor(
+                JobCount, [&sum](const size_t i) { sum += i; }, grainSize);
+            const auto duration = std::chrono::high_resolution_clock::now() - start;
+
+            BOOST_CHECK_EQUAL(sum.load(), JobCount * (JobCount - 1) / 2);
+            BOOST_TEST_MESSAGE(JobCount << " indices on " << threads << " threads with grain size " << grainSize
+                                        << " took "
+                                        << std::chrono::duration_cast<std::chrono::microseconds>(duration).count()
+                                        << "us");
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(profiler_tests)
+
+namespace
+{
+const Profiler::ZoneSummary* findZone(const std::vector<Profiler::ZoneSummary>& summary, const std::string& name)
+{
+    const auto it = std::find_if(
+        summary.begin(), summary.end(), [&name](const Profiler::ZoneSummary& zone) { return zone.name == name; });
+    return it == summary.end() ? nullptr : &*it;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_late_gpu_zone_is_summarized)
+{
+    Profiler::setEnabled(true);
+    auto& profiler = Profiler::instance();
+
+    // the GPU work is issued during one frame, and its result is read back a few frames later
+    profiler.beginFrame();
+    const auto issuedAt = profiler.now();
+    profiler.beginFrame();
+    profiler.beginFrame();
+    {
+        ProfileZone zone{"test-cpu-zone"};
+        profiler.addGpuZone("test-gpu-zone", issuedAt, 1234);
+    }
+    profiler.beginFrame();
+
+    auto summary = profiler.getLastFrameSummary();
+    BOOST_CHECK(findZone(summary, "test-cpu-zone") != nullptr);
+    auto gpuZone = findZone(summary, "test-gpu-zone");
+    BOOST_REQUIRE(gpuZone != nullptr);
+    BOOST_CHECK_EQUAL(gpuZone->total, 1234u);
+    BOOST_CHECK_EQUAL(gpuZone->calls, 1u);
+
+    // CPU zones are only reported for their own frame, while the latest GPU result is kept until replaced
+    profiler.beginFrame();
+    summary = profiler.getLastFrameSummary();
+    BOOST_CHECK(findZone(summary, "test-cpu-zone") == nullptr);
+    gpuZone = findZone(summary, "test-gpu-zone");
+    BOOST_REQUIRE(gpuZone != nullptr);
+    BOOST_CHECK_EQUAL(gpuZone->total, 1234u);
+
+    profiler.addGpuZone("test-gpu-zone", profiler.now(), 42);
+    profiler.beginFrame();
+    summary = profiler.getLastFrameSummary();
+    BOOST_CHECK_EQUAL(std::count_if(summary.begin(),
+                                    summary.end(),
+                                    [](const Profiler::ZoneSummary& zone) {
+                                        return std::string{zone.name} == "test-gpu-zone";
+                                    }),
+                      1);
+    gpuZone = findZone(summary, "test-gpu-zone");
+    BOOST_REQUIRE(gpuZone != nullptr);
+    BOOST_CHECK_EQUAL(gpuZone->total, 42u);
+
+    Profiler::setEnabled(false);
+}
+
+BOOST_AUTO_TEST_SUITE_END()